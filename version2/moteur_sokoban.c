@@ -0,0 +1,1966 @@
+/**
+* @file moteur_sokoban.c
+* @brief Moteur du Sokoban : règles du jeu, niveaux et historique
+* @author Evan BENOIT
+* @version 2.0
+* @date 30/11/2025
+*
+* Voir moteur_sokoban.h pour l'interface et la compilation.
+*
+*/
+
+/* stat.st_mtim et clock_gettime sont POSIX, même avec -std=c11 */
+#define _POSIX_C_SOURCE 200809L
+
+/* Fichiers inclus */
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "moteur_sokoban.h"
+
+/* Déclaration des constantes propres au moteur (invisibles hors du fichier) */
+static const size_t ALIGNEMENT_COUCHES=64;
+static const int DEPLACEMENTS_PAR_OCTET=4;
+static const int BITS_PAR_DIRECTION=2;
+static const int MASQUE_DIRECTION=3;
+static const int PROFONDEUR_GEL_MAX=64;
+static const long long NANOSECONDES_PAR_MICROSECONDE=1000;
+static const char SOL_XSB='-';
+static const char SOL_XSB_SOULIGNE='_';
+static const char CARACTERES_PLATEAU[]="#@+$*. -_";
+static const char SUFFIXE_INDEX[]=".idx";
+static const char MAGIQUE_INDEX[]="SOKIDX1";
+static const int AVANCE=1;
+static const int POUSSE=2;
+
+/* Messages des comptes rendus, dans l'ordre de t_Erreur */
+static const char * const MESSAGES_ERREUR[] = {"", "ERREUR MEMOIRE",
+    "ERREUR SUR FICHIER", "ERREUR TAILLE DU PLATEAU", "ERREUR SOKOBAN ABSENT",
+    "ERREUR NIVEAU ABSENT DU RECUEIL", "ERREUR COMPTEUR DE CAISSES"};
+
+/*
+* Code des touches (HAUT, BAS, GAUCHE, DROITE) et des lettres de l'historique :
+* direction + 1, plus NB_DIRECTIONS pour une poussée, 0 pour les autres
+* caractères
+*/
+static const uint8_t CODES_TOUCHES[UINT8_MAX + 1] = {
+    ['z'] = 1, ['s'] = 2, ['q'] = 3, ['d'] = 4
+};
+static const uint8_t CODES_LETTRES[UINT8_MAX + 1] = {
+    ['h'] = 1, ['b'] = 2, ['g'] = 3, ['d'] = 4,
+    ['H'] = 5, ['B'] = 6, ['G'] = 7, ['D'] = 8
+};
+
+/*
+* Effet d'un déplacement (AVANCE, POUSSE) selon la case suivante et celle
+* d'après, à l'indice caisse * 4 + mur * 2 + case d'après occupée
+*/
+static const uint8_t EFFETS_DEPLACEMENT[8] = {
+    1, 1,       // Case libre : Sokoban avance
+    0, 0,       // Mur
+    3, 0,       // Caisse : poussée si la case d'après est libre
+    0, 0        // Caisse dans un mur : impossible
+};
+
+/* En-tête du fichier d'index, suivi des positions des niveaux */
+typedef struct {
+    char magique[8];
+    uint64_t tailleRecueil;    // Le recueil doit être resté identique
+    int64_t dateRecueil;       // En nanosecondes
+    uint64_t nbNiveaux;
+} t_EnteteIndex;
+
+#ifdef COMPTER_ALLOCATIONS
+// Appels à reallouer et couches_allouer, lus par les bancs d'essai
+static atomic_llong nbAllocations;
+#endif
+
+uint64_t * couches_allouer(int nbMots, int nbCouches){
+    size_t taille = (size_t)nbMots * nbCouches * sizeof(uint64_t);
+    uint64_t * couches = aligned_alloc(ALIGNEMENT_COUCHES, taille);
+#ifdef COMPTER_ALLOCATIONS
+    atomic_fetch_add_explicit(&nbAllocations, 1, memory_order_relaxed);
+#endif
+    if (couches != NULL) {
+        memset(couches, 0, taille);
+    }
+    return couches;
+}
+
+t_Erreur plateau_allouer(t_Plateau * plateau, int nbLignes, int nbColonnes){
+    char * cases;
+
+    if (plateau->cases == NULL || plateau->nbLignes != nbLignes
+        || plateau->nbColonnes != nbColonnes) {
+        cases = reallouer(plateau->cases, (size_t)nbLignes * nbColonnes);
+        if (cases == NULL) {
+            return MOTEUR_ERREUR_MEMOIRE;
+        }
+        plateau->cases = cases;
+        plateau->nbLignes = nbLignes;
+        plateau->nbColonnes = nbColonnes;
+    }
+    return MOTEUR_OK;
+}
+
+void plateau_liberer(t_Plateau * plateau){
+    free(plateau->cases);
+    plateau->cases = NULL;
+    plateau->nbLignes = ZERO;
+    plateau->nbColonnes = ZERO;
+}
+
+/**
+ * @brief Mélange un entier sur 64 bits (splitmix64) : donne les clés de
+ * Zobrist, qui ne dépendent que de l'indice de la case
+ * @param x Entier à mélanger
+ * @return Valeur pseudo-aléatoire
+ */
+static uint64_t melanger(uint64_t x){
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+t_Erreur etat_depuis_plateau(const t_Plateau * plateau, t_Niveau * niveau,
+    t_Etat * etat){
+
+    const int MOTS_PAR_ALIGNEMENT = ALIGNEMENT_COUCHES / sizeof(uint64_t);
+    char c;
+    int numCase;
+
+    memset(niveau, 0, sizeof(*niveau));
+    memset(etat, 0, sizeof(*etat));
+    niveau->nbLignes = plateau->nbLignes;
+    niveau->nbColonnes = plateau->nbColonnes;
+    niveau->largeur = plateau->nbColonnes + DOUBLE * BORDURE;
+    niveau->hauteur = plateau->nbLignes + DOUBLE * BORDURE;
+    niveau->nbCases = niveau->largeur * niveau->hauteur;
+    niveau->nbMots = (niveau->nbCases + BITS_PAR_MOT - 1) / BITS_PAR_MOT;
+    niveau->nbMots = (niveau->nbMots + MOTS_PAR_ALIGNEMENT - 1)
+        / MOTS_PAR_ALIGNEMENT * MOTS_PAR_ALIGNEMENT;
+    niveau->decalages[0] = -niveau->largeur;
+    niveau->decalages[1] = niveau->largeur;
+    niveau->decalages[2] = -1;
+    niveau->decalages[3] = 1;
+    niveau->murs = couches_allouer(niveau->nbMots, 6);
+    etat->caisses = couches_allouer(niveau->nbMots, 1);
+    niveau->zobrist = reallouer(NULL,
+        (size_t)DOUBLE * niveau->nbCases * sizeof(uint64_t));
+    if (niveau->murs == NULL || etat->caisses == NULL
+        || niveau->zobrist == NULL) {
+        niveau_liberer(niveau);
+        etat_liberer(etat);
+        return MOTEUR_ERREUR_MEMOIRE;
+    }
+    niveau->cibles = niveau->murs + niveau->nbMots;
+    niveau->casesMortes = niveau->cibles + niveau->nbMots;
+    niveau->tunnels = niveau->casesMortes + niveau->nbMots;
+    niveau->salle = niveau->tunnels + DOUBLE * niveau->nbMots;
+    niveau->zobristSok = niveau->zobrist + niveau->nbCases;
+    for (numCase = ZERO ; numCase < niveau->nbCases ; numCase++) {
+        niveau->zobrist[numCase] = melanger((uint64_t)numCase * DOUBLE);
+        niveau->zobristSok[numCase] = melanger((uint64_t)numCase * DOUBLE + 1);
+    }
+
+    // La bordure est faite de murs
+    for (numCase = ZERO ; numCase < niveau->nbCases ; numCase++) {
+        if (numCase < niveau->largeur
+            || numCase >= niveau->nbCases - niveau->largeur
+            || numCase % niveau->largeur == ZERO
+            || numCase % niveau->largeur == niveau->largeur - 1) {
+            bit_inverser(niveau->murs, numCase);
+        }
+    }
+    for (int i = ZERO ; i < plateau->nbLignes ; i++) {
+        for (int j = ZERO ; j < plateau->nbColonnes ; j++) {
+            c = plateau->cases[i * plateau->nbColonnes + j];
+            numCase = (i + BORDURE) * niveau->largeur + j + BORDURE;
+            if (c == MUR) {
+                bit_inverser(niveau->murs, numCase);
+            }
+            if (c == CIBLE || c == SOKOBAN_CIBLE || c == CAISSE_CIBLE) {
+                bit_inverser(niveau->cibles, numCase);
+            }
+            if (c == CAISSE || c == CAISSE_CIBLE) {
+                bit_inverser(etat->caisses, numCase);
+                etat->empreinte ^= niveau->zobrist[numCase];
+            }
+            if (c == CAISSE) {
+                etat->nbCaissesHorsCible++;
+            }
+        }
+    }
+    // Sokoban a été trouvé à la lecture du plateau
+    etat->caseSok = (plateau->ligneSok + BORDURE) * niveau->largeur
+        + plateau->colonneSok + BORDURE;
+    if (calculer_cases_mortes(niveau) != MOTEUR_OK
+        || calculer_macros(niveau, etat) != MOTEUR_OK) {
+        niveau_liberer(niveau);
+        etat_liberer(etat);
+        return MOTEUR_ERREUR_MEMOIRE;
+    }
+    etat->blocage = etat_bloque(niveau, etat);
+    return MOTEUR_OK;
+}
+
+t_Erreur etat_vers_plateau(const t_Niveau * niveau, const t_Etat * etat,
+    t_Plateau * plateau){
+
+    bool cible, caisse;
+    int numCase;
+    char * c;
+
+    if (plateau_allouer(plateau, niveau->nbLignes, niveau->nbColonnes)
+        != MOTEUR_OK) {
+        return MOTEUR_ERREUR_MEMOIRE;
+    }
+    plateau->ligneSok = etat->caseSok / niveau->largeur - BORDURE;
+    plateau->colonneSok = etat->caseSok % niveau->largeur - BORDURE;
+    plateau->nbCaisses = ZERO;
+    plateau->nbCibles = ZERO;
+    for (int i = ZERO ; i < niveau->nbLignes ; i++) {
+        for (int j = ZERO ; j < niveau->nbColonnes ; j++) {
+            numCase = (i + BORDURE) * niveau->largeur + j + BORDURE;
+            c = &plateau->cases[i * plateau->nbColonnes + j];
+            cible = bit_lire(niveau->cibles, numCase);
+            caisse = bit_lire(etat->caisses, numCase);
+            plateau->nbCibles += cible;
+            plateau->nbCaisses += caisse;
+            if (bit_lire(niveau->murs, numCase)) {
+                *c = MUR;
+            } else if (numCase == etat->caseSok) {
+                *c = cible ? SOKOBAN_CIBLE : SOKOBAN;
+            } else if (caisse) {
+                *c = cible ? CAISSE_CIBLE : CAISSE;
+            } else {
+                *c = cible ? CIBLE : RIEN;
+            }
+        }
+    }
+    return MOTEUR_OK;
+}
+
+void niveau_liberer(t_Niveau * niveau){
+    free(niveau->murs);
+    free(niveau->zobrist);
+    niveau->murs = NULL;
+    niveau->cibles = NULL;
+    niveau->casesMortes = NULL;
+    niveau->tunnels = NULL;
+    niveau->salle = NULL;
+    niveau->zobrist = NULL;
+    niveau->zobristSok = NULL;
+}
+
+uint64_t empreinte_position(const t_Niveau * niveau, const t_Etat * etat,
+    int caseSok){
+
+    return etat->empreinte ^ niveau->zobristSok[caseSok];
+}
+
+t_Erreur etat_copier(const t_Niveau * niveau, t_Etat * copie,
+    const t_Etat * etat){
+
+    *copie = *etat;
+    copie->caisses = couches_allouer(niveau->nbMots, 1);
+    if (copie->caisses == NULL) {
+        return MOTEUR_ERREUR_MEMOIRE;
+    }
+    memcpy(copie->caisses, etat->caisses, niveau->nbMots * sizeof(uint64_t));
+    return MOTEUR_OK;
+}
+
+void etat_liberer(t_Etat * etat){
+    free(etat->caisses);
+    etat->caisses = NULL;
+}
+
+int direction_touche(char deplacement){
+    return CODES_TOUCHES[(uint8_t)deplacement] + ENLEVER;
+}
+
+/**
+ * @brief Garde une copie de l'état quand le compteur arrive sur un multiple de
+ * INTERVALLE_REPERES qui n'a pas encore de repère valide
+ * @param niveau Partie fixe du niveau
+ * @param etat État atteint après nbDepla déplacements
+ * @param nbDepla Nombre de déplacements joués
+ * @param histoDepla Historique des déplacements
+ */
+static void repere_enregistrer(const t_Niveau * niveau, const t_Etat * etat,
+    int nbDepla, t_tabDeplacement * histoDepla){
+
+    int numRepere = histoDepla->nbReperes;
+    t_Etat * reperes;
+
+    if (nbDepla % INTERVALLE_REPERES != ZERO
+        || nbDepla / INTERVALLE_REPERES != numRepere + AJOUTER) {
+        return;
+    }
+    // Les couches des repères oubliés sont réutilisées
+    if (numRepere < histoDepla->nbReperesAlloues) {
+        uint64_t * caisses = histoDepla->reperes[numRepere].caisses;
+        histoDepla->reperes[numRepere] = *etat;
+        histoDepla->reperes[numRepere].caisses = caisses;
+        memcpy(caisses, etat->caisses, niveau->nbMots * sizeof(uint64_t));
+    } else {
+        // Sans mémoire, le repère manque : aller au déplacement partira du
+        // repère précédent
+        reperes = reallouer(histoDepla->reperes,
+            (numRepere + AJOUTER) * sizeof(t_Etat));
+        if (reperes == NULL) {
+            return;
+        }
+        histoDepla->reperes = reperes;
+        if (etat_copier(niveau, &reperes[numRepere], etat) != MOTEUR_OK) {
+            return;
+        }
+        histoDepla->nbReperesAlloues++;
+    }
+    histoDepla->nbReperes++;
+}
+
+/**
+ * @brief Lit la direction et le bit de poussée d'un déplacement enregistré.
+ * Un bloc commence par les directions, quatre par octet, suivies des bits de
+ * poussée, huit par octet
+ * @param histoDepla Historique des déplacements
+ * @param nbDepla Index du déplacement
+ * @param direction Adresse où ranger l'indice de la direction
+ * @return true si une caisse a été poussée
+ */
+static bool historique_decoder(const t_tabDeplacement * histoDepla,
+    int nbDepla, int * direction){
+
+    const uint8_t * bloc = histoDepla->blocs[nbDepla / TAILLE_BLOC_HISTORIQUE];
+    int numDepla = nbDepla % TAILLE_BLOC_HISTORIQUE;
+    const uint8_t * poussees = bloc
+        + TAILLE_BLOC_HISTORIQUE / DEPLACEMENTS_PAR_OCTET;
+
+    *direction = (bloc[numDepla / DEPLACEMENTS_PAR_OCTET]
+        >> (numDepla % DEPLACEMENTS_PAR_OCTET * BITS_PAR_DIRECTION))
+        & MASQUE_DIRECTION;
+    return (poussees[numDepla / BITS_PAR_OCTET] >> (numDepla % BITS_PAR_OCTET))
+        & 1;
+}
+
+/**
+ * @brief Donne la direction d'une lettre de l'historique
+ * @param lettre Lettre de déplacement ('h', 'b', 'g', 'd' ou en majuscule)
+ * @param poussee Adresse où indiquer si la lettre est une poussée
+ * @return Indice de la direction, AUCUNE_DIRECTION si ce n'est pas une lettre
+ * de déplacement
+ */
+static int direction_lettre(char lettre, bool * poussee){
+    int code = CODES_LETTRES[(uint8_t)lettre];
+    *poussee = code > NB_DIRECTIONS;
+    return code + ENLEVER - NB_DIRECTIONS * *poussee;
+}
+
+/**
+ * @brief Ajoute des blocs à l'historique jusqu'à ce qu'il ait nbBlocs blocs.
+ * Hors ligne : la marche, qui n'agrandit presque jamais l'historique, n'en
+ * paie pas le prologue
+ * @param histoDepla Historique des déplacements
+ * @param nbBlocs Nombre de blocs voulu
+ * @return false si la mémoire a manqué (les blocs ajoutés restent)
+ */
+static __attribute__((noinline)) bool historique_agrandir(
+    t_tabDeplacement * histoDepla, int nbBlocs){
+
+    uint8_t ** blocs;
+    int capacite;
+
+    // Les blocs sont ajoutés un par un : ceux qui existent ne bougent pas
+    while (nbBlocs > histoDepla->nbBlocs) {
+        if (histoDepla->nbBlocs == histoDepla->capaciteBlocs) {
+            capacite = histoDepla->capaciteBlocs * DOUBLE + AJOUTER;
+            blocs = reallouer(histoDepla->blocs, capacite * sizeof(uint8_t *));
+            if (blocs == NULL) {
+                return false;
+            }
+            histoDepla->blocs = blocs;
+            histoDepla->capaciteBlocs = capacite;
+        }
+        histoDepla->blocs[histoDepla->nbBlocs] = reallouer(NULL,
+            TAILLE_BLOC_HISTORIQUE / DEPLACEMENTS_PAR_OCTET
+            + TAILLE_BLOC_HISTORIQUE / BITS_PAR_OCTET);
+        if (histoDepla->blocs[histoDepla->nbBlocs] == NULL) {
+            return false;
+        }
+        histoDepla->nbBlocs++;
+    }
+    return true;
+}
+
+/**
+ * @brief Assure que le déplacement d'index nbDepla a sa place dans un bloc
+ * de l'historique
+ * @param histoDepla Historique des déplacements
+ * @param nbDepla Index du déplacement à ranger
+ * @return false si la mémoire manque pour agrandir l'historique
+ */
+static inline bool historique_place(t_tabDeplacement * histoDepla,
+    int nbDepla){
+
+    return nbDepla / TAILLE_BLOC_HISTORIQUE < histoDepla->nbBlocs
+        || historique_agrandir(histoDepla,
+        nbDepla / TAILLE_BLOC_HISTORIQUE + AJOUTER);
+}
+
+t_Erreur historique_reserver(const t_Niveau * niveau,
+    t_tabDeplacement * histoDepla, int nbDeplacements){
+
+    int nbReperes = nbDeplacements / INTERVALLE_REPERES;
+    t_Etat * reperes;
+    uint64_t * caisses;
+
+    if (!historique_agrandir(histoDepla, (nbDeplacements
+        + TAILLE_BLOC_HISTORIQUE + ENLEVER) / TAILLE_BLOC_HISTORIQUE)) {
+        return MOTEUR_ERREUR_MEMOIRE;
+    }
+    if (nbReperes > histoDepla->nbReperesAlloues) {
+        reperes = reallouer(histoDepla->reperes, nbReperes * sizeof(t_Etat));
+        if (reperes == NULL) {
+            return MOTEUR_ERREUR_MEMOIRE;
+        }
+        histoDepla->reperes = reperes;
+        while (histoDepla->nbReperesAlloues < nbReperes) {
+            caisses = couches_allouer(niveau->nbMots, 1);
+            if (caisses == NULL) {
+                return MOTEUR_ERREUR_MEMOIRE;
+            }
+            reperes[histoDepla->nbReperesAlloues++].caisses = caisses;
+        }
+    }
+    return MOTEUR_OK;
+}
+
+/**
+ * @brief Oublie les déplacements enregistrés à partir d'un index, et les
+ * repères qui viennent après
+ * @param histoDepla Historique des déplacements
+ * @param nbDepla Nombre de déplacements gardés
+ */
+static void historique_tronquer(t_tabDeplacement * histoDepla, int nbDepla){
+    histoDepla->nbEnregistres = nbDepla;
+    if (histoDepla->nbReperes > nbDepla / INTERVALLE_REPERES) {
+        histoDepla->nbReperes = nbDepla / INTERVALLE_REPERES;
+    }
+}
+
+/**
+ * @brief Range une direction et son bit de poussée dans l'historique. Si ce
+ * n'est pas le déplacement enregistré à cet index, les suivants sont oubliés
+ * @param histoDepla Historique des déplacements, agrandi si besoin
+ * @param direction Indice de la direction
+ * @param poussee true si une caisse a été poussée
+ * @param nbDepla Index auquel ranger ce déplacement
+ * @return false si la mémoire manque pour agrandir l'historique
+ */
+static bool historique_ecrire_code(t_tabDeplacement * histoDepla,
+    int direction, bool poussee, int nbDepla){
+
+    int numBloc = nbDepla / TAILLE_BLOC_HISTORIQUE;
+    int numDepla = nbDepla % TAILLE_BLOC_HISTORIQUE;
+    int ancienne;
+    uint8_t * bloc, * octet;
+
+    // Refaire un déplacement annulé garde la suite de l'historique
+    if (nbDepla < histoDepla->nbEnregistres) {
+        if (historique_decoder(histoDepla, nbDepla, &ancienne) == poussee
+            && ancienne == direction) {
+            return true;
+        }
+        historique_tronquer(histoDepla, nbDepla);
+    }
+    if (!historique_place(histoDepla, nbDepla)) {
+        return false;
+    }
+    bloc = histoDepla->blocs[numBloc];
+    octet = &bloc[numDepla / DEPLACEMENTS_PAR_OCTET];
+    *octet = (*octet & ~(MASQUE_DIRECTION
+        << (numDepla % DEPLACEMENTS_PAR_OCTET * BITS_PAR_DIRECTION)))
+        | direction << (numDepla % DEPLACEMENTS_PAR_OCTET * BITS_PAR_DIRECTION);
+    octet = &bloc[TAILLE_BLOC_HISTORIQUE / DEPLACEMENTS_PAR_OCTET
+        + numDepla / BITS_PAR_OCTET];
+    *octet = (*octet & ~(1 << numDepla % BITS_PAR_OCTET))
+        | poussee << numDepla % BITS_PAR_OCTET;
+    histoDepla->nbEnregistres = nbDepla + AJOUTER;
+    return true;
+}
+
+t_Erreur ajout_deplacement(t_tabDeplacement * histoDepla, char dernierDepla,
+    int nbDepla){
+
+    bool poussee;
+    int direction = direction_lettre(dernierDepla, &poussee);
+
+    return historique_ecrire_code(histoDepla, direction, poussee, nbDepla)
+        ? MOTEUR_OK : MOTEUR_ERREUR_MEMOIRE;
+}
+
+char historique_lire(const t_tabDeplacement * histoDepla, int nbDepla){
+    int direction;
+    bool poussee = historique_decoder(histoDepla, nbDepla, &direction);
+    return poussee ? LETTRES_POUSSEE[direction]
+        : LETTRES_DEPLACEMENT[direction];
+}
+
+void historique_liberer(t_tabDeplacement * histoDepla){
+    for (int i = ZERO ; i < histoDepla->nbBlocs ; i++) {
+        free(histoDepla->blocs[i]);
+    }
+    for (int i = ZERO ; i < histoDepla->nbReperesAlloues ; i++) {
+        etat_liberer(&histoDepla->reperes[i]);
+    }
+    free(histoDepla->blocs);
+    free(histoDepla->reperes);
+    *histoDepla = HISTORIQUE_VIDE;
+}
+
+/**
+ * @brief Joue un déplacement dont l'effet est connu : pousse la caisse qui
+ * est devant en tenant à jour l'empreinte, les caisses hors cible et l'alerte
+ * de blocage, et range le déplacement dans l'historique. Hors ligne : la
+ * marche sans historique, de loin la plus fréquente, n'en paie pas le
+ * prologue. Sans mémoire pour l'historique, Sokoban ne bouge pas
+ * @param niveau Partie fixe du niveau
+ * @param etat Caisses et position de Sokoban
+ * @param direction Indice de la direction
+ * @param effet Effet lu dans EFFETS_DEPLACEMENT
+ * @param nbDepla Adresse du compteur de déplacements
+ * @param histoDepla Historique des déplacements (ou NULL)
+ */
+static __attribute__((noinline)) void deplacement_appliquer(
+    const t_Niveau * niveau, t_Etat * etat, int direction, int effet,
+    int *nbDepla, t_tabDeplacement * histoDepla){
+
+    int suivante = etat->caseSok + niveau->decalages[direction];
+    int arrivee = suivante + niveau->decalages[direction];
+    bool pousse = effet & POUSSE;
+
+    if (!(effet & AVANCE)
+        || (histoDepla != NULL && !historique_place(histoDepla, *nbDepla))) {
+        return;
+    }
+    if (pousse) {
+        bit_deplacer(etat->caisses, suivante, arrivee);
+        etat->empreinte ^= niveau->zobrist[suivante]
+            ^ niveau->zobrist[arrivee];
+        // +1 si la caisse quitte une cible, -1 si elle arrive sur une cible
+        etat->nbCaissesHorsCible += bit_lire(niveau->cibles, suivante)
+            - bit_lire(niveau->cibles, arrivee);
+        // Une position perdue le reste tant qu'on n'annule pas
+        etat->blocage = etat->blocage
+            || poussee_bloquante(niveau, etat->caisses, arrivee);
+    }
+    etat->caseSok = suivante;
+    *nbDepla += 1;
+    if (histoDepla != NULL) {
+        historique_ecrire_code(histoDepla, direction, pousse,
+            *nbDepla + ENLEVER);
+        repere_enregistrer(niveau, etat, *nbDepla, histoDepla);
+    }
+}
+
+void deplacer_direction(const t_Niveau * niveau, t_Etat * etat,
+    int direction, int *nbDepla, t_tabDeplacement * histoDepla){
+
+    int decalage = niveau->decalages[direction];
+    int suivante = etat->caseSok + decalage;
+    int arrivee = suivante + decalage;
+    int effet, avance;
+
+    // La case d'après ne dépend pas de ce qu'on lit, pour ne pas attendre la
+    // lecture de la case suivante. Derrière la bordure elle sort du plateau :
+    // on lit la case 0, un mur, dont la valeur ne compte pas
+    arrivee = arrivee < ZERO || arrivee >= niveau->nbCases ? ZERO : arrivee;
+    effet = EFFETS_DEPLACEMENT[bit_lire(etat->caisses, suivante) << 2
+        | bit_lire(niveau->murs, suivante) << 1
+        | (bit_lire(niveau->murs, arrivee)
+        | bit_lire(etat->caisses, arrivee))];
+    // La poussée et l'historique sont un appel terminal, hors ligne
+    if ((effet & POUSSE) || histoDepla != NULL) {
+        deplacement_appliquer(niveau, etat, direction, effet, nbDepla,
+            histoDepla);
+        return;
+    }
+    // Sokoban avance de 0 ou 1 case sans test
+    avance = effet & AVANCE;
+    etat->caseSok += decalage & -avance;
+    *nbDepla += avance;
+}
+
+void deplacer(const t_Niveau * niveau, t_Etat * etat, char deplacement,
+    int *nbDepla, t_tabDeplacement * histoDepla){
+
+    int direction = direction_touche(deplacement);
+
+    if (direction != AUCUNE_DIRECTION) {
+        deplacer_direction(niveau, etat, direction, &*nbDepla, histoDepla);
+    }
+}
+
+void annulation_deplacer(const t_Niveau * niveau, t_Etat * etat,
+    int *nbDepla, t_tabDeplacement * histoDepla){
+
+    int direction, decalage, caisse;
+    bool poussee;
+
+    if (*nbDepla == ZERO) {
+        return;
+    }
+    // Le déplacement reste dans l'historique pour pouvoir être refait
+    poussee = historique_decoder(histoDepla, *nbDepla + ENLEVER, &direction);
+    decalage = niveau->decalages[direction];
+    caisse = etat->caseSok + decalage;
+    // Une caisse poussée revient sur la case de Sokoban, qui recule d'une case
+    if (poussee) {
+        bit_deplacer(etat->caisses, caisse, etat->caseSok);
+        etat->empreinte ^= niveau->zobrist[caisse]
+            ^ niveau->zobrist[etat->caseSok];
+        etat->nbCaissesHorsCible += bit_lire(niveau->cibles, caisse)
+            - bit_lire(niveau->cibles, etat->caseSok);
+    }
+    etat->caseSok -= decalage;
+    if (poussee && etat->blocage) {
+        etat->blocage = etat_bloque(niveau, etat);
+    }
+    *nbDepla = *nbDepla - 1;
+}
+
+void refaire_deplacer(const t_Niveau * niveau, t_Etat * etat, int *nbDepla,
+    t_tabDeplacement * histoDepla){
+
+    int direction;
+
+    if (*nbDepla < histoDepla->nbEnregistres) {
+        historique_decoder(histoDepla, *nbDepla, &direction);
+        deplacer_direction(niveau, etat, direction, &*nbDepla, histoDepla);
+    }
+}
+
+void etat_restaurer(const t_Niveau * niveau, t_Etat * etat,
+    const t_Etat * source){
+
+    uint64_t * caisses = etat->caisses;
+    *etat = *source;
+    etat->caisses = caisses;
+    memcpy(etat->caisses, source->caisses, niveau->nbMots * sizeof(uint64_t));
+}
+
+void aller_au_deplacement(const t_Niveau * niveau, t_Etat * etat,
+    const t_Etat * depart, int *nbDepla, t_tabDeplacement * histoDepla,
+    int cible){
+
+    int numRepere, ecart;
+
+    if (cible < ZERO) {
+        cible = ZERO;
+    } else if (cible > histoDepla->nbEnregistres) {
+        cible = histoDepla->nbEnregistres;
+    }
+    // Le repère le plus proche avant la cible, ou le départ
+    numRepere = cible / INTERVALLE_REPERES;
+    if (numRepere > histoDepla->nbReperes) {
+        numRepere = histoDepla->nbReperes;
+    }
+    ecart = cible > *nbDepla ? cible - *nbDepla : *nbDepla - cible;
+    // On ne repart du repère que s'il fait rejouer moins de déplacements
+    if (cible - numRepere * INTERVALLE_REPERES < ecart) {
+        etat_restaurer(niveau, etat, numRepere == ZERO ? depart
+            : &histoDepla->reperes[numRepere + ENLEVER]);
+        *nbDepla = numRepere * INTERVALLE_REPERES;
+    }
+    while (*nbDepla < cible) {
+        refaire_deplacer(niveau, etat, &*nbDepla, histoDepla);
+    }
+    while (*nbDepla > cible) {
+        annulation_deplacer(niveau, etat, &*nbDepla, histoDepla);
+    }
+}
+
+void rejouer(const t_Niveau * niveau, t_Etat * etat, const char lettres[],
+    size_t taille, t_tabDeplacement * histoDepla, t_Rejeu * rejeu){
+
+    long long debut = horloge_us();
+    int direction, avant;
+    bool poussee;
+
+    initialiser_historique_deplacement(histoDepla);
+    rejeu->nbDeplacements = ZERO;
+    rejeu->nbPoussees = ZERO;
+    rejeu->premierIllegal = ZERO;
+    rejeu->lettreIllegale = ATTENTE;
+    for (size_t i = ZERO ; i < taille && rejeu->premierIllegal == ZERO ; i++) {
+        if (lettres[i] == RIEN || lettres[i] == '\n' || lettres[i] == '\r'
+            || lettres[i] == '\t') {
+            continue;
+        }
+        avant = rejeu->nbDeplacements;
+        direction = direction_lettre(lettres[i], &poussee);
+        // La lettre doit dire s'il y a une caisse devant Sokoban ; le
+        // déplacement lui-même suit les mêmes règles que dans le jeu
+        if (direction != AUCUNE_DIRECTION && poussee == bit_lire(etat->caisses,
+            etat->caseSok + niveau->decalages[direction])) {
+            deplacer_direction(niveau, etat, direction,
+                &rejeu->nbDeplacements, histoDepla);
+        }
+        if (rejeu->nbDeplacements == avant) {
+            rejeu->premierIllegal = avant + AJOUTER;
+            rejeu->lettreIllegale = lettres[i];
+        } else {
+            rejeu->nbPoussees += poussee;
+        }
+    }
+    rejeu->resolu = rejeu->premierIllegal == ZERO && gagne(niveau, etat);
+    rejeu->dureeUs = horloge_us() - debut;
+}
+
+t_Erreur calculer_cases_mortes(t_Niveau * niveau){
+    int * file = reallouer(NULL, niveau->nbCases * sizeof(int));
+    uint64_t * vivantes = couches_allouer(niveau->nbMots, 1);
+    int debut = ZERO, fin = ZERO, numCase, precedente, sokoban;
+
+    if (file == NULL || vivantes == NULL) {
+        free(vivantes);
+        free(file);
+        return MOTEUR_ERREUR_MEMOIRE;
+    }
+
+    // Les cibles sont vivantes : une caisse y est déjà arrivée
+    for (numCase = ZERO ; numCase < niveau->nbCases ; numCase++) {
+        if (bit_lire(niveau->cibles, numCase)) {
+            bit_inverser(vivantes, numCase);
+            file[fin++] = numCase;
+        }
+    }
+    // Une caisse arrive en numCase depuis numCase - d si Sokoban se tient
+    // en numCase - 2d pour la pousser ; la bordure de murs arrête le
+    // parcours avant qu'il ne sorte du plateau
+    while (debut < fin) {
+        numCase = file[debut++];
+        for (int d = ZERO ; d < NB_DIRECTIONS ; d++) {
+            precedente = numCase - niveau->decalages[d];
+            sokoban = precedente - niveau->decalages[d];
+            if (!bit_lire(vivantes, precedente)
+                && !bit_lire(niveau->murs, precedente)
+                && !bit_lire(niveau->murs, sokoban)) {
+                bit_inverser(vivantes, precedente);
+                file[fin++] = precedente;
+            }
+        }
+    }
+    // Les bits au-delà de la dernière case restent à zéro
+    for (numCase = ZERO ; numCase < niveau->nbCases ; numCase++) {
+        if (!bit_lire(vivantes, numCase) && !bit_lire(niveau->murs, numCase)) {
+            bit_inverser(niveau->casesMortes, numCase);
+        }
+    }
+    free(vivantes);
+    free(file);
+    return MOTEUR_OK;
+}
+
+t_Erreur calculer_macros(t_Niveau * niveau, const t_Etat * etat){
+    // Parcours en profondeur de Tarjan depuis Sokoban, mené avec une pile
+    // explicite : ordre de visite, plus petit ordre joignable par un arc
+    // arrière, père, et pour chaque sous-arbre sa taille, ses cibles et ses
+    // caisses
+    int * ordre = reallouer(NULL, (size_t)8 * niveau->nbCases * sizeof(int));
+    int * bas = ordre + niveau->nbCases;
+    int * pere = bas + niveau->nbCases;
+    int * taille = pere + niveau->nbCases;
+    int * cibles = taille + niveau->nbCases;
+    int * caisses = cibles + niveau->nbCases;
+    int * pile = caisses + niveau->nbCases;
+    int * prochaine = pile + niveau->nbCases;
+    int nbPile = ZERO, compteur = ZERO, nbCibles = ZERO, numCase, voisine;
+    int meilleure = AUCUNE_CASE, entree = AUCUNE_CASE;
+    uint64_t * murs = niveau->murs, * bouchon;
+
+    niveau->entreeSalle = AUCUNE_CASE;
+    if (ordre == NULL) {
+        return MOTEUR_ERREUR_MEMOIRE;
+    }
+    for (numCase = ZERO ; numCase < niveau->nbCases ; numCase++) {
+        ordre[numCase] = ZERO;
+        if (bit_lire(murs, numCase)) {
+            continue;
+        }
+        nbCibles += bit_lire(niveau->cibles, numCase);
+        // Un tunnel pour les poussées verticales a des murs à gauche et à
+        // droite, un tunnel pour les poussées horizontales en haut et en bas
+        if (!bit_lire(niveau->cibles, numCase)) {
+            if (bit_lire(murs, numCase - 1) && bit_lire(murs, numCase + 1)) {
+                bit_inverser(niveau->tunnels, numCase);
+            }
+            if (bit_lire(murs, numCase - niveau->largeur)
+                && bit_lire(murs, numCase + niveau->largeur)) {
+                bit_inverser(niveau->tunnels + niveau->nbMots, numCase);
+            }
+        }
+    }
+
+    pile[nbPile++] = etat->caseSok;
+    ordre[etat->caseSok] = bas[etat->caseSok] = ++compteur;
+    pere[etat->caseSok] = AUCUNE_CASE;
+    prochaine[etat->caseSok] = ZERO;
+    taille[etat->caseSok] = 1;
+    cibles[etat->caseSok] = bit_lire(niveau->cibles, etat->caseSok);
+    caisses[etat->caseSok] = ZERO;
+    while (nbPile > ZERO) {
+        numCase = pile[nbPile - 1];
+        if (prochaine[numCase] < NB_DIRECTIONS) {
+            voisine = numCase + niveau->decalages[prochaine[numCase]++];
+            if (bit_lire(murs, voisine)) {
+                continue;
+            }
+            if (ordre[voisine] == ZERO) {
+                ordre[voisine] = bas[voisine] = ++compteur;
+                pere[voisine] = numCase;
+                prochaine[voisine] = ZERO;
+                taille[voisine] = 1;
+                cibles[voisine] = bit_lire(niveau->cibles, voisine);
+                caisses[voisine] = bit_lire(etat->caisses, voisine);
+                pile[nbPile++] = voisine;
+            } else if (voisine != pere[numCase]
+                && ordre[voisine] < bas[numCase]) {
+                bas[numCase] = ordre[voisine];
+            }
+            continue;
+        }
+        // Sous-arbre terminé : s'il ne remonte pas au-dessus de son père,
+        // le père est la seule porte entre lui et le reste du niveau
+        nbPile--;
+        voisine = pere[numCase];
+        if (voisine == AUCUNE_CASE) {
+            continue;
+        }
+        if (bas[numCase] < bas[voisine]) {
+            bas[voisine] = bas[numCase];
+        }
+        taille[voisine] += taille[numCase];
+        cibles[voisine] += cibles[numCase];
+        caisses[voisine] += caisses[numCase];
+        if (bas[numCase] >= ordre[voisine] && cibles[numCase] == nbCibles
+            && caisses[numCase] == ZERO && (meilleure == AUCUNE_CASE
+            || taille[numCase] < taille[meilleure])) {
+            meilleure = numCase;
+            entree = voisine;
+        }
+    }
+
+    if (meilleure != AUCUNE_CASE && nbCibles > ZERO) {
+        // L'entrée bouchée par une caisse fictive, la salle est la zone que
+        // Sokoban parcourt depuis la première case du sous-arbre
+        bouchon = couches_allouer(niveau->nbMots, 1);
+        if (bouchon == NULL) {
+            free(ordre);
+            return MOTEUR_ERREUR_MEMOIRE;
+        }
+        bit_inverser(bouchon, entree);
+        zone_remplir(niveau, bouchon, meilleure, niveau->salle);
+        niveau->entreeSalle = entree;
+        free(bouchon);
+    }
+    free(ordre);
+    return MOTEUR_OK;
+}
+
+/**
+ * @brief Indique si une case fait partie des caisses déjà examinées
+ * @param vues Cases déjà examinées
+ * @param nbVues Nombre de cases examinées
+ * @param numCase Case cherchée
+ * @return true si la case est dans la liste
+ */
+static bool case_vue(const int vues[], int nbVues, int numCase){
+    bool trouvee = false;
+    for (int i = ZERO ; i < nbVues && !trouvee ; i++) {
+        trouvee = (vues[i] == numCase);
+    }
+    return trouvee;
+}
+
+/**
+ * @brief Indique si une caisse est gelée, c'est-à-dire immobile sur ses deux
+ * axes. Les caisses déjà examinées comptent comme des murs
+ * @param niveau Partie fixe du niveau
+ * @param caisses Couche des caisses
+ * @param numCase Case de la caisse
+ * @param vues Caisses en cours d'examen (PROFONDEUR_GEL_MAX au plus)
+ * @param nbVues Nombre de caisses en cours d'examen
+ * @param horsCible Mis à true si une caisse gelée n'est pas sur une cible
+ * @return true si la caisse est gelée
+ */
+static bool caisse_gelee(const t_Niveau * niveau, const uint64_t caisses[],
+    int numCase, int vues[], int nbVues, bool * horsCible){
+
+    // Axe horizontal (gauche, droite) puis axe vertical (haut, bas)
+    const int AXES[2][2] = {{2, 3}, {0, 1}};
+    bool gelee = true, axeBloque, horsCibleAvant;
+    int voisine, avant, apres;
+
+    // Une chaîne trop longue est comptée comme mobile, ce qui reste prudent
+    if (nbVues == PROFONDEUR_GEL_MAX) {
+        return false;
+    }
+    vues[nbVues++] = numCase;
+    for (int axe = ZERO ; axe < DOUBLE && gelee ; axe++) {
+        // Pousser le long d'un axe entre deux cases mortes est inutile
+        avant = numCase + niveau->decalages[AXES[axe][0]];
+        apres = numCase + niveau->decalages[AXES[axe][1]];
+        axeBloque = bit_lire(niveau->casesMortes, avant)
+            && bit_lire(niveau->casesMortes, apres);
+        for (int cote = ZERO ; cote < DOUBLE && !axeBloque ; cote++) {
+            voisine = numCase + niveau->decalages[AXES[axe][cote]];
+            axeBloque = bit_lire(niveau->murs, voisine)
+                || (bit_lire(caisses, voisine)
+                && case_vue(vues, nbVues, voisine));
+            if (!axeBloque && bit_lire(caisses, voisine)) {
+                // Une voisine finalement mobile ne compte pas, ni les
+                // caisses qu'elle a crues gelées en passant
+                horsCibleAvant = *horsCible;
+                axeBloque = caisse_gelee(niveau, caisses, voisine, vues,
+                    nbVues, horsCible);
+                if (!axeBloque) {
+                    *horsCible = horsCibleAvant;
+                }
+            }
+        }
+        gelee = axeBloque;
+    }
+    if (gelee && !bit_lire(niveau->cibles, numCase)) {
+        *horsCible = true;
+    }
+    return gelee;
+}
+
+bool poussee_bloquante(const t_Niveau * niveau, const uint64_t caisses[],
+    int caseCaisse){
+
+    int vues[PROFONDEUR_GEL_MAX];
+    bool horsCible = false;
+
+    if (bit_lire(niveau->casesMortes, caseCaisse)) {
+        return true;
+    }
+    // Les caisses voisines ne sont vraiment gelées que si celle-ci l'est
+    return caisse_gelee(niveau, caisses, caseCaisse, vues, ZERO, &horsCible)
+        && horsCible;
+}
+
+bool etat_bloque(const t_Niveau * niveau, const t_Etat * etat){
+    bool bloque = false;
+    uint64_t mot;
+    // Seuls les bits à 1 de la couche des caisses sont parcourus
+    for (int i = ZERO ; i < niveau->nbMots && !bloque ; i++) {
+        for (mot = etat->caisses[i] ; mot != ZERO && !bloque ;
+            mot &= mot - 1) {
+            bloque = poussee_bloquante(niveau, etat->caisses,
+                i * BITS_PAR_MOT + __builtin_ctzll(mot));
+        }
+    }
+    return bloque;
+}
+
+/**
+ * @brief Étend des cases de départ le long des cases libres d'un mot. Vers
+ * les bits de poids fort, l'addition propage une retenue le long de chaque
+ * suite de cases libres qui contient une case de départ ; vers les bits de
+ * poids faible, six décalages doublés suffisent (remplissage de Kogge-Stone)
+ * @param graines Cases de départ, toutes libres
+ * @param libres Cases libres du mot
+ * @return Cases libres reliées à une case de départ dans le mot
+ */
+static uint64_t mot_remplir(uint64_t graines, uint64_t libres){
+    uint64_t passage = libres;
+
+    graines |= ((graines + libres) ^ libres) & libres;
+    for (int pas = 1 ; pas < BITS_PAR_MOT ; pas *= DOUBLE) {
+        graines |= passage & (graines >> pas);
+        passage &= passage >> pas;
+    }
+    return graines;
+}
+
+int zone_remplir(const t_Niveau * niveau, const uint64_t caisses[],
+    int caseSok, uint64_t zone[]){
+
+    const int DERNIER_BIT = BITS_PAR_MOT - 1;
+    // Les mots d'alignement après la dernière case ne sont pas parcourus
+    const int nbMots = (niveau->nbCases + DERNIER_BIT) / BITS_PAR_MOT;
+    const int mots = niveau->largeur / BITS_PAR_MOT;
+    const int bits = niveau->largeur % BITS_PAR_MOT;
+    int i, pas = AJOUTER;
+    uint64_t mot;
+    bool change = true;
+
+    memset(zone, 0, niveau->nbMots * sizeof(uint64_t));
+    bit_inverser(zone, caseSok);
+    // Passes alternées vers le bas et vers le haut de la couche : chaque mot
+    // reçoit aussitôt ce que ses voisins viennent de gagner, si bien que la
+    // zone suit un couloir dans le sens de la passe sans attendre la suivante
+    while (change) {
+        change = false;
+        for (i = pas > ZERO ? ZERO : nbMots - 1 ; i >= ZERO && i < nbMots ;
+            i += pas) {
+
+            // Voisines de gauche et de droite, y compris d'un mot à l'autre
+            mot = zone[i];
+            if (i > ZERO) {
+                mot |= zone[i - 1] >> DERNIER_BIT;
+            }
+            if (i + 1 < nbMots) {
+                mot |= zone[i + 1] << DERNIER_BIT;
+            }
+            // Voisines du dessus (largeur cases avant) et du dessous
+            if (i >= mots) {
+                mot |= zone[i - mots] << bits;
+                if (bits != ZERO && i > mots) {
+                    mot |= zone[i - mots - 1] >> (BITS_PAR_MOT - bits);
+                }
+            }
+            if (i + mots < nbMots) {
+                mot |= zone[i + mots] >> bits;
+                if (bits != ZERO && i + mots + 1 < nbMots) {
+                    mot |= zone[i + mots + 1] << (BITS_PAR_MOT - bits);
+                }
+            }
+            mot = mot_remplir(mot & ~(niveau->murs[i] | caisses[i]),
+                ~(niveau->murs[i] | caisses[i]));
+            if (mot != zone[i]) {
+                zone[i] = mot;
+                change = true;
+            }
+        }
+        pas = -pas;
+    }
+    for (i = ZERO ; zone[i] == ZERO ; i++) {
+    }
+    return i * BITS_PAR_MOT + __builtin_ctzll(zone[i]);
+}
+
+void initialiser_historique_deplacement(t_tabDeplacement * histoDepla){
+    histoDepla->nbEnregistres = ZERO;
+    histoDepla->nbReperes = ZERO;
+}
+
+bool gagne(const t_Niveau * niveau, const t_Etat * etat){
+    (void)niveau;
+    return etat->nbCaissesHorsCible == ZERO;
+}
+
+t_Erreur etat_verifier(const t_Niveau * niveau, const t_Etat * etat){
+    return compter_caisses_hors_cible(niveau, etat) == etat->nbCaissesHorsCible
+        ? MOTEUR_OK : MOTEUR_ERREUR_COMPTEUR;
+}
+
+int compter_caisses_hors_cible(const t_Niveau * niveau, const t_Etat * etat){
+    int nbHorsCible = ZERO;
+    // Regarde toutes les cases du plateau
+    for (int numCase = ZERO ; numCase < niveau->nbCases ; numCase++){
+        if (bit_lire(etat->caisses, numCase)
+            && !bit_lire(niveau->cibles, numCase)){
+            nbHorsCible++;
+        }
+    }
+    return nbHorsCible;
+}
+
+t_Erreur fichier_lire(const char fichier[], char ** texte, size_t * taille){
+    struct stat infos;
+    ssize_t lus = ZERO, n = ZERO;
+    int f;
+
+    f = open(fichier, O_RDONLY);
+    if (f < ZERO || fstat(f, &infos) < ZERO){
+        if (f >= ZERO) {
+            close(f);
+        }
+        return MOTEUR_ERREUR_FICHIER;
+    }
+    *texte = reallouer(NULL, infos.st_size + 1);
+    if (*texte == NULL) {
+        close(f);
+        return MOTEUR_ERREUR_MEMOIRE;
+    }
+    while (lus < infos.st_size
+        && ((n = read(f, *texte + lus, infos.st_size - lus)) > ZERO
+        || (n < ZERO && errno == EINTR))) {
+        lus += n > ZERO ? n : ZERO;
+    }
+    close(f);
+    if (n < ZERO){
+        free(*texte);
+        *texte = NULL;
+        return MOTEUR_ERREUR_FICHIER;
+    }
+    *taille = lus;
+    return MOTEUR_OK;
+}
+
+char * separateur_niveau(char fichier[]){
+    char * numero = strrchr(fichier, SEPARATEUR_NIVEAU);
+    if (numero != NULL && numero[1] != '\0'
+        && strspn(numero + 1, "0123456789") == strlen(numero + 1)) {
+        return numero;
+    }
+    return NULL;
+}
+
+t_Erreur charger_partie(t_Plateau * plateau, char fichier[]){
+    char * texte, * numero = separateur_niveau(fichier);
+    size_t taille;
+    t_Recueil recueil;
+    t_Erreur erreur;
+
+    // "recueil.sok#12" : seul le 12e niveau du recueil est lu
+    if (numero != NULL) {
+        *numero = '\0';
+        erreur = recueil_ouvrir(&recueil, fichier);
+        *numero = SEPARATEUR_NIVEAU;
+        if (erreur == MOTEUR_OK) {
+            erreur = recueil_niveau(&recueil, atoi(numero + 1), plateau);
+            recueil_fermer(&recueil);
+        }
+        return erreur;
+    }
+    // Tout le fichier est lu d'un coup : un seul read() pour un niveau
+    erreur = fichier_lire(fichier, &texte, &taille);
+    if (erreur == MOTEUR_OK) {
+        erreur = plateau_analyser(texte, taille, plateau);
+        free(texte);
+    }
+    return erreur;
+}
+
+/**
+ * @brief Longueur utile d'une ligne, sans les blancs ni le '\r' de la fin
+ * @param ligne Début de la ligne
+ * @param longueur Nombre d'octets avant le '\n'
+ * @return Nombre d'octets à garder
+ */
+static int ligne_longueur_utile(const char ligne[], size_t longueur){
+    while (longueur > ZERO && (ligne[longueur - 1] == RIEN
+        || ligne[longueur - 1] == '\t' || ligne[longueur - 1] == '\r')) {
+        longueur--;
+    }
+    return longueur > (size_t)NB_COLONNES_MAX ? NB_COLONNES_MAX + 1
+        : (int)longueur;
+}
+
+t_Erreur plateau_analyser(const char texte[], size_t taille,
+    t_Plateau * plateau){
+
+    const char * finLigne;
+    size_t debut, fin;
+    int longueur, nbLignes = ZERO, nbColonnes = ZERO, numLigne = ZERO;
+    char c;
+
+    // Premier passage : dimensions du plateau
+    for (debut = ZERO ; debut < taille ; debut = fin + 1) {
+        finLigne = memchr(texte + debut, '\n', taille - debut);
+        fin = finLigne == NULL ? taille : (size_t)(finLigne - texte);
+        longueur = ligne_longueur_utile(texte + debut, fin - debut);
+        numLigne++;
+        if (longueur > ZERO) {
+            nbLignes = numLigne;
+        }
+        if (longueur > nbColonnes) {
+            nbColonnes = longueur;
+        }
+    }
+    if (nbLignes == ZERO || nbLignes > NB_LIGNES_MAX
+        || nbColonnes > NB_COLONNES_MAX) {
+        return MOTEUR_ERREUR_TAILLE;
+    }
+    // Second passage : copie des lignes, les plus courtes complétées par du
+    // vide, et relevé de Sokoban, des caisses et des cibles
+    if (plateau_allouer(plateau, nbLignes, nbColonnes) != MOTEUR_OK) {
+        return MOTEUR_ERREUR_MEMOIRE;
+    }
+    memset(plateau->cases, RIEN, (size_t)nbLignes * nbColonnes);
+    plateau->ligneSok = AUCUNE_CASE;
+    plateau->nbCaisses = ZERO;
+    plateau->nbCibles = ZERO;
+    debut = ZERO;
+    for (numLigne = ZERO ; numLigne < nbLignes ; numLigne++) {
+        finLigne = memchr(texte + debut, '\n', taille - debut);
+        fin = finLigne == NULL ? taille : (size_t)(finLigne - texte);
+        longueur = ligne_longueur_utile(texte + debut, fin - debut);
+        for (int j = ZERO ; j < longueur ; j++) {
+            c = texte[debut + j];
+            // Le format XSB note aussi le sol '-' ou '_'
+            if (c == SOL_XSB || c == SOL_XSB_SOULIGNE) {
+                c = RIEN;
+            }
+            plateau->cases[numLigne * nbColonnes + j] = c;
+            if (c == SOKOBAN || c == SOKOBAN_CIBLE) {
+                plateau->ligneSok = numLigne;
+                plateau->colonneSok = j;
+            }
+            plateau->nbCaisses += (c == CAISSE || c == CAISSE_CIBLE);
+            plateau->nbCibles += (c == CIBLE || c == CAISSE_CIBLE
+                || c == SOKOBAN_CIBLE);
+        }
+        debut = fin + 1;
+    }
+    return plateau->ligneSok == AUCUNE_CASE ? MOTEUR_ERREUR_SOKOBAN
+        : MOTEUR_OK;
+}
+
+/**
+ * @brief Indique si une ligne d'un recueil XSB fait partie d'un plateau :
+ * elle n'a que des caractères de plateau, dont au moins un mur (les titres
+ * et les commentaires en ';' n'en font pas partie)
+ * @param ligne Début de la ligne
+ * @param longueur Nombre d'octets avant le '\n'
+ * @return true si la ligne appartient à un plateau
+ */
+static bool ligne_de_plateau(const char ligne[], size_t longueur){
+    int utile = ligne_longueur_utile(ligne, longueur);
+    bool plateau = utile > ZERO, mur = false;
+
+    for (int i = ZERO ; i < utile && plateau ; i++) {
+        plateau = memchr(CARACTERES_PLATEAU, ligne[i],
+            sizeof(CARACTERES_PLATEAU) - 1) != NULL;
+        mur = mur || ligne[i] == MUR;
+    }
+    return plateau && mur;
+}
+
+/**
+ * @brief Parcourt tout le recueil pour relever le début et la longueur de
+ * chaque niveau (suite de lignes de plateau)
+ * @param recueil Recueil projeté en mémoire
+ * @return false si la mémoire a manqué
+ */
+static bool recueil_indexer(t_Recueil * recueil){
+    uint64_t * positions;
+    const char * finLigne;
+    size_t debut, fin, debutNiveau = ZERO, finNiveau = ZERO;
+    int capacite = ZERO;
+    bool dansNiveau = false, ligneNiveau;
+
+    recueil->nbNiveaux = ZERO;
+    for (debut = ZERO ; debut <= recueil->taille ; debut = fin + 1) {
+        finLigne = debut < recueil->taille ? memchr(recueil->texte + debut,
+            '\n', recueil->taille - debut) : NULL;
+        fin = finLigne == NULL ? recueil->taille
+            : (size_t)(finLigne - recueil->texte);
+        ligneNiveau = debut < recueil->taille
+            && ligne_de_plateau(recueil->texte + debut, fin - debut);
+        if (ligneNiveau) {
+            if (!dansNiveau) {
+                debutNiveau = debut;
+            }
+            finNiveau = fin;
+            dansNiveau = true;
+        } else if (dansNiveau) {
+            // Fin du niveau en cours
+            if (recueil->nbNiveaux == capacite) {
+                capacite = capacite * DOUBLE + CAPACITE_INITIALE_RECHERCHE;
+                positions = reallouer(recueil->positions,
+                    capacite * DOUBLE * sizeof(uint64_t));
+                if (positions == NULL) {
+                    return false;
+                }
+                recueil->positions = positions;
+            }
+            recueil->positions[recueil->nbNiveaux * DOUBLE] = debutNiveau;
+            recueil->positions[recueil->nbNiveaux * DOUBLE + 1] =
+                finNiveau - debutNiveau;
+            recueil->nbNiveaux++;
+            dansNiveau = false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Date de dernière modification d'un fichier
+ * @param infos Informations données par fstat()
+ * @return Nanosecondes écoulées depuis le 1er janvier 1970
+ */
+static int64_t date_modification(const struct stat * infos){
+    return (int64_t)infos->st_mtim.tv_sec * NANOSECONDES_PAR_MICROSECONDE
+        * MICROSECONDES_PAR_SECONDE + infos->st_mtim.tv_nsec;
+}
+
+/**
+ * @brief Projette en mémoire l'index d'un recueil s'il correspond toujours
+ * au recueil (même taille, même date de modification)
+ * @param recueil Recueil dont on cherche l'index
+ * @param nomIndex Nom du fichier d'index
+ * @param infos Taille et date du recueil
+ * @return true si l'index a pu être utilisé
+ */
+static bool index_projeter(t_Recueil * recueil, const char nomIndex[],
+    const struct stat * infos){
+
+    struct stat infosIndex;
+    const t_EnteteIndex * entete;
+    void * projection;
+    bool valide;
+    int f = open(nomIndex, O_RDONLY);
+
+    if (f < ZERO) {
+        return false;
+    }
+    if (fstat(f, &infosIndex) < ZERO
+        || (size_t)infosIndex.st_size < sizeof(t_EnteteIndex)) {
+        close(f);
+        return false;
+    }
+    projection = mmap(NULL, infosIndex.st_size, PROT_READ, MAP_PRIVATE, f,
+        ZERO);
+    close(f);
+    if (projection == MAP_FAILED) {
+        return false;
+    }
+    entete = projection;
+    valide = memcmp(entete->magique, MAGIQUE_INDEX, sizeof(MAGIQUE_INDEX))
+        == ZERO
+        && entete->tailleRecueil == (uint64_t)infos->st_size
+        && entete->dateRecueil == date_modification(infos)
+        && (uint64_t)infosIndex.st_size == sizeof(t_EnteteIndex)
+        + entete->nbNiveaux * DOUBLE * sizeof(uint64_t);
+    if (!valide) {
+        munmap(projection, infosIndex.st_size);
+        return false;
+    }
+    recueil->nbNiveaux = entete->nbNiveaux;
+    recueil->positions = (uint64_t *)(entete + 1);
+    recueil->projectionIndex = projection;
+    recueil->tailleIndex = infosIndex.st_size;
+    return true;
+}
+
+/**
+ * @brief Écrit l'index d'un recueil à côté de celui-ci. Un échec (dossier en
+ * lecture seule...) n'empêche pas de jouer : l'index sera refait
+ * @param recueil Recueil indexé
+ * @param nomIndex Nom du fichier d'index
+ * @param infos Taille et date du recueil
+ */
+static void index_ecrire(const t_Recueil * recueil, const char nomIndex[],
+    const struct stat * infos){
+
+    t_EnteteIndex entete;
+    int f = open(nomIndex, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (f < ZERO) {
+        return;
+    }
+    memset(&entete, 0, sizeof(entete));
+    memcpy(entete.magique, MAGIQUE_INDEX, sizeof(MAGIQUE_INDEX));
+    entete.tailleRecueil = infos->st_size;
+    entete.dateRecueil = date_modification(infos);
+    entete.nbNiveaux = recueil->nbNiveaux;
+    if (write(f, &entete, sizeof(entete)) != (ssize_t)sizeof(entete)
+        || write(f, recueil->positions, recueil->nbNiveaux * DOUBLE
+        * sizeof(uint64_t)) != (ssize_t)(recueil->nbNiveaux * DOUBLE
+        * sizeof(uint64_t))) {
+        // Un index incomplet serait refusé à la lecture : on l'efface
+        unlink(nomIndex);
+    }
+    close(f);
+}
+
+t_Erreur recueil_ouvrir(t_Recueil * recueil, const char fichier[]){
+    struct stat infos;
+    char * nomIndex;
+    void * projection;
+    int f;
+
+    memset(recueil, 0, sizeof(*recueil));
+    f = open(fichier, O_RDONLY);
+    if (f < ZERO || fstat(f, &infos) < ZERO || infos.st_size == ZERO){
+        if (f >= ZERO) {
+            close(f);
+        }
+        return MOTEUR_ERREUR_FICHIER;
+    }
+    projection = mmap(NULL, infos.st_size, PROT_READ, MAP_PRIVATE, f, ZERO);
+    close(f);
+    if (projection == MAP_FAILED){
+        return MOTEUR_ERREUR_FICHIER;
+    }
+    recueil->texte = projection;
+    recueil->taille = infos.st_size;
+    nomIndex = reallouer(NULL, strlen(fichier) + sizeof(SUFFIXE_INDEX));
+    if (nomIndex == NULL) {
+        recueil_fermer(recueil);
+        return MOTEUR_ERREUR_MEMOIRE;
+    }
+    strcpy(nomIndex, fichier);
+    strcat(nomIndex, SUFFIXE_INDEX);
+    // Le recueil n'est parcouru qu'à la première ouverture
+    if (!index_projeter(recueil, nomIndex, &infos)) {
+        if (!recueil_indexer(recueil)) {
+            free(nomIndex);
+            recueil_fermer(recueil);
+            return MOTEUR_ERREUR_MEMOIRE;
+        }
+        index_ecrire(recueil, nomIndex, &infos);
+    }
+    free(nomIndex);
+    return MOTEUR_OK;
+}
+
+t_Erreur recueil_niveau(const t_Recueil * recueil, int numero,
+    t_Plateau * plateau){
+
+    if (numero < 1 || numero > recueil->nbNiveaux) {
+        return MOTEUR_ERREUR_NIVEAU;
+    }
+    return plateau_analyser(recueil->texte
+        + recueil->positions[(numero - 1) * DOUBLE],
+        recueil->positions[(numero - 1) * DOUBLE + 1], plateau);
+}
+
+void recueil_fermer(t_Recueil * recueil){
+    if (recueil->projectionIndex != NULL) {
+        munmap(recueil->projectionIndex, recueil->tailleIndex);
+    } else {
+        free(recueil->positions);
+    }
+    munmap((void *)recueil->texte, recueil->taille);
+    memset(recueil, 0, sizeof(*recueil));
+}
+
+t_Erreur enregistrer_partie(const t_Plateau * plateau, char fichier[]){
+    FILE * f;
+    char finDeLigne='\n';
+    bool ecrit;
+
+    f = fopen(fichier, "w");
+    if (f == NULL) {
+        return MOTEUR_ERREUR_FICHIER;
+    }
+    for (int ligne = 0 ; ligne < plateau->nbLignes ; ligne++){
+        fwrite(plateau->cases + ligne * plateau->nbColonnes, sizeof(char),
+            plateau->nbColonnes, f);
+        fwrite(&finDeLigne, sizeof(char), 1, f);
+    }
+    ecrit = !ferror(f);
+    ecrit = fclose(f) == ZERO && ecrit;
+    return ecrit ? MOTEUR_OK : MOTEUR_ERREUR_FICHIER;
+}
+
+long long horloge_us(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * MICROSECONDES_PAR_SECONDE
+        + t.tv_nsec / NANOSECONDES_PAR_MICROSECONDE;
+}
+
+t_Erreur historique_ecrire(const t_tabDeplacement * t, int nb, FILE * f){
+    char * lettres = reallouer(NULL, TAILLE_BLOC_HISTORIQUE);
+    int taille;
+
+    if (lettres == NULL) {
+        return MOTEUR_ERREUR_MEMOIRE;
+    }
+    // Les déplacements sont réécrits en lettres un bloc à la fois
+    for (int debut = ZERO ; debut < nb ; debut += taille) {
+        taille = nb - debut < TAILLE_BLOC_HISTORIQUE ? nb - debut
+            : TAILLE_BLOC_HISTORIQUE;
+        for (int i = ZERO ; i < taille ; i++) {
+            lettres[i] = historique_lire(t, debut + i);
+        }
+        fwrite(lettres, sizeof(char), taille, f);
+    }
+    free(lettres);
+    return ferror(f) ? MOTEUR_ERREUR_FICHIER : MOTEUR_OK;
+}
+
+t_Erreur enregistrer_deplacements(const t_tabDeplacement * t, int nb,
+    char fic[]){
+
+    FILE * f;
+    t_Erreur erreur;
+
+    f = fopen(fic, "w");
+    if (f == NULL) {
+        return MOTEUR_ERREUR_FICHIER;
+    }
+    erreur = historique_ecrire(t, nb, f);
+    if (fclose(f) != ZERO && erreur == MOTEUR_OK) {
+        erreur = MOTEUR_ERREUR_FICHIER;
+    }
+    return erreur;
+}
+
+void * reallouer(void * bloc, size_t taille){
+    void * nouveau = realloc(bloc, taille);
+#ifdef COMPTER_ALLOCATIONS
+    atomic_fetch_add_explicit(&nbAllocations, 1, memory_order_relaxed);
+#endif
+    return nouveau;
+}
+
+const char * erreur_texte(t_Erreur erreur){
+    return MESSAGES_ERREUR[erreur];
+}
+
+long long nb_allocations(){
+#ifdef COMPTER_ALLOCATIONS
+    return atomic_load_explicit(&nbAllocations, memory_order_relaxed);
+#else
+    return ALLOCATIONS_NON_COMPTEES;
+#endif
+}
+
+/**
+ * @brief Range de nouveau dans la table toutes les positions valides, les
+ * premières d'abord pour que chaque empreinte désigne son premier
+ * déplacement
+ * @param positions Positions de la partie
+ * @param capaciteTable Nouvelle taille de la table (puissance de deux)
+ * @return false si la mémoire manque pour la nouvelle table (l'ancienne
+ * reste)
+ */
+static bool positions_ranger(t_Positions * positions, int capaciteTable){
+    uint32_t masque = capaciteTable - 1, place;
+    uint32_t * table;
+
+    if (capaciteTable != positions->capaciteTable) {
+        table = reallouer(positions->table, capaciteTable * sizeof(uint32_t));
+        if (table == NULL) {
+            return false;
+        }
+        positions->table = table;
+        positions->capaciteTable = capaciteTable;
+    }
+    memset(positions->table, 0, capaciteTable * sizeof(uint32_t));
+    positions->nbOccupees = ZERO;
+    for (int i = ZERO ; i < positions->nbInscrites ; i++) {
+        place = positions->empreintes[i] & masque;
+        while (positions->table[place] != ZERO
+            && positions->empreintes[positions->table[place] + ENLEVER]
+            != positions->empreintes[i]) {
+            place = (place + 1) & masque;
+        }
+        if (positions->table[place] == ZERO) {
+            positions->table[place] = i + 1;
+            positions->nbOccupees++;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Agrandit les positions pour nbPositions positions, départ compris
+ * @param positions Positions de la partie
+ * @param nbPositions Nombre de positions à pouvoir inscrire
+ * @return false si la mémoire manque
+ */
+static bool positions_reserver(t_Positions * positions, int nbPositions){
+    int capaciteTable = positions->capaciteTable;
+    uint64_t * empreintes;
+
+    if (nbPositions > positions->capacite) {
+        empreintes = reallouer(positions->empreintes,
+            nbPositions * sizeof(uint64_t));
+        if (empreintes == NULL) {
+            return false;
+        }
+        positions->empreintes = empreintes;
+        positions->capacite = nbPositions;
+    }
+    // La table reste remplie à moins de la moitié
+    while (capaciteTable < DOUBLE * nbPositions) {
+        capaciteTable = capaciteTable == ZERO ? CAPACITE_INITIALE_RECHERCHE
+            : capaciteTable * DOUBLE;
+    }
+    return capaciteTable == positions->capaciteTable
+        || positions_ranger(positions, capaciteTable);
+}
+
+/**
+ * @brief Cherche le premier déplacement valide après lequel une empreinte a
+ * été atteinte
+ * @param positions Positions de la partie
+ * @param empreinte Empreinte cherchée
+ * @return Indice du déplacement, AUCUN_DEPLACEMENT si elle n'y est pas
+ */
+static int positions_chercher(const t_Positions * positions,
+    uint64_t empreinte){
+
+    uint32_t masque = positions->capaciteTable - 1;
+    uint32_t place = empreinte & masque;
+    int indice;
+
+    // Les places périmées sont sautées sans arrêter le sondage
+    while (positions->table[place] != ZERO) {
+        indice = positions->table[place] + ENLEVER;
+        if (indice < positions->nbInscrites
+            && positions->empreintes[indice] == empreinte) {
+            return indice;
+        }
+        place = (place + 1) & masque;
+    }
+    return AUCUN_DEPLACEMENT;
+}
+
+/**
+ * @brief Inscrit la position atteinte après un déplacement. Les positions
+ * qui la suivaient sont oubliées si elle diffère de celle déjà inscrite. La
+ * place de indice + 1 positions doit avoir été réservée
+ * @param positions Positions de la partie
+ * @param indice Nombre de déplacements joués
+ * @param empreinte Empreinte exacte de la position
+ */
+static void positions_inscrire(t_Positions * positions, int indice,
+    uint64_t empreinte){
+
+    uint32_t masque, place;
+
+    if (indice < positions->nbInscrites
+        && positions->empreintes[indice] == empreinte) {
+        return;
+    }
+    positions->nbInscrites = indice;
+    positions->empreintes[indice] = empreinte;
+    // Trop de places périmées : la table est refaite avec les seules valides
+    if (positions->nbOccupees >= positions->capaciteTable / DOUBLE) {
+        positions_ranger(positions, positions->capaciteTable);
+    }
+    if (positions_chercher(positions, empreinte) == AUCUN_DEPLACEMENT) {
+        masque = positions->capaciteTable - 1;
+        place = empreinte & masque;
+        while (positions->table[place] != ZERO) {
+            place = (place + 1) & masque;
+        }
+        positions->table[place] = indice + 1;
+        positions->nbOccupees++;
+    }
+    positions->nbInscrites = indice + 1;
+}
+
+t_Erreur partie_ouvrir(t_Partie * partie, const t_Plateau * plateau,
+    int nbReserves){
+
+    memset(partie, 0, sizeof(*partie));
+    if (etat_depuis_plateau(plateau, &partie->niveau, &partie->etat)
+        != MOTEUR_OK) {
+        return MOTEUR_ERREUR_MEMOIRE;
+    }
+    partie->historique = HISTORIQUE_VIDE;
+    // Tout ce qui a été alloué avant un échec est rendu par partie_liberer
+    if (etat_copier(&partie->niveau, &partie->depart, &partie->etat)
+        != MOTEUR_OK
+        || historique_reserver(&partie->niveau, &partie->historique,
+        nbReserves) != MOTEUR_OK
+        || !positions_reserver(&partie->positions, nbReserves + 1)) {
+        partie_liberer(partie);
+        return MOTEUR_ERREUR_MEMOIRE;
+    }
+    positions_inscrire(&partie->positions, ZERO, empreinte_position(
+        &partie->niveau, &partie->etat, partie->etat.caseSok));
+    return MOTEUR_OK;
+}
+
+void partie_liberer(t_Partie * partie){
+    free(partie->positions.empreintes);
+    free(partie->positions.table);
+    memset(&partie->positions, 0, sizeof(partie->positions));
+    historique_liberer(&partie->historique);
+    etat_liberer(&partie->depart);
+    etat_liberer(&partie->etat);
+    niveau_liberer(&partie->niveau);
+}
+
+/**
+ * @brief Réserve l'historique et les positions de la partie pour quelques
+ * déplacements de plus, avant de les jouer
+ * @param partie Partie en cours
+ * @param nbDeplacements Nombre de déplacements à pouvoir ajouter
+ * @return false si la mémoire manque
+ */
+static bool partie_reserver(t_Partie * partie, int nbDeplacements){
+    int dernier = partie->nbDeplacements + nbDeplacements;
+    return historique_place(&partie->historique, dernier + ENLEVER)
+        && positions_reserver(&partie->positions, dernier + AJOUTER);
+}
+
+bool partie_deplacer(t_Partie * partie, int direction){
+    int avant = partie->nbDeplacements;
+    // Sans mémoire pour le garder, le déplacement n'est pas joué
+    if (!partie_reserver(partie, AJOUTER)) {
+        return false;
+    }
+    deplacer_direction(&partie->niveau, &partie->etat, direction,
+        &partie->nbDeplacements, &partie->historique);
+    if (partie->nbDeplacements == avant) {
+        return false;
+    }
+    positions_inscrire(&partie->positions, partie->nbDeplacements,
+        empreinte_position(&partie->niveau, &partie->etat,
+        partie->etat.caseSok));
+    return true;
+}
+
+bool partie_annuler(t_Partie * partie){
+    int avant = partie->nbDeplacements;
+    annulation_deplacer(&partie->niveau, &partie->etat,
+        &partie->nbDeplacements, &partie->historique);
+    return partie->nbDeplacements != avant;
+}
+
+bool partie_refaire(t_Partie * partie){
+    int avant = partie->nbDeplacements;
+    refaire_deplacer(&partie->niveau, &partie->etat,
+        &partie->nbDeplacements, &partie->historique);
+    return partie->nbDeplacements != avant;
+}
+
+void partie_aller(t_Partie * partie, int numero){
+    aller_au_deplacement(&partie->niveau, &partie->etat, &partie->depart,
+        &partie->nbDeplacements, &partie->historique, numero);
+}
+
+void partie_recommencer(t_Partie * partie){
+    etat_restaurer(&partie->niveau, &partie->etat, &partie->depart);
+    partie->nbDeplacements = ZERO;
+    initialiser_historique_deplacement(&partie->historique);
+    partie->positions.nbInscrites = ZERO;
+    positions_inscrire(&partie->positions, ZERO, empreinte_position(
+        &partie->niveau, &partie->etat, partie->etat.caseSok));
+}
+
+bool partie_gagnee(const t_Partie * partie){
+    return gagne(&partie->niveau, &partie->etat);
+}
+
+int partie_deja_vue(const t_Partie * partie){
+    int indice = positions_chercher(&partie->positions, empreinte_position(
+        &partie->niveau, &partie->etat, partie->etat.caseSok));
+    return indice < partie->nbDeplacements ? indice : AUCUN_DEPLACEMENT;
+}
+
+bool partie_couper_boucle(t_Partie * partie){
+    int debut = partie_deja_vue(partie);
+
+    if (debut == AUCUN_DEPLACEMENT) {
+        return false;
+    }
+    // La position est la même : seuls le compteur et l'historique changent
+    partie_aller(partie, debut);
+    historique_tronquer(&partie->historique, debut);
+    partie->positions.nbInscrites = debut + 1;
+    return true;
+}
+
+/**
+ * @brief Donne la case d'une ligne et d'une colonne du plateau
+ * @param niveau Partie fixe du niveau
+ * @param ligne Ligne du plateau (à partir de 0)
+ * @param colonne Colonne du plateau (à partir de 0)
+ * @return Indice de la case, AUCUNE_CASE hors du plateau
+ */
+static int case_plateau(const t_Niveau * niveau, int ligne, int colonne){
+    if (ligne < ZERO || ligne >= niveau->nbLignes || colonne < ZERO
+        || colonne >= niveau->nbColonnes) {
+        return AUCUNE_CASE;
+    }
+    return (ligne + BORDURE) * niveau->largeur + colonne + BORDURE;
+}
+
+/**
+ * @brief Cherche un plus court chemin de Sokoban sans poussée (parcours en
+ * largeur), puis range ses directions de l'arrivée vers le départ
+ * @param niveau Partie fixe du niveau
+ * @param caisses Couche des caisses
+ * @param depart Case de départ de Sokoban
+ * @param arrivee Case à atteindre
+ * @param file Tableau de nbCases cases : file du parcours, puis directions
+ * du chemin dans l'ordre inverse
+ * @param precedent Tableau de nbCases directions, rempli par le parcours
+ * @return Longueur du chemin, AUCUN_DEPLACEMENT si l'arrivée est hors
+ * d'atteinte
+ */
+static int marche_calculer(const t_Niveau * niveau, const uint64_t caisses[],
+    int depart, int arrivee, int file[], int precedent[]){
+
+    int debut = ZERO, fin = ZERO, longueur = ZERO, numCase, voisine;
+
+    for (numCase = ZERO ; numCase < niveau->nbCases ; numCase++) {
+        precedent[numCase] = AUCUNE_DIRECTION;
+    }
+    file[fin++] = depart;
+    while (debut < fin && precedent[arrivee] == AUCUNE_DIRECTION
+        && arrivee != depart) {
+        numCase = file[debut++];
+        for (int d = ZERO ; d < NB_DIRECTIONS ; d++) {
+            voisine = numCase + niveau->decalages[d];
+            if (voisine != depart && precedent[voisine] == AUCUNE_DIRECTION
+                && !bit_lire(niveau->murs, voisine)
+                && !bit_lire(caisses, voisine)) {
+                precedent[voisine] = d;
+                file[fin++] = voisine;
+            }
+        }
+    }
+    if (arrivee != depart && precedent[arrivee] == AUCUNE_DIRECTION) {
+        return AUCUN_DEPLACEMENT;
+    }
+    // La file n'est plus utile : elle garde les directions du chemin
+    for (numCase = arrivee ; numCase != depart ;
+        numCase -= niveau->decalages[precedent[numCase]]) {
+        file[longueur++] = precedent[numCase];
+    }
+    return longueur;
+}
+
+/**
+ * @brief Joue une marche de Sokoban jusqu'à une case libre qu'il peut
+ * atteindre sans pousser
+ * @param partie Partie en cours
+ * @param arrivee Case à atteindre
+ * @param file Tableau de travail de nbCases cases
+ * @param precedent Tableau de travail de nbCases cases
+ * @return Nombre de déplacements joués, AUCUN_DEPLACEMENT si l'arrivée est
+ * hors d'atteinte ou si la mémoire manque
+ */
+static int marche_jouer(t_Partie * partie, int arrivee, int file[],
+    int precedent[]){
+
+    int longueur = marche_calculer(&partie->niveau, partie->etat.caisses,
+        partie->etat.caseSok, arrivee, file, precedent);
+
+    // Toute la marche est réservée d'avance : elle n'est jamais coupée
+    if (longueur != AUCUN_DEPLACEMENT && !partie_reserver(partie, longueur)) {
+        return AUCUN_DEPLACEMENT;
+    }
+    for (int i = longueur - 1 ; i >= ZERO ; i--) {
+        partie_deplacer(partie, file[i]);
+    }
+    return longueur;
+}
+
+int partie_marcher_vers(t_Partie * partie, int ligne, int colonne){
+    int arrivee = case_plateau(&partie->niveau, ligne, colonne), longueur;
+    int * file, * precedent;
+
+    if (arrivee == AUCUNE_CASE) {
+        return AUCUN_DEPLACEMENT;
+    }
+    file = reallouer(NULL, DOUBLE * partie->niveau.nbCases * sizeof(int));
+    if (file == NULL) {
+        return AUCUN_DEPLACEMENT;
+    }
+    precedent = file + partie->niveau.nbCases;
+    longueur = marche_jouer(partie, arrivee, file, precedent);
+    free(file);
+    return longueur;
+}
+
+int partie_pousser_vers(t_Partie * partie, int ligneCaisse,
+    int colonneCaisse, int ligne, int colonne){
+
+    const t_Niveau * niveau = &partie->niveau;
+    const int * decalages = niveau->decalages;
+    int origine = case_plateau(niveau, ligneCaisse, colonneCaisse);
+    int arrivee = case_plateau(niveau, ligne, colonne);
+    int nbEtats = niveau->nbCases * NB_DIRECTIONS, debut = ZERO, fin = ZERO;
+    // Le départ n'est pas un état : il a pour indice nbEtats, qui ne se
+    // confond pas avec AUCUNE_CASE (état pas encore atteint)
+    int depart = nbEtats, etat = depart;
+    int caisse, caseSok, suivante, nbPoussees = ZERO;
+    int nbDepla = ZERO, longueur;
+    int * parents, * file, * chemin, * precedent;
+    uint64_t * caisses, * zone;
+
+    if (origine == AUCUNE_CASE || arrivee == AUCUNE_CASE
+        || !bit_lire(partie->etat.caisses, origine)) {
+        return AUCUN_DEPLACEMENT;
+    }
+    // Un état est la case de la caisse et la dernière direction de poussée
+    // (Sokoban est juste derrière)
+    parents = reallouer(NULL, (size_t)(DOUBLE * nbEtats
+        + DOUBLE * niveau->nbCases) * sizeof(int));
+    caisses = couches_allouer(niveau->nbMots, DOUBLE);
+    if (parents == NULL || caisses == NULL) {
+        free(caisses);
+        free(parents);
+        return AUCUN_DEPLACEMENT;
+    }
+    file = parents + nbEtats;
+    chemin = file + nbEtats;
+    precedent = chemin + niveau->nbCases;
+    for (int i = ZERO ; i < nbEtats ; i++) {
+        parents[i] = AUCUNE_CASE;
+    }
+    zone = caisses + niveau->nbMots;
+    // Couche des autres caisses : celle qui est poussée est remise à chaque
+    // calcul de zone
+    memcpy(caisses, partie->etat.caisses, niveau->nbMots * sizeof(uint64_t));
+    bit_inverser(caisses, origine);
+
+    // Parcours en largeur des états : le moins de poussées possible
+    caisse = origine;
+    caseSok = partie->etat.caseSok;
+    while (caisse != arrivee) {
+        bit_inverser(caisses, caisse);
+        zone_remplir(niveau, caisses, caseSok, zone);
+        bit_inverser(caisses, caisse);
+        for (int d = ZERO ; d < NB_DIRECTIONS ; d++) {
+            suivante = caisse + decalages[d];
+            if (bit_lire(zone, caisse - decalages[d])
+                && !bit_lire(niveau->murs, suivante)
+                && !bit_lire(caisses, suivante)
+                && parents[suivante * NB_DIRECTIONS + d] == AUCUNE_CASE) {
+                parents[suivante * NB_DIRECTIONS + d] = etat;
+                file[fin++] = suivante * NB_DIRECTIONS + d;
+            }
+        }
+        if (debut == fin) {
+            break;
+        }
+        etat = file[debut++];
+        caisse = etat / NB_DIRECTIONS;
+        caseSok = caisse - decalages[etat % NB_DIRECTIONS];
+    }
+
+    if (caisse == arrivee) {
+        // Les poussées sont relevées de l'arrivée vers le départ, puis
+        // jouées dans l'ordre : une marche jusque derrière la caisse, une
+        // poussée
+        for (int e = etat ; e != depart && nbPoussees < nbEtats ;
+            e = parents[e]) {
+            file[nbPoussees++] = e;
+        }
+        longueur = ZERO;
+        for (int i = nbPoussees - 1 ; i >= ZERO
+            && longueur != AUCUN_DEPLACEMENT ; i--) {
+            caisse = file[i] / NB_DIRECTIONS - decalages[file[i]
+                % NB_DIRECTIONS];
+            nbDepla = marche_jouer(partie, caisse
+                - decalages[file[i] % NB_DIRECTIONS], chemin, precedent);
+            // Seul un manque de mémoire arrête les poussées en chemin
+            if (nbDepla == AUCUN_DEPLACEMENT
+                || !partie_deplacer(partie, file[i] % NB_DIRECTIONS)) {
+                longueur = AUCUN_DEPLACEMENT;
+            } else {
+                longueur += nbDepla + AJOUTER;
+            }
+        }
+    } else {
+        longueur = AUCUN_DEPLACEMENT;
+    }
+    free(caisses);
+    free(parents);
+    return longueur;
+}
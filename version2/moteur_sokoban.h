@@ -0,0 +1,804 @@
+/**
+* @file moteur_sokoban.h
+* @brief Moteur du Sokoban : règles du jeu, niveaux et historique
+* @author Evan BENOIT
+* @version 2.0
+* @date 30/11/2025
+*
+* Le moteur ne lit pas le clavier et n'écrit rien à l'écran : le jeu en
+* terminal, les solveurs et les modes sans affichage de sokoban.c s'en
+* servent, et il peut être utilisé seul. Une partie (t_Partie) regroupe tout
+* ce qui change pendant le jeu ; le moteur n'a pas de variable globale (sauf
+* le compteur d'allocations des bancs d'essai, s'il est compilé avec
+* -DCOMPTER_ALLOCATIONS).
+* Les déplacements ne font aucune allocation tant que l'historique réservé
+* par partie_ouvrir (ou historique_reserver) n'est pas dépassé, et aucune du
+* tout si l'historique donné est NULL.
+*
+* Les fichiers ne sont lus et écrits qu'au chargement et à l'enregistrement.
+* Le moteur n'arrête jamais le programme : un fichier illisible, un plateau
+* invalide ou un manque de mémoire sont rendus par un t_Erreur (ou NULL), et
+* c'est à l'appelant de les signaler.
+*
+* Compilation de la bibliothèque seule :
+*   gcc -O2 -c moteur_sokoban.c
+*   ar rcs libmoteur_sokoban.a moteur_sokoban.o
+*
+*/
+
+#ifndef MOTEUR_SOKOBAN_H
+#define MOTEUR_SOKOBAN_H
+
+/* Fichiers inclus */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+* Constantes communes au moteur et à ses utilisateurs (static pour que
+* chaque fichier qui inclut l'en-tête ait les siennes)
+*/
+static const int ZERO=0;
+static const int NB_LIGNES_MAX=1024;
+static const int NB_COLONNES_MAX=1024;
+static const int BORDURE=1;
+static const int TAILLE_BLOC_HISTORIQUE=4096;
+static const int INTERVALLE_REPERES=16384;
+static const int ENLEVER=-1;
+static const int AJOUTER=1;
+static const int DOUBLE=2;
+static const char GAUCHE='q';
+static const char DROITE='d';
+static const char HAUT='z';
+static const char BAS='s';
+static const char SOKOBAN='@';
+static const char MUR='#';
+static const char RIEN=' ';
+static const char CAISSE='$';
+static const char CIBLE='.';
+static const char SOKOBAN_GAUCHE='g';
+static const char SOKOBAN_DROITE='d';
+static const char SOKOBAN_HAUT='h';
+static const char SOKOBAN_BAS='b';
+static const char SOKOBAN_CAISSE_GAUCHE='G';
+static const char SOKOBAN_CAISSE_DROITE='D';
+static const char SOKOBAN_CAISSE_HAUT='H';
+static const char SOKOBAN_CAISSE_BAS='B';
+static const char SOKOBAN_CIBLE='+';
+static const char CAISSE_CIBLE='*';
+static const char ATTENTE='\0';
+static const long long MICROSECONDES_PAR_SECONDE=1000000;
+static const int BITS_PAR_MOT=64;
+static const int BITS_PAR_OCTET=8;
+static const int AUCUNE_DIRECTION=-1;
+static const int AUCUNE_CASE=-1;
+static const int AUCUN_DEPLACEMENT=-1;
+static const long long ALLOCATIONS_NON_COMPTEES=-1;
+static const int CAPACITE_INITIALE_RECHERCHE=1024;
+static const char SEPARATEUR_NIVEAU='#';
+
+/* Compte rendu des fonctions du moteur qui peuvent échouer */
+typedef enum {
+    MOTEUR_OK,
+    MOTEUR_ERREUR_MEMOIRE,
+    MOTEUR_ERREUR_FICHIER,
+    MOTEUR_ERREUR_TAILLE,      // Plateau vide ou trop grand
+    MOTEUR_ERREUR_SOKOBAN,     // Plateau sans Sokoban
+    MOTEUR_ERREUR_NIVEAU,      // Numéro absent du recueil
+    MOTEUR_ERREUR_COMPTEUR     // Compteur de caisses hors cible faux
+} t_Erreur;
+
+/* Plateau de caractères tel qu'il est lu dans un fichier, ligne par ligne */
+typedef struct {
+    int nbLignes;
+    int nbColonnes;
+    char * cases;          // nbLignes * nbColonnes caractères
+    int ligneSok;          // Relevés à la lecture du plateau
+    int colonneSok;
+    int nbCaisses;
+    int nbCibles;
+} t_Plateau;
+
+/* Plateau sans cases, à donner en valeur initiale */
+static const t_Plateau PLATEAU_VIDE = {0, 0, NULL, 0, 0, 0, 0};
+
+/*
+* Recueil de niveaux au format XSB (plateaux séparés par des lignes vides,
+* des titres ou des commentaires), projeté en mémoire. Chaque niveau est
+* repéré par son début et sa longueur dans le texte
+*/
+typedef struct {
+    const char * texte;
+    size_t taille;
+    int nbNiveaux;
+    uint64_t * positions;      // Début et longueur, deux mots par niveau
+    void * projectionIndex;    // Index lu sur disque (NULL s'il a été calculé)
+    size_t tailleIndex;
+} t_Recueil;
+
+/*
+* Moteur du jeu : chaque couche du plateau est un tableau de bits (bitboard).
+* Le plateau est entouré d'une bordure de murs, ce qui évite de tester les
+* bords : la case (ligne, colonne) correspond au bit
+* (ligne + BORDURE) * largeur + colonne + BORDURE
+*/
+#define NB_DIRECTIONS 4
+
+/*
+* Partie fixe du niveau, qui ne change pas pendant la partie. Une caisse
+* posée sur une case morte ne peut plus jamais atteindre de cible
+*/
+typedef struct {
+    int nbLignes;          // Dimensions du plateau lu
+    int nbColonnes;
+    int largeur;           // Dimensions avec la bordure
+    int hauteur;
+    int nbCases;
+    int nbMots;            // Mots de 64 bits par couche, multiple d'une ligne
+                           // de cache pour que chaque couche y soit alignée
+    int decalages[NB_DIRECTIONS];  // Haut, bas, gauche, droite
+    uint64_t * murs;       // Les six couches sont dans un même bloc
+    uint64_t * cibles;
+    uint64_t * casesMortes;
+    uint64_t * tunnels;    // Cases de tunnel pour les poussées verticales,
+                           // puis horizontales (deux couches)
+    uint64_t * salle;      // Salle des cibles, vide si le niveau n'en a pas
+    int entreeSalle;       // Seule case d'accès à la salle, ou AUCUNE_CASE
+    uint64_t * zobrist;    // Clé de Zobrist d'une caisse sur chaque case,
+    uint64_t * zobristSok; // puis de Sokoban (même bloc, nbCases chacune)
+} t_Niveau;
+
+/*
+* Partie mobile du niveau : les caisses et la case de Sokoban, ainsi que le
+* nombre de caisses qui ne sont pas sur une cible (la partie est gagnée
+* quand il vaut zéro), si la position est perdue d'avance et l'empreinte de
+* Zobrist des caisses (ou exclusif des clés de leurs cases), tenue à jour à
+* chaque poussée
+*/
+typedef struct {
+    uint64_t * caisses;    // Couche de nbMots mots
+    int caseSok;
+    int nbCaissesHorsCible;
+    bool blocage;          // Une caisse ne peut plus atteindre de cible
+    uint64_t empreinte;
+} t_Etat;
+
+/*
+* Journal des déplacements : chaque déplacement tient en 2 bits de direction
+* (quatre par octet) et 1 bit de poussée, rangés dans des blocs de
+* TAILLE_BLOC_HISTORIQUE déplacements ajoutés au besoin et jamais recopiés.
+* Annuler ne fait que reculer le compteur : les déplacements suivants restent
+* enregistrés pour être refaits, jusqu'à ce qu'un autre déplacement les
+* remplace. Une copie de l'état tous les INTERVALLE_REPERES déplacements
+* permet d'aller directement à n'importe quel déplacement
+*/
+typedef struct {
+    uint8_t ** blocs;      // Directions puis bits de poussée de chaque bloc
+    int nbBlocs;
+    int capaciteBlocs;
+    int nbEnregistres;     // Déplacements joués ou annulés mais refaisables
+    t_Etat * reperes;      // reperes[k] : état après (k+1)*INTERVALLE_REPERES
+    int nbReperes;         // Repères valides
+    int nbReperesAlloues;  // Repères dont les caisses sont allouées
+} t_tabDeplacement;
+
+static const t_tabDeplacement HISTORIQUE_VIDE = {NULL, 0, 0, 0, NULL, 0, 0};
+
+/*
+* Positions atteintes pendant la partie : l'empreinte exacte (caisses et case
+* de Sokoban) après chaque déplacement de l'historique, et une table qui
+* retrouve le premier déplacement où une empreinte a été atteinte. Une place
+* de la table qui désigne un déplacement oublié se reconnaît à ce que
+* l'empreinte rangée à cet indice ne correspond plus
+*/
+typedef struct {
+    uint64_t * empreintes;     // empreintes[k] : après k déplacements
+    int nbInscrites;           // Positions valides, départ compris
+    int capacite;
+    uint32_t * table;          // Indice + 1 dans empreintes, 0 : place libre
+    int capaciteTable;         // Puissance de deux
+    int nbOccupees;            // Places prises, périmées comprises
+} t_Positions;
+
+/* Lettres de l'historique pour chaque direction : 'h', 'b', 'g', 'd' ... */
+static const char LETTRES_DEPLACEMENT[NB_DIRECTIONS] = {'h', 'b', 'g', 'd'};
+/* ... et en majuscule quand une caisse est poussée */
+static const char LETTRES_POUSSEE[NB_DIRECTIONS] = {'H', 'B', 'G', 'D'};
+
+/* Résultat du rejeu d'un fichier de déplacements */
+typedef struct {
+    int nbDeplacements;
+    int nbPoussees;
+    int premierIllegal;    // Numéro du déplacement refusé, 0 si aucun
+    char lettreIllegale;
+    bool resolu;
+    long long dureeUs;
+} t_Rejeu;
+
+/*
+* Partie en cours : le niveau, la position de départ et la position
+* courante, le nombre de déplacements joués et leur historique
+*/
+typedef struct {
+    t_Niveau niveau;
+    t_Etat depart;
+    t_Etat etat;
+    int nbDeplacements;
+    t_tabDeplacement historique;
+    t_Positions positions;
+} t_Partie;
+
+/**
+ * @brief Indique si une case est occupée dans une couche du plateau
+ * @param couche Couche à lire
+ * @param numCase Indice de la case
+ * @return true si le bit de la case vaut 1
+ */
+static inline bool bit_lire(const uint64_t couche[], int numCase){
+    return (couche[numCase / BITS_PAR_MOT] >> (numCase % BITS_PAR_MOT)) & 1;
+}
+
+/**
+ * @brief Inverse le bit d'une case dans une couche du plateau
+ * @param couche Couche à modifier
+ * @param numCase Indice de la case
+ */
+static inline void bit_inverser(uint64_t couche[], int numCase){
+    couche[numCase / BITS_PAR_MOT] ^= (uint64_t)1 << (numCase % BITS_PAR_MOT);
+}
+
+/**
+ * @brief Déplace une caisse d'une case à une autre dans la couche des caisses
+ * @param caisses Couche des caisses
+ * @param depart Case où se trouve la caisse
+ * @param arrivee Case où va la caisse
+ */
+static inline void bit_deplacer(uint64_t caisses[], int depart, int arrivee){
+    bit_inverser(caisses, depart);
+    bit_inverser(caisses, arrivee);
+}
+
+/* Mémoire et temps */
+
+/**
+ * @brief Agrandit un bloc mémoire. Comme realloc, l'ancien bloc reste
+ * valide en cas d'échec
+ * @param bloc Bloc à agrandir (ou NULL)
+ * @param taille Nouvelle taille en octets
+ * @return Adresse du bloc agrandi, NULL si la mémoire manque
+ */
+void * reallouer(void * bloc, size_t taille);
+
+/**
+ * @brief Alloue des couches remises à zéro, alignées sur une ligne de cache
+ * @param nbMots Nombre de mots d'une couche (multiple de l'alignement)
+ * @param nbCouches Nombre de couches consécutives
+ * @return Adresse de la première couche, NULL si la mémoire manque
+ */
+uint64_t * couches_allouer(int nbMots, int nbCouches);
+
+/**
+ * @brief Compte les allocations du programme (appels à reallouer et
+ * couches_allouer, tous fils confondus). Elles ne sont comptées que si le
+ * moteur est compilé avec -DCOMPTER_ALLOCATIONS
+ * @return Nombre d'allocations depuis le lancement, ALLOCATIONS_NON_COMPTEES
+ * sans -DCOMPTER_ALLOCATIONS
+ */
+long long nb_allocations();
+
+/**
+ * @brief Donne le message d'erreur d'un compte rendu du moteur
+ * @param erreur Compte rendu d'une fonction du moteur
+ * @return Message en majuscules, comme les autres erreurs du jeu
+ */
+const char * erreur_texte(t_Erreur erreur);
+
+/**
+ * @brief Donne l'heure d'une horloge monotone
+ * @return Nombre de microsecondes écoulées depuis une origine arbitraire
+ */
+long long horloge_us();
+
+/* Plateaux et fichiers de niveaux */
+
+/**
+ * @brief Donne à un plateau les dimensions voulues
+ * @param plateau Plateau à (ré)allouer, vide ou déjà alloué
+ * @param nbLignes Nombre de lignes
+ * @param nbColonnes Nombre de colonnes
+ * @return MOTEUR_OK, ou MOTEUR_ERREUR_MEMOIRE (plateau inchangé)
+ */
+t_Erreur plateau_allouer(t_Plateau * plateau, int nbLignes, int nbColonnes);
+
+/**
+ * @brief Libère la mémoire d'un plateau
+ * @param plateau Plateau à libérer
+ */
+void plateau_liberer(t_Plateau * plateau);
+
+/**
+ * @brief Lit tout un fichier en mémoire, d'un seul read() le plus souvent
+ * @param fichier Nom du fichier
+ * @param texte Adresse où ranger le contenu du fichier (à libérer par free)
+ * @param taille Adresse où ranger le nombre d'octets lus
+ * @return MOTEUR_OK, MOTEUR_ERREUR_FICHIER ou MOTEUR_ERREUR_MEMOIRE
+ */
+t_Erreur fichier_lire(const char fichier[], char ** texte, size_t * taille);
+
+/**
+ * @brief Cherche le numéro de niveau à la fin d'un nom de la forme
+ * "recueil.sok#12"
+ * @param fichier Nom du niveau
+ * @return Adresse du SEPARATEUR_NIVEAU, NULL si le nom n'a pas de numéro
+ */
+char * separateur_niveau(char fichier[]);
+
+/**
+ * @brief Charge un plateau à partir d'un fichier, lu en une seule fois puis
+ * analysé par plateau_analyser. "recueil.sok#12" désigne le 12e niveau d'un
+ * recueil XSB
+ * @param plateau Plateau du jeu à remplir (à libérer par plateau_liberer)
+ * @param fichier Nom du fichier source, suivi ou non de '#' et d'un numéro
+ * @return MOTEUR_OK, ou l'erreur du fichier, du recueil ou du plateau
+ */
+t_Erreur charger_partie(t_Plateau * plateau, char fichier[]);
+
+/**
+ * @brief Lit un plateau dans un texte déjà en mémoire. Les lignes peuvent
+ * avoir des longueurs différentes (les plus courtes sont complétées par du
+ * vide), finir par "\r\n" ou par des blancs ; les lignes vides de la fin ne
+ * comptent pas. Relève au passage Sokoban, les caisses et les cibles
+ * @param texte Texte du plateau
+ * @param taille Nombre d'octets du texte
+ * @param plateau Plateau à remplir (à libérer par plateau_liberer)
+ * @return MOTEUR_OK, MOTEUR_ERREUR_TAILLE, MOTEUR_ERREUR_SOKOBAN ou
+ * MOTEUR_ERREUR_MEMOIRE
+ */
+t_Erreur plateau_analyser(const char texte[], size_t taille,
+    t_Plateau * plateau);
+
+/**
+ * @brief Ouvre un recueil de niveaux. Les positions des niveaux sont lues
+ * dans le fichier d'index (nom du recueil suivi de ".idx") ; s'il manque ou
+ * ne correspond plus au recueil, celui-ci est parcouru et l'index réécrit
+ * @param recueil Recueil à remplir (à fermer par recueil_fermer)
+ * @param fichier Nom du recueil
+ * @return MOTEUR_OK, MOTEUR_ERREUR_FICHIER ou MOTEUR_ERREUR_MEMOIRE (rien
+ * à fermer)
+ */
+t_Erreur recueil_ouvrir(t_Recueil * recueil, const char fichier[]);
+
+/**
+ * @brief Lit un niveau d'un recueil, sans parcourir les autres
+ * @param recueil Recueil ouvert
+ * @param numero Numéro du niveau, à partir de 1
+ * @param plateau Plateau à remplir (à libérer par plateau_liberer)
+ * @return MOTEUR_OK, MOTEUR_ERREUR_NIVEAU si le numéro n'est pas dans le
+ * recueil, ou l'erreur de plateau_analyser
+ */
+t_Erreur recueil_niveau(const t_Recueil * recueil, int numero,
+    t_Plateau * plateau);
+
+/**
+ * @brief Ferme un recueil ouvert par recueil_ouvrir
+ * @param recueil Recueil à fermer
+ */
+void recueil_fermer(t_Recueil * recueil);
+
+/**
+ * @brief Enregistre un plateau dans un fichier
+ * @param plateau Plateau à sauvegarder
+ * @param fichier Nom du fichier de destination
+ * @return MOTEUR_OK, ou MOTEUR_ERREUR_FICHIER
+ */
+t_Erreur enregistrer_partie(const t_Plateau * plateau, char fichier[]);
+
+/* Niveau et position */
+
+/**
+ * @brief Sépare un plateau en couches de bits pour le moteur du jeu
+ * @param plateau Plateau lu dans un fichier
+ * @param niveau Partie fixe du niveau à remplir (murs et cibles)
+ * @param etat Partie mobile à remplir (caisses et Sokoban)
+ * @return MOTEUR_OK, ou MOTEUR_ERREUR_MEMOIRE (rien à libérer)
+ */
+t_Erreur etat_depuis_plateau(const t_Plateau * plateau, t_Niveau * niveau,
+    t_Etat * etat);
+
+/**
+ * @brief Reconstruit le plateau de caractères pour l'affichage ou la sauvegarde
+ * @param niveau Partie fixe du niveau
+ * @param etat Partie mobile du niveau
+ * @param plateau Plateau à remplir
+ * @return MOTEUR_OK, ou MOTEUR_ERREUR_MEMOIRE
+ */
+t_Erreur etat_vers_plateau(const t_Niveau * niveau, const t_Etat * etat,
+    t_Plateau * plateau);
+
+/**
+ * @brief Calcule les cases mortes du niveau par tirages inverses : en partant
+ * des cibles, une caisse peut venir d'une case voisine si Sokoban a la place
+ * de la pousser ; toutes les cases jamais atteintes sont mortes
+ * @param niveau Niveau dont les murs et les cibles sont déjà remplis
+ * @return MOTEUR_OK, ou MOTEUR_ERREUR_MEMOIRE
+ */
+t_Erreur calculer_cases_mortes(t_Niveau * niveau);
+
+/**
+ * @brief Repère les tunnels et la salle des cibles, qui permettent aux
+ * solveurs d'enchaîner plusieurs poussées en un seul coup. Une case de tunnel
+ * n'est pas une cible et a un mur de chaque côté de l'axe de poussée. La
+ * salle des cibles est la plus petite zone qui contient toutes les cibles, ni
+ * caisse ni Sokoban au départ, et qu'une seule case (l'entrée) relie au reste
+ * @param niveau Niveau dont les murs et les cibles sont déjà remplis
+ * @param etat Position de départ
+ * @return MOTEUR_OK, ou MOTEUR_ERREUR_MEMOIRE
+ */
+t_Erreur calculer_macros(t_Niveau * niveau, const t_Etat * etat);
+
+/**
+ * @brief Indique si une caisse crée une impasse : elle est sur une case morte,
+ * ou elle est gelée (bloquée sur les deux axes par des murs, des cases mortes
+ * ou d'autres caisses gelées) avec au moins une caisse gelée hors cible.
+ * Sert d'alerte dans le jeu et d'élagage dans les solveurs
+ * @param niveau Partie fixe du niveau
+ * @param caisses Couche des caisses (la caisse testée comprise)
+ * @param caseCaisse Case de la caisse qui vient d'être poussée
+ * @return true si la position ne peut plus être gagnée
+ */
+bool poussee_bloquante(const t_Niveau * niveau, const uint64_t caisses[],
+    int caseCaisse);
+
+/**
+ * @brief Regarde toutes les caisses pour savoir si la position est perdue
+ * @param niveau Partie fixe du niveau
+ * @param etat Position à examiner
+ * @return true si une caisse crée une impasse
+ */
+bool etat_bloque(const t_Niveau * niveau, const t_Etat * etat);
+
+/**
+ * @brief Remplit la couche des cases où Sokoban peut aller sans pousser de
+ * caisse. Le remplissage avance de 64 cases à la fois, par décalages et
+ * masques des mots de la couche, au lieu d'un parcours case par case
+ * @param niveau Partie fixe du niveau
+ * @param caisses Couche des caisses
+ * @param caseSok Case de départ de Sokoban
+ * @param zone Couche à remplir (nbMots mots)
+ * @return Case de plus petit indice de la zone (case normalisée)
+ */
+int zone_remplir(const t_Niveau * niveau, const uint64_t caisses[],
+    int caseSok, uint64_t zone[]);
+
+/**
+ * @brief Libère les couches d'un niveau
+ * @param niveau Niveau rempli par etat_depuis_plateau
+ */
+void niveau_liberer(t_Niveau * niveau);
+
+/**
+ * @brief Copie une position dans une nouvelle couche de caisses
+ * @param niveau Niveau de la position
+ * @param copie Position à remplir (à libérer par etat_liberer)
+ * @param etat Position à copier
+ * @return MOTEUR_OK, ou MOTEUR_ERREUR_MEMOIRE (rien à libérer)
+ */
+t_Erreur etat_copier(const t_Niveau * niveau, t_Etat * copie,
+    const t_Etat * etat);
+
+/**
+ * @brief Remplace une position par une autre sans changer sa couche de
+ * caisses
+ * @param niveau Partie fixe du niveau
+ * @param etat Position à remplacer
+ * @param source Position à recopier
+ */
+void etat_restaurer(const t_Niveau * niveau, t_Etat * etat,
+    const t_Etat * source);
+
+/**
+ * @brief Empreinte d'une position : celle des caisses et la clé de la case de
+ * Sokoban. Avec la case exacte, deux positions égales ont la même empreinte ;
+ * avec la case normalisée de sa zone, c'est le cas de deux positions où
+ * Sokoban peut aller de l'une à l'autre sans pousser
+ * @param niveau Partie fixe du niveau
+ * @param etat Caisses de la position
+ * @param caseSok Case de Sokoban, exacte ou normalisée
+ * @return Empreinte sur 64 bits
+ */
+uint64_t empreinte_position(const t_Niveau * niveau, const t_Etat * etat,
+    int caseSok);
+
+/**
+ * @brief Libère la couche des caisses d'une position
+ * @param etat Position à libérer
+ */
+void etat_liberer(t_Etat * etat);
+
+/**
+ * @brief Fonction qui renvoie si le joueur a gagné
+ * @param niveau Partie fixe du niveau
+ * @param etat Caisses et position de Sokoban
+ * @return true si le joueur a gagné sinon false
+ */
+bool gagne(const t_Niveau * niveau, const t_Etat * etat);
+
+/**
+ * @brief Recompte case par case les caisses qui ne sont pas sur une cible
+ * @param niveau Partie fixe du niveau
+ * @param etat Caisses et position de Sokoban
+ * @return Nombre de caisses hors cible
+ */
+int compter_caisses_hors_cible(const t_Niveau * niveau, const t_Etat * etat);
+
+/**
+ * @brief Vérifie le compteur de caisses hors cible tenu par les déplacements,
+ * sur lequel repose gagne(), en recomptant les caisses
+ * @param niveau Partie fixe du niveau
+ * @param etat Caisses et position de Sokoban
+ * @return MOTEUR_OK, ou MOTEUR_ERREUR_COMPTEUR si le compteur est faux
+ */
+t_Erreur etat_verifier(const t_Niveau * niveau, const t_Etat * etat);
+
+/* Déplacements */
+
+/**
+ * @brief Donne la direction associée à une touche
+ * @param deplacement Touche appuyée
+ * @return Indice de la direction dans niveau->decalages, AUCUNE_DIRECTION
+ * sinon
+ */
+int direction_touche(char deplacement);
+
+/**
+ * @brief Regroupe les déplacements possibles et les applique
+ * @param niveau Partie fixe du niveau
+ * @param etat Caisses et position de Sokoban
+ * @param deplacement Touche correspondant au mouvement
+ * @param nbDepla Nombre de déplacements effectués
+ * @param histoDepla Historique des déplacements (NULL pour ne pas les
+ * garder)
+ */
+void deplacer(const t_Niveau * niveau, t_Etat * etat, char deplacement,
+    int * nbDepla, t_tabDeplacement * histoDepla);
+
+/**
+ * @brief Applique un déplacement dans une direction. Il n'est pas joué si
+ * l'historique doit être agrandi et que la mémoire manque
+ * @param niveau Partie fixe du niveau
+ * @param etat Caisses et position de Sokoban
+ * @param direction Indice de la direction dans niveau->decalages
+ * @param nbDepla Adresse du compteur de déplacements
+ * @param histoDepla Historique des déplacements (ou NULL)
+ */
+void deplacer_direction(const t_Niveau * niveau, t_Etat * etat,
+    int direction, int * nbDepla, t_tabDeplacement * histoDepla);
+
+/**
+ * @brief Annule le dernier déplacement effectué en fonction de l'historique
+ * @param niveau Partie fixe du niveau
+ * @param etat Caisses et position de Sokoban
+ * @param nbDepla Adresse du compteur de déplacements
+ * @param histoDepla Historique des déplacements
+ */
+void annulation_deplacer(const t_Niveau * niveau, t_Etat * etat,
+    int * nbDepla, t_tabDeplacement * histoDepla);
+
+/**
+ * @brief Refait le déplacement annulé qui suit le compteur, s'il y en a un
+ * @param niveau Partie fixe du niveau
+ * @param etat Caisses et position de Sokoban
+ * @param nbDepla Adresse du compteur de déplacements
+ * @param histoDepla Historique des déplacements
+ */
+void refaire_deplacer(const t_Niveau * niveau, t_Etat * etat, int * nbDepla,
+    t_tabDeplacement * histoDepla);
+
+/**
+ * @brief Amène la partie à un déplacement quelconque de l'historique, en
+ * annulant, en refaisant, ou en repartant du repère le plus proche
+ * @param niveau Partie fixe du niveau
+ * @param etat Caisses et position de Sokoban
+ * @param depart État au début de la partie
+ * @param nbDepla Adresse du compteur de déplacements
+ * @param histoDepla Historique des déplacements
+ * @param cible Numéro du déplacement voulu (ramené entre 0 et le nombre de
+ * déplacements enregistrés)
+ */
+void aller_au_deplacement(const t_Niveau * niveau, t_Etat * etat,
+    const t_Etat * depart, int * nbDepla, t_tabDeplacement * histoDepla,
+    int cible);
+
+/* Historique et rejeu */
+
+/**
+ * @brief Vide l'historique des déplacements (les blocs et les repères déjà
+ * alloués sont gardés pour la partie suivante)
+ * @param histoDepla Historique des déplacements à réinitialiser
+ */
+void initialiser_historique_deplacement(t_tabDeplacement * histoDepla);
+
+/**
+ * @brief Alloue d'avance les blocs et les repères de l'historique pour
+ * nbDeplacements déplacements, qui se joueront alors sans allocation
+ * @param niveau Partie fixe du niveau (taille des repères)
+ * @param histoDepla Historique des déplacements
+ * @param nbDeplacements Nombre de déplacements à prévoir
+ * @return MOTEUR_OK, ou MOTEUR_ERREUR_MEMOIRE (ce qui a pu être réservé
+ * reste dans l'historique)
+ */
+t_Erreur historique_reserver(const t_Niveau * niveau,
+    t_tabDeplacement * histoDepla, int nbDeplacements);
+
+/**
+ * @brief Ajoute un déplacement à l'historique. S'il diffère de celui qui
+ * était enregistré à cet index, les déplacements suivants sont oubliés
+ * @param histoDepla Historique des déplacements, agrandi si besoin
+ * @param dernierDepla Caractère représentant le déplacement effectué
+ * @param nbDepla Index auquel ajouter ce déplacement
+ * @return MOTEUR_OK, ou MOTEUR_ERREUR_MEMOIRE (déplacement non ajouté)
+ */
+t_Erreur ajout_deplacement(t_tabDeplacement * histoDepla, char dernierDepla,
+    int nbDepla);
+
+/**
+ * @brief Lit un déplacement de l'historique
+ * @param histoDepla Historique des déplacements
+ * @param nbDepla Index du déplacement (déjà ajouté)
+ * @return Caractère représentant le déplacement
+ */
+char historique_lire(const t_tabDeplacement * histoDepla, int nbDepla);
+
+/**
+ * @brief Libère les blocs et les repères de l'historique, qui redevient vide
+ * @param histoDepla Historique des déplacements
+ */
+void historique_liberer(t_tabDeplacement * histoDepla);
+
+/**
+ * @brief Écrit les premiers déplacements d'un historique, bloc par bloc
+ * @param t Historique contenant les déplacements
+ * @param nb Nombre de déplacements à écrire
+ * @param f Fichier ouvert en écriture
+ * @return MOTEUR_OK, MOTEUR_ERREUR_FICHIER ou MOTEUR_ERREUR_MEMOIRE
+ */
+t_Erreur historique_ecrire(const t_tabDeplacement * t, int nb, FILE * f);
+
+/**
+ * @brief Enregistre la suite de déplacements dans un fichier
+ * @param t Historique contenant les déplacements
+ * @param nb Nombre de déplacements à enregistrer
+ * @param fic Nom du fichier où sauvegarder
+ * @return MOTEUR_OK, MOTEUR_ERREUR_FICHIER ou MOTEUR_ERREUR_MEMOIRE
+ */
+t_Erreur enregistrer_deplacements(const t_tabDeplacement * t, int nb,
+    char fic[]);
+
+/**
+ * @brief Rejoue une suite de lettres de déplacement (g, d, h, b, et en
+ * majuscule pour une poussée) avec les règles du jeu, sans affichage. Les
+ * blancs et les fins de ligne sont ignorés ; le rejeu s'arrête au premier
+ * déplacement impossible ou dont la lettre ne dit pas s'il pousse une caisse
+ * @param niveau Partie fixe du niveau
+ * @param etat Position de départ, qui devient la position finale
+ * @param lettres Lettres à rejouer
+ * @param taille Nombre de lettres
+ * @param histoDepla Historique où sont rangés les déplacements rejoués
+ * @param rejeu Résultat à remplir
+ */
+void rejouer(const t_Niveau * niveau, t_Etat * etat, const char lettres[],
+    size_t taille, t_tabDeplacement * histoDepla, t_Rejeu * rejeu);
+
+/* Partie */
+
+/**
+ * @brief Prépare une partie à partir d'un plateau. Toute la mémoire de la
+ * partie est allouée ici : l'historique est réservé pour nbReserves
+ * déplacements, qui se joueront sans aucune allocation
+ * @param partie Partie à remplir (à libérer par partie_liberer)
+ * @param plateau Plateau du niveau
+ * @param nbReserves Nombre de déplacements réservés dans l'historique
+ * @return MOTEUR_OK, ou MOTEUR_ERREUR_MEMOIRE (rien à libérer)
+ */
+t_Erreur partie_ouvrir(t_Partie * partie, const t_Plateau * plateau,
+    int nbReserves);
+
+/**
+ * @brief Libère la mémoire d'une partie
+ * @param partie Partie à libérer
+ */
+void partie_liberer(t_Partie * partie);
+
+/**
+ * @brief Joue un déplacement dans une direction
+ * @param partie Partie en cours
+ * @param direction Indice de la direction (haut, bas, gauche, droite)
+ * @return true si Sokoban a bougé (false aussi si la mémoire manque pour
+ * garder le déplacement)
+ */
+bool partie_deplacer(t_Partie * partie, int direction);
+
+/**
+ * @brief Annule le dernier déplacement joué
+ * @param partie Partie en cours
+ * @return true s'il y avait un déplacement à annuler
+ */
+bool partie_annuler(t_Partie * partie);
+
+/**
+ * @brief Refait le déplacement annulé qui suit
+ * @param partie Partie en cours
+ * @return true s'il y avait un déplacement à refaire
+ */
+bool partie_refaire(t_Partie * partie);
+
+/**
+ * @brief Amène la partie à un déplacement quelconque de l'historique
+ * @param partie Partie en cours
+ * @param numero Numéro du déplacement voulu
+ */
+void partie_aller(t_Partie * partie, int numero);
+
+/**
+ * @brief Remet la partie au départ et vide son historique
+ * @param partie Partie en cours
+ */
+void partie_recommencer(t_Partie * partie);
+
+/**
+ * @brief Indique si toutes les caisses de la partie sont sur une cible
+ * @param partie Partie en cours
+ * @return true si la partie est gagnée
+ */
+bool partie_gagnee(const t_Partie * partie);
+
+/**
+ * @brief Cherche si la position courante a déjà été atteinte plus tôt dans
+ * l'historique (caisses et case de Sokoban identiques)
+ * @param partie Partie en cours
+ * @return Premier déplacement après lequel la position était la même,
+ * AUCUN_DEPLACEMENT sinon
+ */
+int partie_deja_vue(const t_Partie * partie);
+
+/**
+ * @brief Supprime la boucle qui ramène à une position déjà atteinte : la
+ * partie revient au premier déplacement où elle l'était et l'historique est
+ * coupé après lui
+ * @param partie Partie en cours
+ * @return true si une boucle a été supprimée
+ */
+bool partie_couper_boucle(t_Partie * partie);
+
+/**
+ * @brief Amène Sokoban sur une case par un plus court chemin sans pousser
+ * de caisse. Les déplacements sont joués d'un coup et rangés un à un dans
+ * l'historique
+ * @param partie Partie en cours
+ * @param ligne Ligne de la case (à partir de 0)
+ * @param colonne Colonne de la case (à partir de 0)
+ * @return Nombre de déplacements joués, AUCUN_DEPLACEMENT si la case ne peut
+ * pas être atteinte ou si la mémoire manque
+ */
+int partie_marcher_vers(t_Partie * partie, int ligne, int colonne);
+
+/**
+ * @brief Pousse une caisse jusqu'à une case avec le moins de poussées
+ * possible, les autres caisses restant en place. Sokoban marche par un plus
+ * court chemin jusque derrière la caisse avant chaque poussée ; tous les
+ * déplacements sont joués d'un coup et rangés un à un dans l'historique
+ * @param partie Partie en cours
+ * @param ligneCaisse Ligne de la caisse (à partir de 0)
+ * @param colonneCaisse Colonne de la caisse (à partir de 0)
+ * @param ligne Ligne de la case d'arrivée
+ * @param colonne Colonne de la case d'arrivée
+ * @return Nombre de déplacements joués, AUCUN_DEPLACEMENT si la caisse ne
+ * peut pas y être amenée ou si la mémoire manque (les poussées déjà jouées
+ * restent alors dans la partie)
+ */
+int partie_pousser_vers(t_Partie * partie, int ligneCaisse,
+    int colonneCaisse, int ligne, int colonne);
+
+#endif
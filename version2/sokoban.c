@@ -9,62 +9,505 @@
 * ici par un '@' doit pousser des caisses sur des cibles
 * respectivement '$' et '.' pour gagner la partie).
 *
+* Ce fichier contient le jeu en terminal, les solveurs et les modes sans
+* affichage ; les règles du jeu sont dans le moteur (moteur_sokoban.h).
+*
+* Utilisation :
+*   ./sokoban                                  jeu
+*   ./sokoban --resoudre niveau.sok [fichier]  solution optimale en poussées
+*   ./sokoban --resoudre-parallele niveau.sok nbFils [fichier]
+*                                              solution trouvée à plusieurs
+*                                              fils, pas toujours optimale
+*                                              en poussées
+*   ./sokoban --bench-parallele niveau.sok...  accélération de 1 à 16 fils
+*   ./sokoban --resoudre-disque niveau.sok repertoire budgetMio [fichier]
+*                                              recherche en largeur dont les
+*                                              couches sont gardées sur disque
+*   ./sokoban --rejouer niveau.sok deplacements.txt
+*                                              vérifie une suite de
+*                                              déplacements enregistrée
+*   ./sokoban --verifier manifeste.txt resultats.txt nbFils
+*                                              vérifie un lot de solutions
+*   ./sokoban --bench-verifier manifeste.txt   débit de 1 à 16 fils
+*   ./sokoban --bench-deplacements niveau.sok [nbCoups]
+*                                              tables de déplacement contre
+*                                              tests en cascade
+*   ./sokoban --bench niveau.sok [resultats.json|- [reference.json]]
+*                                              temps et allocations des
+*                                              fonctions du moteur, comparés
+*                                              à une mesure de référence
+*   ./sokoban --bench-zone [niveau.sok...]     zone de Sokoban par mots et
+*                                              case par case, comparées
+*   ./sokoban --bench-minorant niveau.sok...   solveur avec chacun des deux
+*                                              minorants, comparés
+*   ./sokoban --bench-etats niveau.sok [nbEtats]
+*                                              octets par état compact,
+*                                              insertion et recherche
+*   ./sokoban --bench-macros niveau.sok...     solveur sans puis avec les
+*                                              macros, comparés
+*
+* Partout où un niveau est demandé, "recueil.sok#12" désigne le 12e niveau
+* d'un recueil au format XSB.
+*
+* Compilation : gcc -O2 -pthread -o sokoban sokoban.c moteur_sokoban.c
+* (avec -DCOMPTER_ALLOCATIONS, --bench compte aussi les allocations)
+*
 */
 
+/* syscall, ioctl et les ensembles de processeurs, même avec -std=c11 */
+#define _DEFAULT_SOURCE
+
 /* Fichiers inclus */
-#include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
-#include <stdbool.h>
 #include <termios.h>
 #include <unistd.h>
-#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <sys/resource.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "moteur_sokoban.h"
 
 /* Déclaration des constantes */
-#define NB_COLONNES 12
-#define NB_LIGNES 12
-#define NB_DEPLACEMENTS_MAX 1000
-const int ZERO=0;
 const int MILLE=1000;
-const int TAILLE=12;
-const int TAILLE_FICHIER=20;
-const int ENLEVER=-1;
-const int AJOUTER=1;
-const int DOUBLE=2;
 const int INVERSE=-1;
 const int ZOOM1=1;
 const int ZOOM2=2;
 const int ZOOM3=3;
+const int ZOOM_MAX=16;
+const int LIGNES_ENTETE=24;
 const char ARRETER='x';
 const char RECOMMENCER='r';
-const char GAUCHE='q';
-const char DROITE='d';
-const char HAUT='z';
-const char BAS='s';
 const char ZOOM='+';
 const char DEZOOM='-';
 const char RETOUR='u';
+const char REFAIRE='y';
+const char SAUTER='j';
+const char ALERTE='a';
+const char COUPER='c';
+const char MARCHER='m';
+const char POUSSER='p';
 const char VALIDATION='O';
-const char SOKOBAN='@';
-const char MUR='#';
-const char RIEN=' ';
-const char CAISSE='$';
-const char CIBLE='.';
-const char SOKOBAN_GAUCHE='g';
-const char SOKOBAN_DROITE='d';
-const char SOKOBAN_HAUT='h';
-const char SOKOBAN_BAS='b';
-const char SOKOBAN_CAISSE_GAUCHE='G';
-const char SOKOBAN_CAISSE_DROITE='D';
-const char SOKOBAN_CAISSE_HAUT='H';
-const char SOKOBAN_CAISSE_BAS='B';
-const char AUCUN_DEPLACEMENT=' ';
-const char SOKOBAN_CIBLE='+';
-const char CAISSE_CIBLE='*';
-const char ATTENTE='\0';
-
-typedef char t_Plateau[NB_LIGNES][NB_COLONNES];
-typedef char t_tabDeplacement[NB_DEPLACEMENTS_MAX];
+const int DELAI_INFINI=-1;
+const int ECART_FUSION_ECRAN=8;
+const int CAPACITE_INITIALE_ECRAN=32;
+const int TAILLE_TEXTE_ECRAN=256;
+const int TAILLE_SEQUENCE_ECRAN=32;
+const char ECHAPPEMENT='\033';
+const int AUCUN_NIVEAU=-1;
+const int OCTETS_PAR_KIO=1024;
+const uint32_t AUCUN_NOEUD=UINT32_MAX;
+const int INFINI_POUSSEES=1 << 20;
+const char OPTION_RESOUDRE[]="--resoudre";
+const char OPTION_RESOUDRE_PARALLELE[]="--resoudre-parallele";
+const char OPTION_BENCH_PARALLELE[]="--bench-parallele";
+const char OPTION_REJOUER[]="--rejouer";
+const char OPTION_VERIFIER[]="--verifier";
+const char OPTION_BENCH_VERIFIER[]="--bench-verifier";
+const char OPTION_BENCH_DEPLACEMENTS[]="--bench-deplacements";
+const int NB_COUPS_BENCH=10000000;
+const char TOUCHES_BENCH[]="zsqdzsqdxru+-yja";
+const char OPTION_BENCH[]="--bench";
+const char OPTION_BENCH_ZONE[]="--bench-zone";
+const char OPTION_BENCH_MINORANT[]="--bench-minorant";
+const char OPTION_BENCH_MACROS[]="--bench-macros";
+const char OPTION_RESOUDRE_DISQUE[]="--resoudre-disque";
+const char OPTION_BENCH_ETATS[]="--bench-etats";
+const long long NB_ETATS_BENCH=10000000;
+const char SORTIE_STANDARD[]="-";
+const char FICHIER_BENCH[]="bench_deplacements.tmp";
+const int NB_REPETITIONS_BENCH=5;
+const int NB_CHARGEMENTS_BENCH=2000;
+const int NB_DEPLACEMENTS_BENCH=1000000;
+const int NB_APPELS_GAGNE_BENCH=10000000;
+const int NB_IMAGES_BENCH=20000;
+const int NB_ENREGISTREMENTS_BENCH=200;
+const int TAILLE_ENREGISTREMENT_BENCH=10000;
+const int LARGEUR_COULOIR_BENCH=1000;
+const int ZOOM_BENCH_GRAND=8;
+const double SEUIL_REGRESSION=0.20;
+const char TOUCHES_DIRECTIONS[]="zsqd";
+const char * const NOMS_MESURES[] = {"charger_partie", "deplacer_marche",
+    "deplacer_poussee", "annulation_deplacer", "gagne",
+    "afficher_plateau_zoom1", "afficher_plateau_zoom2",
+    "afficher_plateau_zoom3", "enregistrer_deplacements",
+    "afficher_plateau_zoom8"};
+const char * const NOMS_VERDICTS[] = {"RESOLU", "NON_RESOLU", "ILLEGAL",
+    "ILLISIBLE"};
+const int NB_FILS_MAX=64;
+const int BITS_TABLE_PARALLELE=22;
+const int SONDAGES_MAX_TABLE=64;
+const size_t TAILLE_BLOC_NOEUDS=1 << 20;
+const int NB_ESSAIS_VOL=4;
+const int BITS_ETATS_PAR_BLOC=16;
+const uint32_t CAPACITE_TABLE_MAX=1u << 31;
+const int NB_CAISSES_MOTIF_MAX=3;
+const int BITS_CASE_MOTIF=21;
+const uint64_t MOTIF_BLOQUANT=1ull << 63;
+const int NB_ETATS_SOUS_RECHERCHE=1024;
+const char EXTENSION_MOTIFS[]=".motifs";
+const uint64_t VERSION_MOTIFS=2;
+const int DECALAGE_VERSION_MOTIFS=48;
+const char EXTENSION_TEMPORAIRE[]=".tmp";
+const int COTE_CARTE_BENCH=64;
+const int NB_CASES_REMPLIES_BENCH=20000000;
+const int NB_SERIES_MAX=64;
+const int OCTETS_PAR_MIO=1 << 20;
+const int TAILLE_CHEMIN=4096;
+// Saisie d'un nom de fichier, bornée à TAILLE_CHEMIN - 1 caractères
+const char FORMAT_CHEMIN[]="%4095s";
+const char FORMAT_COUCHE[]="%s/sokoban_couche%d.pos";
+const char FORMAT_SERIE[]="%s/sokoban_serie%d.pos";
+const int BITS_PAR_OCTET_VARIABLE=7;
+const int SUITE_OCTET_VARIABLE=0x80;
+
+/*
+* Solveur : recherche A* dont chaque arc est une poussée de caisse. Un état
+* est l'ensemble des caisses et la zone où Sokoban peut marcher, représentée
+* par sa case de plus petit indice (case normalisée)
+*/
+typedef struct {
+    uint32_t parent;     // Noeud d'où vient la poussée
+    int32_t poussees;    // Poussées depuis le départ
+    int32_t estimation;  // Poussées + minorant des poussées restantes
+    int32_t depart;      // Case de la caisse avant la poussée
+    int32_t direction;   // Direction de la poussée
+} t_Noeud;
+
+/*
+* Ensemble d'états compacts : les caisses y sont un tableau de bits sur les
+* seules cases de sol du niveau, suivi de l'indice de sol de la case
+* normalisée de Sokoban. Les états sont rangés dans une arène de blocs qui ne
+* bougent jamais ; la table à adressage ouvert ne garde que leurs indices,
+* qui sont aussi ceux des noeuds du solveur
+*/
+typedef struct {
+    const t_Niveau * niveau;
+    int32_t * numeroSol;       // Indice de sol de chaque case (AUCUNE_CASE
+                               // pour une case où Sokoban ne va jamais)
+    int32_t * caseSol;         // Case de chaque indice de sol
+    int nbSol;
+    int octetsSok;             // Octets de l'indice de sol de Sokoban
+    int taille;                // Octets par état
+    uint8_t ** blocs;          // Arène : ETATS_PAR_BLOC états par bloc
+    uint32_t nbBlocs;
+    uint32_t capaciteBlocs;
+    uint32_t nbEtats;
+    uint32_t * table;          // Indice de l'état, AUCUN_NOEUD : place libre
+    uint32_t capaciteTable;    // Puissance de deux
+} t_EnsembleEtats;
+
+/* Minorant du nombre de poussées restantes */
+typedef enum {
+    MINORANT_PLUS_PROCHES,  // Somme des distances à la cible la plus proche
+    MINORANT_AFFECTATION    // Affectation des caisses aux cibles de coût
+                            // minimal (méthode hongroise)
+} t_Minorant;
+
+/* Réglage du solveur comparé par les bancs d'essai */
+typedef struct {
+    const char * nom;
+    t_Minorant typeMinorant;
+    bool macros;
+} t_ReglageSolveur;
+
+/*
+* Affectation des caisses (lignes) aux cibles (colonnes) : lignes et colonnes
+* sont numérotées à partir de 1, la colonne 0 sert de départ aux chemins
+* augmentants. Les potentiels restent réalisables (coût réduit >= 0) et sont
+* nuls sur les paires affectées
+*/
+typedef struct {
+    int32_t * lignes;            // Case de la caisse de chaque ligne (de 0)
+    int64_t * potentielsLignes;  // nbCaisses + 1 éléments
+    int64_t * potentielsCibles;  // nbCibles + 1 éléments
+    int32_t * ligneDeCible;      // Ligne affectée à chaque cible, 0 si libre
+    int32_t * cibleAvant;        // Colonne d'avant sur le chemin augmentant
+    int64_t * ecarts;            // Plus petit coût réduit vers chaque cible
+    bool * vues;                 // Cibles déjà dans l'arbre du chemin
+    int64_t * sauvePotentielsLignes;  // Affectation du père, recopiée avant
+    int64_t * sauvePotentielsCibles;  // de calculer celle de chaque fils
+    int32_t * sauveLigneDeCible;
+} t_Affectation;
+
+/* Entrée de la file de priorité des noeuds à développer */
+typedef struct {
+    int32_t estimation;
+    int32_t poussees;
+    uint32_t noeud;
+} t_EntreeTas;
+
+/*
+* Base de motifs bloquants d'un niveau : groupes de 2 ou 3 caisses voisines
+* dont une sous-recherche bornée a prouvé qu'elles ne peuvent pas toutes
+* atteindre une cible, où que soit Sokoban et même sans les autres caisses.
+* Un groupe a pour clé ses cases triées, BITS_CASE_MOTIF bits chacune. Les
+* groupes examinés sans preuve sont gardés aussi pour ne pas refaire leur
+* sous-recherche ; seuls les motifs bloquants sont enregistrés, dans un
+* fichier par recueil. Le solveur apprend les groupes qu'il rencontre ; le
+* jeu ne fait que consulter la base, remplie avant la partie
+*/
+typedef struct {
+    const t_Niveau * niveau;
+    uint64_t empreinteNiveau;  // Murs, cibles et dimensions du niveau, et
+                               // version des motifs
+    uint64_t * table;          // Clé | MOTIF_BLOQUANT, 0 pour une place libre
+    uint32_t capaciteTable;    // Puissance de deux
+    uint32_t nbGroupes;
+    uint32_t nbBloquants;
+    uint32_t nbLus;            // Motifs bloquants lus dans le fichier
+    long long nbSousRecherches;
+    long long nbCoupures;      // Poussées écartées par un motif
+    uint64_t * sol;            // Couches de travail : cases où Sokoban va
+    uint64_t * caisses;        // sans caisse, caisses du groupe, zone et
+    uint64_t * zone;           // zones déjà couvertes
+    uint64_t * couvertes;
+    uint64_t * clesVisites;    // Sous-recherche : caisses et case normalisée
+    int32_t * casesVisites;    // de chaque état, dans l'ordre de la file
+    uint32_t * tableVisites;   // Indice de l'état, AUCUN_NOEUD : place libre
+} t_Motifs;
+
+/* Mémoire de travail du solveur */
+typedef struct {
+    const t_Niveau * niveau;
+    int nbCaisses;
+    t_Noeud * noeuds;          // Tous les états rencontrés
+    t_EnsembleEtats etats;     // Table de transposition : état de chaque noeud
+    uint32_t nbNoeuds;
+    uint32_t capaciteNoeuds;
+    int32_t * caissesPere;     // Caisses et case du noeud développé
+    t_Motifs * motifs;         // Motifs bloquants (NULL pour s'en passer)
+    uint8_t * etatFils;        // État compact d'un fils
+    t_EntreeTas * tas;
+    uint32_t tailleTas;
+    uint32_t capaciteTas;
+    t_Minorant typeMinorant;
+    int nbCibles;
+    int * distancesPoussees;   // nbCibles * nbCases poussées (INFINI_POUSSEES
+                               // si la caisse ne peut pas atteindre la cible)
+    int minorantPere;          // Minorant du dernier appel à minorant()
+    t_Affectation affectation;
+    int * distanceCible;       // Tableaux de travail de nbCases éléments
+    int * file;
+    int * precedent;
+    uint32_t * marque;
+    uint32_t generation;
+    int tailleZone;            // Cases de la zone, au début de file
+    uint64_t * couche;         // Couches de travail : caisses, zone du
+                               // noeud et zone d'un fils
+    uint64_t * zone;
+    uint64_t * zoneFils;
+    int32_t * caissesFils;
+    bool macros;               // Poussées enchaînées dans les tunnels et
+                               // jusqu'aux cibles de la salle
+    int32_t * pereSalle;       // Parcours de la salle des cibles : état
+    int32_t * fileSalle;       // d'où vient chaque (case, direction), file
+    int32_t * ciblesSalle;     // des états et premier état sur chaque cible
+    int nbEtatsSalle;
+    long long noeudsDeveloppes;
+    long long filsMacros;      // Fils obtenus par une macro
+} t_Solveur;
+
+/*
+* Solveur parallèle : recherche en profondeur d'abord, la meilleure poussée
+* en premier. Chaque fil a sa pile de noeuds (deque) ; un fil sans travail
+* en vole le plus ancien noeud chez un autre. Les états déjà vus sont
+* marqués dans une table partagée sans verrou qui garde l'adresse de leur
+* noeud : deux états de même empreinte sont comparés en entier. La première
+* solution trouvée est gardée, elle n'a pas toujours le moins de poussées
+*/
+typedef struct t_NoeudParallele {
+    struct t_NoeudParallele * parent;
+    int32_t poussees;
+    int32_t caseSok;
+    int32_t depart;
+    int32_t direction;
+    int32_t estimation;
+    uint64_t empreinte;    // Empreinte de Zobrist des caisses
+    int32_t caisses[];     // nbCaisses cases triées
+} t_NoeudParallele;
+
+/* Bloc de mémoire où un fil range ses noeuds ; un noeud ne bouge jamais */
+typedef struct t_BlocNoeuds {
+    struct t_BlocNoeuds * suivant;
+    size_t utilise;
+    char octets[];
+} t_BlocNoeuds;
+
+/* Pile de travail d'un fil : il travaille en bas et se fait voler en haut */
+typedef struct {
+    t_NoeudParallele ** elements;
+    int haut;
+    int bas;
+    int capacite;
+    pthread_mutex_t verrou;
+} t_Deque;
+
+struct t_RecherchePartagee;
+
+/* Un fil de la recherche parallèle */
+typedef struct {
+    pthread_t fil;
+    int numero;
+    t_Solveur * outils;    // Parcours de zone et distances, propres au fil
+    t_Deque deque;
+    t_BlocNoeuds * blocs;
+    t_NoeudParallele ** fils;  // Fils du noeud en cours de développement
+    long long noeudsDeveloppes;
+    long long noeudsCrees;
+    unsigned int graine;
+    struct t_RecherchePartagee * partage;
+} t_Ouvrier;
+
+/* Données communes à tous les fils */
+typedef struct t_RecherchePartagee {
+    const t_Niveau * niveau;
+    int nbCaisses;
+    int nbOuvriers;
+    t_Ouvrier * ouvriers;
+    _Atomic(t_NoeudParallele *) * table;
+    uint64_t masqueTable;
+    atomic_long enCours;   // Noeuds en attente ou en cours de développement
+    atomic_bool fini;
+    _Atomic(t_NoeudParallele *) but;
+} t_RecherchePartagee;
+
+/* Résultat d'une résolution */
+typedef struct {
+    t_tabDeplacement deplacements;  // Lettres de enregistrer_deplacements
+    int nbDeplacements;
+    int nbPoussees;
+    long long noeudsDeveloppes;
+    long long noeudsCrees;
+    long long filsMacros;      // Fils obtenus par une macro (tunnel ou salle)
+    size_t memoireRecherche;   // Octets occupés par les structures du solveur
+    int octetsEtat;            // Octets d'un état compact (0 sans ensemble)
+    size_t memoireEtats;       // Octets des états, de la table et des noeuds
+    long memoireMaxKio;        // Pic de mémoire du processus
+    long long dureeUs;
+} t_Solution;
+
+/*
+* Fichier de positions triées (caisses triées puis case normalisée de
+* Sokoban). Chaque position n'y garde que ses entiers à partir du premier qui
+* diffère de la précédente, en entiers de longueur variable : 7 bits par
+* octet, le bit de poids fort annonçant un octet de plus
+*/
+typedef struct {
+    FILE * fichier;
+    int taille;                // Entiers par position
+    int32_t * courante;        // Dernière position lue ou écrite
+    bool valide;               // En lecture : courante vient du fichier
+    long long nbPositions;
+    long long octets;          // Octets lus ou écrits
+} t_FichierPositions;
+
+/*
+* Recherche en largeur sur disque : la couche k contient les positions à k
+* poussées du départ. Les fils d'une couche sont triés par séries qui tiennent
+* dans le budget de mémoire, puis fusionnés en retirant les positions des
+* couches précédentes
+*/
+typedef struct {
+    t_Solveur * outils;        // Mémoire de travail pour développer
+    const char * repertoire;
+    int taille;                // Entiers par position
+    int32_t * tampon;          // Fils en attente d'être triés
+    int32_t * tri;             // Tampon du tri par fusion
+    size_t capacite;           // Positions du tampon
+    size_t nbTampon;
+    int32_t * fils;            // Fils d'une position et leurs poussées
+    int32_t * departsFils;
+    int32_t * directionsFils;
+    int * series;              // Numéros des séries de la couche en cours
+    int nbSeries;
+    int numeroSerie;           // Prochain numéro de série libre
+    long long octetsEcrits;    // Totaux de la couche en cours
+    long long octetsLus;
+} t_RechercheDisque;
+
+/* Verdict d'une ligne du manifeste de vérification */
+typedef enum {
+    VERIFIE_RESOLU,
+    VERIFIE_NON_RESOLU,
+    VERIFIE_ILLEGAL,
+    VERIFIE_ILLISIBLE      // Niveau ou déplacements impossibles à charger
+} t_Verdict;
+
+/* Une ligne du manifeste : un niveau et les déplacements à vérifier */
+typedef struct {
+    char * niveau;
+    char * deplacements;
+    int numNiveau;         // Niveau chargé, AUCUN_NIVEAU s'il est illisible
+    t_Verdict verdict;
+    t_Rejeu rejeu;
+    long long dureeUs;     // Lecture des déplacements comprise
+} t_Verification;
+
+/* Travail partagé par les fils de vérification */
+typedef struct {
+    t_Verification * verifications;
+    int nbVerifications;
+    t_Niveau * niveaux;    // Chaque niveau distinct n'est chargé qu'une fois
+    t_Etat * departs;
+    atomic_int prochaine;      // Prochaine ligne à prendre
+} t_LotVerification;
+
+/* Une ligne de texte affichée à l'écran */
+typedef struct {
+    char * texte;
+    int longueur;
+    int capacite;
+} t_LigneEcran;
+
+/*
+* Double tampon de l'écran : l'image précédente est gardée pour n'envoyer au
+* terminal que les cellules qui ont changé
+*/
+typedef struct {
+    t_LigneEcran * precedentes;
+    t_LigneEcran * courantes;
+    int nbPrecedentes;
+    int nbCourantes;
+    int capaciteLignes;
+    char * sortie;
+    size_t tailleSortie;
+    size_t capaciteSortie;
+    bool valide;
+    char * glyphes;        // Chaque caractère répété ZOOM_MAX fois
+    int nbLignesTerminal;  // Taille du terminal, relue après un SIGWINCH
+    int nbColonnesTerminal;
+    bool deborde;          // La dernière image a été coupée au terminal
+} t_Ecran;
+
+/* Mesures du banc d'essai, dans l'ordre de NOMS_MESURES */
+typedef enum {
+    MESURE_CHARGER,
+    MESURE_MARCHE,
+    MESURE_POUSSEE,
+    MESURE_ANNULATION,
+    MESURE_GAGNE,
+    MESURE_ZOOM1,
+    MESURE_ZOOM2,
+    MESURE_ZOOM3,
+    MESURE_ENREGISTRER,
+    MESURE_ZOOM8,
+    NB_MESURES
+} t_NumMesure;
+
+/* Résultat d'une mesure du banc d'essai (meilleure des répétitions) */
+typedef struct {
+    const char * nom;
+    long long nbOperations;
+    long long dureeUs;
+    long long nbAllocations;
+} t_Mesure;
 
 /*
 * Tout au long du programme les lignes pourront être suivies d'un retour à la
@@ -76,1026 +519,5294 @@ typedef char t_tabDeplacement[NB_DEPLACEMENTS_MAX];
 /**
  * @brief Procédure qui fait tourner le jeu principal
  * @param toucheAppuyee Adresse de la touche appuyée par le joueur
- * @param plateau Plateau du jeu
+ * @param partie Partie en cours
  * @param fichier Nom du fichier contenant la partie
- * @param ligSok Ligne où se trouve Sokoban
- * @param colSok Colonne où se trouve Sokoban
- * @param nbDepla Nombre de déplacements déjà effectués
  * @param zoom Niveau de zoom choisi
- * @param histoDepla Historique des déplacements
+ * @param ecran Écran sur lequel est dessinée la partie
+ * @param motifs Motifs bloquants connus du niveau, consultés à chaque poussée
  */
-void jeu(char * toucheAppuyee, t_Plateau plateau, char fichier[], int ligSok,
-    int colSok, int * nbDepla, int zoom, t_tabDeplacement histoDepla);
+void jeu(char * toucheAppuyee, t_Partie * partie, char fichier[], int zoom,
+    t_Ecran * ecran, t_Motifs * motifs);
 
 /**
  * @brief Affiche le plateau selon le niveau de zoom
  * @param plateau Plateau du jeu
  * @param zoom Niveau de zoom choisi
+ * @param ecran Écran sur lequel dessiner le plateau
  */
-void afficher_plateau(t_Plateau plateau, int zoom);
+void afficher_plateau(const t_Plateau * plateau, int zoom, t_Ecran * ecran);
 
 /**
- * @brief Charge un plateau à partir d'un fichier
- * @param plateau Plateau du jeu à remplir
- * @param fichier Nom du fichier source
+ * @brief Affiche l'en-tête du jeu avec les informations essentielles
+ * @param nbDepla Nombre de déplacements effectués
+ * @param nomFich Nom du fichier de la partie
+ * @param blocage true pour avertir que la partie ne peut plus être gagnée
+ * @param dejaVu Déplacement après lequel la position actuelle était déjà
+ * atteinte, AUCUN_DEPLACEMENT sinon
+ * @param ecran Écran sur lequel dessiner l'en-tête
  */
-void charger_partie(t_Plateau plateau, char fichier[]);
+void affichier_entete(int nbDepla, char nomFich[], bool blocage, int dejaVu,
+    t_Ecran * ecran);
 
 /**
- * @brief Enregistre un plateau dans un fichier
- * @param plateau Plateau à sauvegarder
- * @param fichier Nom du fichier de destination
+ * @brief Permet de recommencer la partie depuis la position de départ,
+ * gardée en mémoire : le fichier n'est pas relu
+ * @param partie Partie en cours
  */
-void enregistrer_partie(t_Plateau plateau, char fichier[]);
+void recommencer(t_Partie * partie);
 
 /**
- * @brief Affiche l'en-tête du jeu avec les informations essentielles
- * @param nbDepla Nombre de déplacements effectués
- * @param nomFich Nom du fichier de la partie
+ * @brief Procédure permettant d'abandonner la partie
+ * @param plateauDeJeu Plateau actuel du joueur
  */
-void affichier_entete(int nbDepla, char nomFich[]);
+void abandon(const t_Plateau * plateauDeJeu);
 
 /**
- * @brief Regroupe les déplacements possibles et les applique
- * @param plateau Plateau du jeu
- * @param ligSok Coordonnée ligne de Sokoban
- * @param colSok Coordonnée colonne de Sokoban
- * @param deplacement Touche correspondant au mouvement
- * @param nbDepla Nombre de déplacements effectués
- * @param histoDepla Historique des déplacements
+ * @brief Demande au joueur le déplacement où aller et y amène la partie
+ * @param partie Partie en cours
  */
-void deplacer(t_Plateau plateau, int * ligSok, int * colSok, char deplacement,
-    int * nbDepla, t_tabDeplacement histoDepla);
+void sauter(t_Partie * partie);
 
 /**
- * @brief Déplace Sokoban en modifiant ses coordonnées
- * @param nvLig Variation de ligne
- * @param nvCol Variation de colonne
- * @param ligSok Adresse de la ligne de Sokoban
- * @param colSok Adresse de la colonne de Sokoban
- * @param nbDepla Adresse du compteur de déplacements
+ * @brief Demande au joueur une case et y amène Sokoban par un plus court
+ * chemin, affiché une seule fois à l'arrivée
+ * @param partie Partie en cours
  */
-void deplacement_sokoban(int nvLig, int nvCol, int * ligSok,
-    int * colSok, int * nbDepla);
+void marcher(t_Partie * partie);
 
 /**
- * @brief Permet de recommencer la partie depuis le fichier original
- * @param nbDepla Adresse du compteur de déplacements
- * @param plateauDeJeu Plateau du jeu
- * @param nomFichier Nom du fichier chargé
- * @param ligneSokoban Adresse de la ligne de Sokoban
- * @param colonneSokoban Adresse de la colonne de Sokoban
- * @param histoDepla Historique des déplacements
+ * @brief Demande au joueur une caisse et une case, puis pousse la caisse
+ * jusqu'à la case avec le moins de poussées possible
+ * @param partie Partie en cours
  */
-void recommencer(int * nbDepla, t_Plateau plateauDeJeu, char nomFichier[],
-    int * ligneSokoban, int * colonneSokoban, t_tabDeplacement histoDepla);
+void pousser(t_Partie * partie);
 
 /**
- * @brief Procédure permettant d'abandonner la partie
- * @param plateauDeJeu Plateau actuel du joueur
+ * @brief Donne le plus grand zoom possible : celui où le plateau tient dans
+ * le terminal, au moins ZOOM3 et au plus ZOOM_MAX
+ * @param nbLignes Nombre de lignes du plateau
+ * @param nbColonnes Nombre de colonnes du plateau
+ * @return Zoom maximal
  */
-void abandon(t_Plateau plateauDeJeu);
+int zoom_maximum(int nbLignes, int nbColonnes);
 
 /**
- * @brief Déplacement simple de Sokoban si aucune case spéciale n'est présente
- * @param plateau Plateau du jeu
- * @param ligSok Adresse de la ligne de Sokoban
- * @param colSok Adresse de la colonne de Sokoban
- * @param incrLigSok Incrément de ligne
- * @param incrColSok Incrément de colonne
- * @param nbDepla Adresse du nombre de déplacements
- * @param histoDepla Historique des déplacements
- * @param deplacement Caractère représentant le mouvement
+ * @brief Demande si l'utilisateur veut enregistrer la partie puis l'enregistre
+ * @param t Historique contenant les déplacements
+ * @param nb Nombre de déplacements à enregistrer
+*/
+void enregistrement_deplacements(const t_tabDeplacement * t, int nb);
+
+/**
+ * @brief Passe le terminal en mode brut (sans écho ni tampon de ligne)
+ *
+ * Le réglage d'origine est sauvegardé au premier appel puis restauré
+ * automatiquement à la sortie du programme ou à la réception d'un signal.
  */
-void deplacement_rien(t_Plateau plateau, int * ligSok, int * colSok,
-    int incrLigSok, int incrColSok, int * nbDepla,
-    t_tabDeplacement histoDepla, char deplacement);
+void terminal_mode_brut();
 
 /**
- * @brief Gère le déplacement d'une caisse devant Sokoban
- * @param plateau Plateau du jeu
- * @param ligSok Adresse de la ligne de Sokoban
- * @param colSok Adresse de la colonne de Sokoban
- * @param incrLigSok Incrément de ligne
- * @param incrColSok Incrément de colonne
- * @param doubleIncrLigSok Double incrément de ligne
- * @param doubleIncrColSok Double incrément de colonne
- * @param nbDepla Adresse du nombre de déplacements
- * @param histoDepla Historique des déplacements
- * @param deplacement Caractère représentant le mouvement
- */
-void deplacement_caisse(t_Plateau plateau, int * ligSok, int * colSok,
-    int incrLigSok, int incrColSok, int doubleIncrLigSok,
-    int doubleIncrColSok, int * nbDepla,
-    t_tabDeplacement histoDepla, char deplacement);
-
-/**
- * @brief Gère le déplacement d'une caisse vers une cible
- * @param plateau Plateau du jeu
- * @param ligSok Adresse de la ligne de Sokoban
- * @param colSok Adresse de la colonne de Sokoban
- * @param incrLigSok Incrément de ligne
- * @param incrColSok Incrément de colonne
- * @param doubleIncrLigSok Double incrément de ligne
- * @param doubleIncrColSok Double incrément de colonne
- * @param nbDepla Adresse du nombre de déplacements
- * @param histoDepla Historique des déplacements
- * @param deplacement Caractère représentant le mouvement
- */
-void deplacement_caisse_cible(t_Plateau plateau, int * ligSok, int * colSok,
-    int incrLigSok, int incrColSok, int doubleIncrLigSok, int doubleIncrColSok,
-    int * nbDepla, t_tabDeplacement histoDepla, char deplacement);
-
-/**
- * @brief Déplace Sokoban sur une case cible
- * @param plateau Plateau du jeu
- * @param ligSok Adresse de la ligne de Sokoban
- * @param colSok Adresse de la colonne de Sokoban
- * @param incrLigSok Incrément de ligne
- * @param incrColSok Incrément de colonne
- * @param nbDepla Adresse du nombre de déplacements
- * @param histoDepla Historique des déplacements
- * @param deplacement Caractère représentant le mouvement
+ * @brief Remet le terminal dans le mode sauvegardé par terminal_mode_brut()
  */
-void deplacement_cible(t_Plateau plateau, int * ligSok, int * colSok,
-    int incrLigSok, int incrColSok, int * nbDepla,
-    t_tabDeplacement histoDepla, char deplacement);
+void terminal_restaurer();
 
 /**
- * @brief Annule le dernier déplacement, déduit de l'historique
- * @param plateau Plateau du jeu
- * @param ligSok Adresse de la ligne de Sokoban
- * @param colSok Adresse de la colonne de Sokoban
- * @param nbDepla Adresse du nombre de déplacements
- * @param histoDepla Historique des déplacements
+ * @brief Attend qu'une touche soit appuyée sans consommer de processeur
+ * @param delaiMs Délai maximal d'attente en millisecondes (DELAI_INFINI pour
+ * attendre indéfiniment)
+ * @return La touche lue, ATTENTE si le délai est écoulé ou si le terminal a
+ * changé de taille, ARRETER si l'entrée standard est fermée
  */
-void anuulation_deplacer(t_Plateau plateau, int * ligSok, int * colSok,
-    int * nbDepla, t_tabDeplacement histoDepla);
+char attendre_touche(int delaiMs);
 
 /**
- * @brief Annule le dernier déplacement effectué en fonction de l'historique
- * @param plateau Plateau du jeu
- * @param ligSok Adresse de la ligne actuelle de Sokoban
- * @param colSok Adresse de la colonne actuelle de Sokoban
- * @param nbDepla Adresse du compteur de déplacements
- * @param histoDepla Historique des déplacements
+ * @brief Prépare un écran vide, dont la première image sera dessinée en
+ * entier, et fait suivre les changements de taille du terminal
+ * @param ecran Écran à initialiser
  */
-void annulation_deplacer(t_Plateau plateau, int * ligSok, int * colSok,
-    int * nbDepla, t_tabDeplacement histoDepla);
+void ecran_initialiser(t_Ecran * ecran);
 
 /**
- * @brief Annule un déplacement simple sans caisse
- * @param plateau Plateau du jeu
- * @param ligSok Adresse de la ligne de Sokoban
- * @param colSok Adresse de la colonne de Sokoban
- * @param incrLigSok Incrément inverse de ligne
- * @param incrColSok Incrément inverse de colonne
- * @param nbDepla Adresse du compteur de déplacements
- * @param histoDepla Historique des déplacements
+ * @brief Libère la mémoire occupée par un écran
+ * @param ecran Écran à libérer
  */
-void annule_deplacement_rien(t_Plateau plateau, int * ligSok, int * colSok,
-    int incrLigSok, int incrColSok, int * nbDepla,
-    t_tabDeplacement histoDepla);
+void ecran_liberer(t_Ecran * ecran);
 
 /**
- * @brief Annule un déplacement où une caisse avait été poussée
- * @param plateau Plateau du jeu
- * @param ligSok Adresse de la ligne de Sokoban
- * @param colSok Adresse de la colonne de Sokoban
- * @param incrLigSok Incrément inverse de ligne
- * @param incrColSok Incrément inverse de colonne
- * @param nbDepla Adresse du compteur de déplacements
- * @param histoDepla Historique des déplacements
+ * @brief Commence une nouvelle image dans le tampon courant
+ * @param ecran Écran à remplir
  */
-void annule_deplacement_caisse(t_Plateau plateau, int * ligSok, int * colSok,
-    int incrLigSok, int incrColSok, int * nbDepla,
-    t_tabDeplacement histoDepla);
+void ecran_commencer(t_Ecran * ecran);
 
 /**
- * @brief Annule un déplacement où une caisse sur cible avait été poussée
- * @param plateau Plateau du jeu
- * @param ligSok Adresse de la ligne de Sokoban
- * @param colSok Adresse de la colonne de Sokoban
- * @param incrLigSok Incrément inverse de ligne
- * @param incrColSok Incrément inverse de colonne
- * @param nbDepla Adresse du compteur de déplacements
- * @param histoDepla Historique des déplacements
+ * @brief Ajoute des caractères à la ligne en cours de l'image
+ * @param ecran Écran à remplir
+ * @param octets Caractères à ajouter
+ * @param nbOctets Nombre de caractères à ajouter
  */
-void annule_deplacement_caisse_cible(t_Plateau plateau, int * ligSok,
-    int * colSok, int incrLigSok, int incrColSok, int * nbDepla,
-    t_tabDeplacement histoDepla);
+void ecran_ajouter(t_Ecran * ecran, const char octets[], int nbOctets);
 
 /**
- * @brief Annule un déplacement où Sokoban s'était déplacé sur une cible
- * @param plateau Plateau du jeu
- * @param ligSok Adresse de la ligne de Sokoban
- * @param colSok Adresse de la colonne de Sokoban
- * @param incrLigSok Incrément inverse de ligne
- * @param incrColSok Incrément inverse de colonne
- * @param nbDepla Adresse du compteur de déplacements
- * @param histoDepla Historique des déplacements
+ * @brief Allonge la ligne en cours de l'image et donne la place ajoutée, à
+ * remplir par l'appelant
+ * @param ecran Écran à remplir
+ * @param nbOctets Nombre de caractères ajoutés à la ligne
+ * @param marge Octets de plus qui peuvent être écrits après la place
+ * ajoutée sans faire partie de la ligne
+ * @return Adresse où écrire les nbOctets caractères
  */
-void annule_deplacement_cible(t_Plateau plateau, int * ligSok, int * colSok,
-    int incrLigSok, int incrColSok, int * nbDepla,
-    t_tabDeplacement histoDepla);
+char * ecran_etendre(t_Ecran * ecran, int nbOctets, int marge);
 
 /**
- * @brief Modifie les coordonnées de Sokoban lors d'une annulation
- * @param nvLig Variation inverse de ligne
- * @param nvCol Variation inverse de colonne
- * @param ligSok Adresse de la ligne actuelle de Sokoban
- * @param colSok Adresse de la colonne actuelle de Sokoban
- * @param nbDepla Adresse du compteur de déplacements
+ * @brief Termine la ligne en cours de l'image
+ * @param ecran Écran à remplir
  */
-void annulation_deplacement_sokoban(int nvLig, int nvCol, int * ligSok,
-    int * colSok, int * nbDepla);
+void ecran_fin_ligne(t_Ecran * ecran);
 
 /**
- * @brief Affiche une ligne du plateau en zoom 1
- * @param plateau Plateau du jeu
- * @param zoom Niveau de zoom (1)
- * @param ligne Numéro de la ligne à afficher
+ * @brief Ajoute du texte formaté comme printf ; chaque '\n' termine une ligne
+ * @param ecran Écran à remplir
+ * @param format Format du texte, comme pour printf
  */
-void plateaux1(t_Plateau plateau, int zoom, int ligne);
+void ecran_printf(t_Ecran * ecran, const char format[], ...);
 
 /**
- * @brief Affiche une ligne du plateau en zoom 2 ou 3
- * @param plateau Plateau du jeu
- * @param zoom Niveau de zoom (2 ou 3)
- * @param ligne Numéro de la ligne à afficher
+ * @brief Envoie au terminal, en un seul write(), les différences entre
+ * l'image courante et la précédente. L'image est coupée à la taille du
+ * terminal, et redessinée en entier quand cette taille change
+ * @param ecran Écran à afficher
  */
-void plateaux2_3(t_Plateau plateau, int zoom, int ligne);
+void ecran_envoyer(t_Ecran * ecran);
 
 /**
- * @brief Initialise l'historique des déplacements
- * @param histoDepla Tableau des déplacements à réinitialiser
+ * @brief Oblige la prochaine image à être redessinée en entier (à appeler
+ * quand du texte a été écrit en dehors de l'écran)
+ * @param ecran Écran à invalider
  */
-void initialiser_historique_deplacement(t_tabDeplacement histoDepla);
+void ecran_invalider(t_Ecran * ecran);
 
 /**
- * @brief Ajoute un déplacement simple à l'historique
- * @param histoDepla Tableau contenant l'historique des déplacements
- * @param dernierDepla Caractère représentant le déplacement effectué
- * @param nbDepla Index auquel ajouter ce déplacement
+ * @brief Mode sans affichage : résout un niveau et écrit la solution. Pour
+ * un niveau de recueil ("recueil.sok#12"), les motifs bloquants appris sont
+ * gardés dans le fichier de motifs du recueil
+ * @param fichier Fichier du niveau
+ * @param fichierSolution Fichier où écrire la solution (NULL pour l'écran)
+ * @return EXIT_SUCCESS si une solution a été trouvée
  */
-void ajout_deplacement(t_tabDeplacement histoDepla, char dernierDepla,
-    int nbDepla);
+int mode_resoudre(char fichier[], char fichierSolution[]);
 
 /**
- * @brief Modifie un déplacement pour indiquer qu'une caisse a été poussée
- * @param dernierDepla Adresse du déplacement à transformer
+ * @brief Cherche une solution avec le moins de poussées possible
+ * @param niveau Partie fixe du niveau
+ * @param depart Position de départ
+ * @param typeMinorant Minorant des poussées restantes qui guide la recherche
+ * (l'affectation n'est possible que s'il y a au moins autant de cibles que
+ * de caisses)
+ * @param motifs Motifs bloquants à utiliser et compléter (NULL pour s'en
+ * passer)
+ * @param macros true pour pousser une caisse d'un seul coup à travers un
+ * tunnel, ou de l'entrée de la salle des cibles jusqu'à une cible
+ * @param solution Solution trouvée et statistiques de la recherche
+ * @return true si le niveau a une solution
  */
-void ajout_deplacement_caisse(char * dernierDepla);
+bool resoudre(const t_Niveau * niveau, const t_Etat * depart,
+    t_Minorant typeMinorant, t_Motifs * motifs, bool macros,
+    t_Solution * solution);
 
 /**
- * @brief Remplace le dernier déplacement de l'historique par un caractère vide
- * @param histoDepla Historique des déplacements
- * @param nbDepla Index du déplacement à annuler
+ * @brief Mode sans affichage : vérifie un fichier de déplacements enregistré
+ * par enregistrer_deplacements
+ * @param fichier Fichier du niveau
+ * @param fichierDeplacements Fichier des déplacements
+ * @return EXIT_SUCCESS si les déplacements sont légaux et gagnent la partie
  */
-void annulation_deplacement(t_tabDeplacement histoDepla, int nbDepla);
+int mode_rejouer(char fichier[], char fichierDeplacements[]);
 
 /**
- * @brief Enregistre la suite de déplacements dans un fichier
- * @param t Tableau contenant les déplacements
- * @param nb Nombre de déplacements à enregistrer
- * @param fic Nom du fichier où sauvegarder
+ * @brief Lit un manifeste de vérification : une ligne par solution, avec le
+ * niveau puis le fichier de déplacements séparés par des blancs. Les lignes
+ * vides sont ignorées. Charge une seule fois chaque niveau distinct
+ * @param fichier Nom du manifeste
+ * @param lot Lot à remplir (à libérer par lot_verification_liberer)
+ * @param texte Adresse où ranger le texte du manifeste, dans lequel pointent
+ * les noms de fichiers
+ * @param nbNiveaux Adresse où ranger le nombre de niveaux distincts
  */
-void enregistrer_deplacements(t_tabDeplacement t, int nb, char fic[]);
+void lot_verification_lire(const char fichier[], t_LotVerification * lot,
+    char ** texte, int * nbNiveaux);
 
+/**
+ * @brief Libère un lot lu par lot_verification_lire
+ * @param lot Lot à libérer
+ * @param texte Texte du manifeste
+ * @param nbNiveaux Nombre de niveaux distincts
+ */
+void lot_verification_liberer(t_LotVerification * lot, char * texte,
+    int nbNiveaux);
 
 /**
- * @brief Demande si l'utilisateur veut enregistrer la partie puis l'enregistre
- * @param t Tableau contenant les déplacements
- * @param nb Nombre de déplacements à enregistrer
- * @param fic Nom du fichier où sauvegarder
-*/
-void enregistrement_deplacements(t_tabDeplacement t, int nb);
+ * @brief Vérifie toutes les lignes d'un lot avec un ensemble de fils qui se
+ * partagent les lignes au fur et à mesure
+ * @param lot Lot à vérifier
+ * @param nbFils Nombre de fils
+ * @return Durée de la vérification en microsecondes
+ */
+long long verifier_lot(t_LotVerification * lot, int nbFils);
+
+/**
+ * @brief Mode sans affichage : vérifie les solutions d'un manifeste et écrit
+ * le verdict et la durée de chacune dans un fichier de résultats
+ * @param manifeste Fichier du manifeste
+ * @param fichierResultats Fichier des résultats
+ * @param nbFils Nombre de fils
+ * @return EXIT_SUCCESS si toutes les solutions sont légales et gagnantes
+ */
+int mode_verifier(char manifeste[], char fichierResultats[], int nbFils);
+
+/**
+ * @brief Mode sans affichage : mesure le débit de la vérification d'un
+ * manifeste de 1 à 16 fils
+ * @param manifeste Fichier du manifeste
+ * @return EXIT_SUCCESS
+ */
+int mode_bench_verifier(char manifeste[]);
+
+/**
+ * @brief Mode sans affichage : compare le temps et les erreurs de prédiction
+ * de branchement des tables de déplacement du moteur avec les tests en
+ * cascade qu'elles remplacent, sur des touches et des déplacements au hasard
+ * @param fichier Fichier du niveau
+ * @param nbCoups Nombre de touches et de déplacements par mesure
+ * @return EXIT_SUCCESS si les deux versions arrivent à la même position
+ */
+int mode_bench_deplacements(char fichier[], int nbCoups);
+
+/**
+ * @brief Mode sans affichage : mesure le temps et le nombre d'allocations par
+ * opération des fonctions du moteur et de l'affichage, les écrit en JSON et
+ * les compare à une mesure de référence écrite de la même façon
+ * @param fichier Fichier du niveau
+ * @param fichierResultats Fichier JSON à écrire ("-" pour l'écran, NULL pour
+ * ne rien écrire)
+ * @param fichierReference Fichier JSON d'une mesure précédente (ou NULL)
+ * @return EXIT_FAILURE si une mesure est plus lente que la référence de plus
+ * de SEUIL_REGRESSION ou alloue plus
+ */
+int mode_bench(char fichier[], char fichierResultats[],
+    char fichierReference[]);
+
+/**
+ * @brief Mode sans affichage : résout un niveau avec plusieurs fils. La
+ * solution n'a pas toujours le moins de poussées possible
+ * @param fichier Fichier du niveau
+ * @param nbFils Nombre de fils de recherche
+ * @param fichierSolution Fichier où écrire la solution (NULL pour l'écran)
+ * @return EXIT_SUCCESS si une solution a été trouvée
+ */
+int mode_resoudre_parallele(char fichier[], int nbFils,
+    char fichierSolution[]);
+
+/**
+ * @brief Mesure l'accélération du solveur parallèle de 1 à 16 fils
+ * @param nbFichiers Nombre de niveaux
+ * @param fichiers Fichiers des niveaux
+ * @return EXIT_SUCCESS si tous les niveaux ont été résolus
+ */
+int mode_bench_parallele(int nbFichiers, char * fichiers[]);
+
+/**
+ * @brief Mode sans affichage : compare le remplissage par mots de la zone de
+ * Sokoban (zone_remplir) au parcours en largeur case par case du solveur,
+ * sur des niveaux et sur des cartes de 64 x 64 construites pour la mesure
+ * @param nbFichiers Nombre de niveaux
+ * @param fichiers Fichiers des niveaux
+ * @return EXIT_SUCCESS si les deux méthodes donnent partout la même zone
+ */
+int mode_bench_zone(int nbFichiers, char * fichiers[]);
+
+/**
+ * @brief Mode sans affichage : résout des niveaux avec chacun des deux
+ * minorants et compare les noeuds développés et les durées
+ * @param nbFichiers Nombre de niveaux
+ * @param fichiers Fichiers des niveaux
+ * @return EXIT_SUCCESS si les deux minorants trouvent partout une solution
+ * avec le même nombre de poussées
+ */
+int mode_bench_minorant(int nbFichiers, char * fichiers[]);
+
+/**
+ * @brief Mode sans affichage : résout des niveaux sans puis avec les macros
+ * (tunnels et salle des cibles) et compare les noeuds développés, les fils
+ * obtenus par une macro et les durées
+ * @param nbFichiers Nombre de niveaux
+ * @param fichiers Fichiers des niveaux
+ * @return EXIT_SUCCESS si les deux recherches trouvent partout une solution
+ * avec le même nombre de poussées
+ */
+int mode_bench_macros(int nbFichiers, char * fichiers[]);
+
+/**
+ * @brief Cherche une solution avec plusieurs fils (sans garantie d'optimalité)
+ * @param niveau Partie fixe du niveau
+ * @param depart Position de départ
+ * @param nbFils Nombre de fils de recherche
+ * @param solution Solution trouvée et statistiques de la recherche
+ * @return true si le niveau a une solution
+ */
+bool resoudre_parallele(const t_Niveau * niveau, const t_Etat * depart,
+    int nbFils, t_Solution * solution);
+
+/**
+ * @brief Mode sans affichage : remplit un ensemble d'états compacts avec des
+ * positions tirées au hasard sur le sol d'un niveau, puis les y recherche ;
+ * donne les octets par état et les durées d'insertion et de recherche
+ * @param fichier Fichier du niveau (son sol et son nombre de caisses)
+ * @param nbEtats Nombre de positions tirées
+ * @return EXIT_SUCCESS si toutes les positions sont retrouvées
+ */
+int mode_bench_etats(char fichier[], long long nbEtats);
+
+/**
+ * @brief Mode sans affichage : résout un niveau par une recherche en largeur
+ * dont les couches sont gardées sur disque, et donne les octets écrits et lus
+ * pour chaque couche
+ * @param fichier Fichier du niveau
+ * @param repertoire Répertoire des fichiers temporaires
+ * @param budgetMio Mémoire en Mio réservée aux positions en attente de tri
+ * @param fichierSolution Fichier où écrire la solution (NULL pour l'écran)
+ * @return EXIT_SUCCESS si une solution a été trouvée
+ */
+int mode_resoudre_disque(char fichier[], char repertoire[], int budgetMio,
+    char fichierSolution[]);
+
+/**
+ * @brief Cherche une solution avec le moins de poussées possible par une
+ * recherche en largeur dont les couches sont écrites sur disque, triées et
+ * compressées ; seules les positions en attente de tri restent en mémoire
+ * @param niveau Partie fixe du niveau
+ * @param depart Position de départ
+ * @param repertoire Répertoire des fichiers temporaires (effacés à la fin)
+ * @param budgetOctets Mémoire réservée aux positions en attente de tri
+ * @param solution Solution trouvée et statistiques de la recherche
+ * @return true si le niveau a une solution
+ */
+bool resoudre_disque(const t_Niveau * niveau, const t_Etat * depart,
+    const char repertoire[], long long budgetOctets, t_Solution * solution);
+
+/**
+ * @brief Marque les cases où Sokoban peut aller sans pousser de caisse
+ * @param solveur Solveur dont on utilise la mémoire de travail
+ * @param caisses Couche des caisses
+ * @param caseSok Case de départ de Sokoban
+ * @param precedent Direction utilisée pour atteindre chaque case (ou NULL)
+ * @return Case de plus petit indice de la zone (case normalisée)
+ */
+int zone_accessible(t_Solveur * solveur, const uint64_t caisses[],
+    int caseSok, int precedent[]);
+
+/**
+ * @brief Prépare une base de motifs vide pour un niveau
+ * @param motifs Base à préparer
+ * @param niveau Partie fixe du niveau
+ * @param depart Position de départ (pour trouver les cases de sol)
+ */
+void motifs_preparer(t_Motifs * motifs, const t_Niveau * niveau,
+    const t_Etat * depart);
+
+/**
+ * @brief Libère une base de motifs
+ * @param motifs Base préparée par motifs_preparer()
+ */
+void motifs_liberer(t_Motifs * motifs);
+
+/**
+ * @brief Lit les motifs bloquants du niveau dans le fichier de son recueil
+ * (un fichier absent donne une base vide)
+ * @param motifs Base préparée par motifs_preparer()
+ * @param fichier Fichier du niveau
+ */
+void motifs_charger(t_Motifs * motifs, const char fichier[]);
+
+/**
+ * @brief Enregistre les motifs bloquants du niveau dans le fichier de son
+ * recueil, en gardant ceux des autres niveaux
+ * @param motifs Base de motifs
+ * @param fichier Fichier du niveau
+ * @return false si le fichier n'a pas pu être écrit (l'ancien reste)
+ */
+bool motifs_enregistrer(const t_Motifs * motifs, const char fichier[]);
+
+/**
+ * @brief Examine avant la partie chaque paire de caisses voisines qui peut
+ * se former hors des cases mortes, pour que le jeu n'ait plus qu'à consulter
+ * la base
+ * @param motifs Base préparée par motifs_preparer()
+ */
+void motifs_precalculer(t_Motifs * motifs);
+
+/**
+ * @brief Dit si une caisse qui vient d'être poussée forme un motif bloquant
+ * déjà connu, sans lancer de sous-recherche
+ * @param motifs Base de motifs
+ * @param caisses Couche des caisses après la poussée
+ * @param arrivee Case de la caisse poussée
+ * @return true si la base sait la position perdue
+ */
+bool motifs_poussee_connue(t_Motifs * motifs, const uint64_t caisses[],
+    int arrivee);
+
+/**
+ * @brief Dit si une position contient un motif bloquant déjà connu, sans
+ * lancer de sous-recherche (après une annulation ou un saut)
+ * @param motifs Base de motifs
+ * @param caisses Couche des caisses
+ * @return true si la base sait la position perdue
+ */
+bool motifs_position_connue(t_Motifs * motifs, const uint64_t caisses[]);
+
+/**
+ * @brief Libère la mémoire d'une solution
+ * @param solution Solution à libérer
+ */
+void solution_liberer(t_Solution * solution);
+
+/**
+ * @brief Arrête le programme sur une erreur rendue par le moteur
+ * @param erreur Compte rendu d'une fonction du moteur
+ */
+void moteur_verifier(t_Erreur erreur);
+
+/**
+ * @brief Agrandit un bloc mémoire avec reallouer et arrête le programme si
+ * la mémoire manque
+ * @param bloc Bloc à agrandir (ou NULL)
+ * @param taille Nouvelle taille en octets
+ * @return Adresse du bloc agrandi
+ */
+void * allouer(void * bloc, size_t taille);
+
+/**
+ * @brief Alloue un bloc remis à zéro avec allouer
+ * @param nombre Nombre d'éléments
+ * @param taille Taille d'un élément en octets
+ * @return Adresse du bloc
+ */
+void * allouer_zero(size_t nombre, size_t taille);
 
 /**
- * @brief Fonction qui renvoie si le joueur a gagné
- * @param plateauDeJeu Plateau du jeu de type t_Plateau
- * @return true si le joueur a gagné sinon false
+ * @brief Alloue des couches avec couches_allouer et arrête le programme si
+ * la mémoire manque
+ * @param nbMots Nombre de mots d'une couche
+ * @param nbCouches Nombre de couches consécutives
+ * @return Adresse de la première couche
  */
-bool gagne(t_Plateau plateauDeJeu);
+uint64_t * couches_creer(int nbMots, int nbCouches);
 
-int kbhit();
+int main(int argc, char * argv[]){ 
+    t_Plateau plateauDeJeu = PLATEAU_VIDE; // Plateau du jeu
+    char nomFichier[TAILLE_CHEMIN], touche = ATTENTE; //Nomdu fichier + touche
+    int nvZoom = 1;
+    t_Partie partie; // Niveau, positions et historique
+    t_Ecran ecran; // Dernière image affichée et image en préparation
+    t_Motifs motifs; // Motifs bloquants du niveau
 
-int main(){ 
-    t_Plateau plateauDeJeu; // Plateau du jeu
-    t_tabDeplacement historiqueDeplacement;
-    char nomFichier[TAILLE_FICHIER], touche = ATTENTE; //Nomdu fichier + touche
-    int nbDeplacements = ZERO, ligneSokoban, colonneSokoban, nvZoom = 1; 
+    // Modes sans affichage
+    if (argc >= 3 && strcmp(argv[1], OPTION_RESOUDRE) == 0) {
+        return mode_resoudre(argv[2], argc >= 4 ? argv[3] : NULL);
+    }
+    if (argc >= 4 && strcmp(argv[1], OPTION_RESOUDRE_PARALLELE) == 0) {
+        return mode_resoudre_parallele(argv[2], atoi(argv[3]),
+            argc >= 5 ? argv[4] : NULL);
+    }
+    if (argc >= 5 && strcmp(argv[1], OPTION_RESOUDRE_DISQUE) == 0) {
+        return mode_resoudre_disque(argv[2], argv[3], atoi(argv[4]),
+            argc >= 6 ? argv[5] : NULL);
+    }
+    if (argc >= 3 && strcmp(argv[1], OPTION_BENCH_ETATS) == 0) {
+        return mode_bench_etats(argv[2],
+            argc >= 4 ? atoll(argv[3]) : NB_ETATS_BENCH);
+    }
+    if (argc >= 3 && strcmp(argv[1], OPTION_BENCH_PARALLELE) == 0) {
+        return mode_bench_parallele(argc - 2, argv + 2);
+    }
+    if (argc >= 4 && strcmp(argv[1], OPTION_REJOUER) == 0) {
+        return mode_rejouer(argv[2], argv[3]);
+    }
+    if (argc >= 5 && strcmp(argv[1], OPTION_VERIFIER) == 0) {
+        return mode_verifier(argv[2], argv[3], atoi(argv[4]));
+    }
+    if (argc >= 3 && strcmp(argv[1], OPTION_BENCH_VERIFIER) == 0) {
+        return mode_bench_verifier(argv[2]);
+    }
+    if (argc >= 3 && strcmp(argv[1], OPTION_BENCH_DEPLACEMENTS) == 0) {
+        return mode_bench_deplacements(argv[2],
+            argc >= 4 ? atoi(argv[3]) : NB_COUPS_BENCH);
+    }
+    if (argc >= 3 && strcmp(argv[1], OPTION_BENCH_MINORANT) == 0) {
+        return mode_bench_minorant(argc - 2, argv + 2);
+    }
+    if (argc >= 3 && strcmp(argv[1], OPTION_BENCH_MACROS) == 0) {
+        return mode_bench_macros(argc - 2, argv + 2);
+    }
+    if (argc >= 2 && strcmp(argv[1], OPTION_BENCH_ZONE) == 0) {
+        return mode_bench_zone(argc - 2, argv + 2);
+    }
+    if (argc >= 3 && strcmp(argv[1], OPTION_BENCH) == 0) {
+        return mode_bench(argv[2], argc >= 4 ? argv[3] : NULL,
+            argc >= 5 ? argv[4] : NULL);
+    }
     printf("Entrez le nom du fichier : ");
-    scanf("%s", nomFichier);
-    charger_partie(plateauDeJeu, nomFichier);
-    affichier_entete(nbDeplacements,nomFichier);
-    afficher_plateau(plateauDeJeu, nvZoom);
-    // Définition des coordonnées où se trouve Sokoban
-    for (int i = 0 ; i < NB_LIGNES ; i++) {
-        for(int j = 0;j < NB_COLONNES;j++) {
-            if((plateauDeJeu[i][j] == SOKOBAN) || (plateauDeJeu[i][j] ==
-                SOKOBAN_CIBLE)) {
-                
-                ligneSokoban = i;
-                colonneSokoban = j;
-            }
-        }
+    if (scanf(FORMAT_CHEMIN, nomFichier) != 1) {
+        return EXIT_FAILURE;
     }
-    initialiser_historique_deplacement(historiqueDeplacement);
-    jeu(&touche, plateauDeJeu, nomFichier, ligneSokoban,
-        colonneSokoban, &nbDeplacements, nvZoom, historiqueDeplacement);
+    moteur_verifier(charger_partie(&plateauDeJeu, nomFichier));
+    ecran_initialiser(&ecran);
+    ecran_commencer(&ecran);
+    affichier_entete(ZERO, nomFichier, false, AUCUN_DEPLACEMENT, &ecran);
+    afficher_plateau(&plateauDeJeu, nvZoom, &ecran);
+    ecran_envoyer(&ecran);
+    moteur_verifier(partie_ouvrir(&partie, &plateauDeJeu, INTERVALLE_REPERES));
+    // Les sous-recherches sont faites ici, avant la première touche : en
+    // jeu, une poussée ne fait que consulter la base
+    motifs_preparer(&motifs, &partie.niveau, &partie.depart);
+    if (separateur_niveau(nomFichier) != NULL) {
+        motifs_charger(&motifs, nomFichier);
+    }
+    motifs_precalculer(&motifs);
+    jeu(&touche, &partie, nomFichier, nvZoom, &ecran, &motifs);
+    motifs_liberer(&motifs);
+    ecran_liberer(&ecran);
+    moteur_verifier(etat_vers_plateau(&partie.niveau, &partie.etat,
+        &plateauDeJeu));
     // Dit si le joueur a gagné ou abandonné en fonction de la dernière touche
     if(touche == ARRETER) {
-        abandon(plateauDeJeu);
+        abandon(&plateauDeJeu);
         printf("\nLa partie a été abandonnée\n"); 
     } else {
         printf("\nVous avez gagné !\n");
     }
-    enregistrement_deplacements(historiqueDeplacement, nbDeplacements);
+    enregistrement_deplacements(&partie.historique, partie.nbDeplacements);
+    partie_liberer(&partie);
+    plateau_liberer(&plateauDeJeu);
     return EXIT_SUCCESS;
 }
 
-void enregistrement_deplacements(t_tabDeplacement t, int nb){
-    char choix, nomFichierDeplacements[TAILLE_FICHIER];
+void moteur_verifier(t_Erreur erreur){
+    if (erreur != MOTEUR_OK) {
+        printf("%s", erreur_texte(erreur));
+        exit(EXIT_FAILURE);
+    }
+}
+
+void * allouer(void * bloc, size_t taille){
+    void * nouveau = reallouer(bloc, taille);
+    if (nouveau == NULL) {
+        moteur_verifier(MOTEUR_ERREUR_MEMOIRE);
+    }
+    return nouveau;
+}
+
+void * allouer_zero(size_t nombre, size_t taille){
+    void * bloc = allouer(NULL, nombre * taille);
+    memset(bloc, 0, nombre * taille);
+    return bloc;
+}
+
+uint64_t * couches_creer(int nbMots, int nbCouches){
+    uint64_t * couches = couches_allouer(nbMots, nbCouches);
+    if (couches == NULL) {
+        moteur_verifier(MOTEUR_ERREUR_MEMOIRE);
+    }
+    return couches;
+}
+
+void enregistrement_deplacements(const t_tabDeplacement * t, int nb){
+    char choix, nomFichierDeplacements[TAILLE_CHEMIN];
     printf("Souhaitez-vous enregistrer les déplacements ? (O/N) ");
     scanf(" %c", &choix);
     if (choix == VALIDATION) {
-        printf("Quel nom souhaitez-vous donner au fichier ? (19 caractères) ");
-        scanf("%s", nomFichierDeplacements);
-        enregistrer_deplacements(t, nb, nomFichierDeplacements);
+        printf("Quel nom souhaitez-vous donner au fichier ? ");
+        if (scanf(FORMAT_CHEMIN, nomFichierDeplacements) == 1) {
+            moteur_verifier(enregistrer_deplacements(t, nb,
+                nomFichierDeplacements));
+        }
     }
 }
 
-void jeu(char *toucheAppuyee, t_Plateau plateau, char fichier[],
-    int ligSok, int colSok, int *nbDepla, int zoom,
-    t_tabDeplacement histoDepla){
+void jeu(char *toucheAppuyee, t_Partie * partie, char fichier[], int zoom,
+    t_Ecran * ecran, t_Motifs * motifs){
     
+    // Plateau reconstruit seulement pour l'affichage
+    t_Plateau plateau = PLATEAU_VIDE;
+    bool alerte = true; // Avertir quand une caisse est bloquée
+    bool motifBloquant = motifs_position_connue(motifs,
+        partie->etat.caisses);
+    int direction, suivante;
+
+    terminal_mode_brut();
     // Boucle du jeu qui se termine si le joueur gagne ou abandonne
-    while (*toucheAppuyee != ARRETER && !gagne(plateau)) {
-        *toucheAppuyee = ATTENTE;
-        while (kbhit() == 0) {}
-        *toucheAppuyee = getchar();
-        if (*toucheAppuyee == RECOMMENCER) {
-            recommencer(&*nbDepla, plateau, fichier, &ligSok, &colSok,
-                histoDepla);
+    while (*toucheAppuyee != ARRETER && !partie_gagnee(partie)) {
+        // Le processus dort dans poll() jusqu'à l'arrivée d'une touche
+        *toucheAppuyee = attendre_touche(DELAI_INFINI);
+        direction = direction_touche(*toucheAppuyee);
+        if (direction != AUCUNE_DIRECTION) {
+            suivante = partie->etat.caseSok
+                + partie->niveau.decalages[direction];
+            // Après un déplacement, une caisse sur l'ancienne case suivante
+            // vient d'être poussée
+            if (partie_deplacer(partie, direction)
+                && bit_lire(partie->etat.caisses,
+                suivante + partie->niveau.decalages[direction])) {
+                motifBloquant = motifBloquant || motifs_poussee_connue(motifs,
+                    partie->etat.caisses,
+                    suivante + partie->niveau.decalages[direction]);
+            }
+        } else if (*toucheAppuyee == RECOMMENCER) {
+            recommencer(partie);
+            // La question posée a été écrite par-dessus le plateau
+            ecran_invalider(ecran);
         } else if (*toucheAppuyee == RETOUR) {
-            annulation_deplacer(plateau, &ligSok, &colSok, &*nbDepla,
-                histoDepla);
+            partie_annuler(partie);
+        } else if (*toucheAppuyee == REFAIRE) {
+            partie_refaire(partie);
+        } else if (*toucheAppuyee == SAUTER) {
+            sauter(partie);
+            ecran_invalider(ecran);
         } else if (*toucheAppuyee == ZOOM) {
-            if(zoom < 3) {
+            if(zoom < zoom_maximum(partie->niveau.nbLignes,
+                partie->niveau.nbColonnes)) {
                 zoom++;
             }
         } else if (*toucheAppuyee == DEZOOM) {
             if(zoom > 1) {
                 zoom=zoom-1;
             }
+        } else if (*toucheAppuyee == ALERTE) {
+            alerte = !alerte;
+        } else if (*toucheAppuyee == COUPER) {
+            partie_couper_boucle(partie);
+        } else if (*toucheAppuyee == MARCHER) {
+            marcher(partie);
+            ecran_invalider(ecran);
+        } else if (*toucheAppuyee == POUSSER) {
+            pousser(partie);
+            ecran_invalider(ecran);
+        }
+        // Les autres actions peuvent changer toute la position
+        if (direction == AUCUNE_DIRECTION) {
+            motifBloquant = motifs_position_connue(motifs,
+                partie->etat.caisses);
         }
-        deplacer(plateau, &ligSok, &colSok, *toucheAppuyee, &*nbDepla,
-            histoDepla);
 
-        system("clear");
-        affichier_entete(*nbDepla, fichier);
-        afficher_plateau(plateau, zoom);
+        moteur_verifier(etat_vers_plateau(&partie->niveau, &partie->etat,
+            &plateau));
+        ecran_commencer(ecran);
+        affichier_entete(partie->nbDeplacements, fichier,
+            alerte && (partie->etat.blocage || motifBloquant),
+            partie_deja_vue(partie), ecran);
+        afficher_plateau(&plateau, zoom, ecran);
+        ecran_envoyer(ecran);
     }
+    plateau_liberer(&plateau);
+    terminal_restaurer();
 }
 
-void afficher_plateau(t_Plateau plateau, int zoom){
-    for(int i = ZERO ; i < TAILLE ; i++) {
-        if (zoom == ZOOM1) {
-            plateaux1(plateau, zoom, i);
-        } else {
-            plateaux2_3(plateau, zoom, i);
-        }
+/**
+ * @brief Prépare les rangées de glyphes : pour chaque caractère du plateau,
+ * le caractère affiché répété ZOOM_MAX fois
+ * @param ecran Écran qui garde les glyphes
+ */
+static void glyphes_preparer(t_Ecran * ecran){
+    char affiche;
+
+    ecran->glyphes = allouer(NULL, (UINT8_MAX + 1) * ZOOM_MAX);
+    for (int c = ZERO ; c <= UINT8_MAX ; c++) {
+        // Les cibles ne se voient plus sous Sokoban et les caisses
+        affiche = c == SOKOBAN_CIBLE ? SOKOBAN : c == CAISSE_CIBLE ? CAISSE
+            : c;
+        memset(ecran->glyphes + c * ZOOM_MAX, affiche, ZOOM_MAX);
     }
 }
 
-void plateaux1(t_Plateau plateau, int zoom, int ligne){
-    for(int j = ZERO ; j < TAILLE ; j++){
-        if(plateau[ligne][j] == SOKOBAN_CIBLE) {
-            printf("%c", SOKOBAN);
-        } else if (plateau[ligne][j] == CAISSE_CIBLE) {
-            printf("%c", CAISSE);
-        } else {
-            printf("%c", plateau[ligne][j]);
+void afficher_plateau(const t_Plateau * plateau, int zoom, t_Ecran * ecran){
+    const int LARGEUR = plateau->nbColonnes * zoom;
+    const char * cases;
+    char * ligne, * copie;
+
+    if (ecran->glyphes == NULL) {
+        glyphes_preparer(ecran);
+    }
+    for (int i = ZERO ; i < plateau->nbLignes ; i++) {
+        cases = plateau->cases + i * plateau->nbColonnes;
+        // Chaque case copie toute sa rangée de glyphes, de taille fixe : la
+        // case suivante recouvre ce qui dépasse, quel que soit le zoom
+        ligne = ecran_etendre(ecran, LARGEUR, ZOOM_MAX);
+        for (int j = ZERO ; j < plateau->nbColonnes ; j++) {
+            memcpy(ligne + j * zoom,
+                ecran->glyphes + (uint8_t)cases[j] * ZOOM_MAX, ZOOM_MAX);
+        }
+        ecran_fin_ligne(ecran);
+        // La ligne construite est recopiée pour les zoom - 1 suivantes
+        for (int k = ZOOM1 ; k < zoom ; k++) {
+            copie = ecran_etendre(ecran, LARGEUR, ZERO);
+            memcpy(copie, ligne, LARGEUR);
+            ecran_fin_ligne(ecran);
         }
     }
-    printf("\n");
-    
 }
 
-void plateaux2_3(t_Plateau plateau, int zoom, int ligne){
-    if (zoom == ZOOM2) {
-        for(int k = ZERO ; k < ZOOM2 ; k++){
-            for(int j = ZERO ; j < TAILLE ; j++){
-                if(plateau[ligne][j] == SOKOBAN_CIBLE) {
-                    printf("%c", SOKOBAN);
-                    printf("%c", SOKOBAN);      
-                } else if (plateau[ligne][j] == CAISSE_CIBLE) {
-                    printf("%c", CAISSE);
-                    printf("%c", CAISSE);
-                } else {
-                    printf("%c", plateau[ligne][j]);
-                    printf("%c", plateau[ligne][j]);
-                }
-            }
-            printf("\n");
-        }
-    } else {
-        for(int k = ZERO ; k < ZOOM3 ; k++){
-            for(int j = ZERO ; j < TAILLE ; j++){
-                if(plateau[ligne][j] == SOKOBAN_CIBLE) {
-                    printf("%c", SOKOBAN);
-                    printf("%c", SOKOBAN);
-                    printf("%c", SOKOBAN);  
-                } else if (plateau[ligne][j] == CAISSE_CIBLE) {
-                    printf("%c", CAISSE);
-                    printf("%c", CAISSE);
-                    printf("%c", CAISSE);
-                } else {
-                    printf("%c", plateau[ligne][j]);
-                    printf("%c", plateau[ligne][j]);
-                    printf("%c", plateau[ligne][j]);
-                }
-            }
-            printf("\n");
+int zoom_maximum(int nbLignes, int nbColonnes){
+    struct winsize taille;
+    int zoom = ZOOM3;
+
+    if (nbLignes > ZERO && nbColonnes > ZERO
+        && ioctl(STDOUT_FILENO, TIOCGWINSZ, &taille) == ZERO) {
+        zoom = taille.ws_col / nbColonnes;
+        if ((taille.ws_row - LIGNES_ENTETE) / nbLignes < zoom) {
+            zoom = (taille.ws_row - LIGNES_ENTETE) / nbLignes;
         }
     }
+    return zoom < ZOOM3 ? ZOOM3 : zoom > ZOOM_MAX ? ZOOM_MAX : zoom;
 }
 
-void affichier_entete(int nbDepla, char nomFich[]){
+void affichier_entete(int nbDepla, char nomFich[], bool blocage, int dejaVu,
+    t_Ecran * ecran){
     // Affiche tous les éléments de l'en-tête
-    printf("\nPartie : %s     Nombre de déplacements : %d\n\n",
+    ecran_printf(ecran, "\nPartie : %s     Nombre de déplacements : %d\n\n",
         nomFich, nbDepla);
-    printf("Actions disponibles :\n");
-    printf("'z' = Aller en haut\n");
-    printf("'s' = Aller en bas\n");
-    printf("'q' = Aller à gauche\n");
-    printf("'d' = Aller à droite\n");
-    printf("'x' = Abandonner\n");
-    printf("'r' = Recommencer la partie\n");
-    printf("'+' = Zoomer\n");
-    printf("'-' = Dézoomer\n");
-    printf("'u' = Mouvement précédent\n\n");
-}
-
-void deplacer(t_Plateau plateau, int *ligSok, int *colSok,
-    char deplacement, int *nbDepla, t_tabDeplacement histoDepla){
-
-    int incrLigSok = ZERO, incrColSok = ZERO, doubleIncrLigSok = ZERO,
-    doubleIncrColSok = ZERO;
-    char deplacementHistorique;
-    // incrLigSok et incrColSok changent en fonction de la direction choisie
-    if(deplacement == HAUT) {
-        incrLigSok = ENLEVER;
-        deplacementHistorique = SOKOBAN_HAUT;
-    } else if (deplacement == BAS) {
-        incrLigSok = AJOUTER;
-        deplacementHistorique = SOKOBAN_BAS;
-    } else if (deplacement == GAUCHE) {
-        incrColSok = ENLEVER;
-        deplacementHistorique = SOKOBAN_GAUCHE;
-    } else if (deplacement == DROITE) {
-        incrColSok = AJOUTER;
-        deplacementHistorique = SOKOBAN_DROITE;
-    }
-    // doubleIncrLigSok et doubleIncrColSok représentent la ligne/colonne + 1
-    doubleIncrLigSok = incrLigSok * DOUBLE;
-    doubleIncrColSok = incrColSok * DOUBLE;
-    // Le déplacement se fait en fonction du cas où le joueur se trouve
-    if(plateau[*ligSok+incrLigSok][*colSok+incrColSok] == RIEN){
-        deplacement_rien(plateau, &*ligSok, &*colSok, incrLigSok,
-            incrColSok, &*nbDepla, histoDepla, deplacementHistorique);
-    } else if (plateau[*ligSok+incrLigSok][*colSok+incrColSok] == CAISSE) {
-        deplacement_caisse(plateau, &*ligSok, &*colSok, incrLigSok,
-            incrColSok, doubleIncrLigSok, doubleIncrColSok, &*nbDepla,
-            histoDepla, deplacementHistorique);
-    } else if (plateau[*ligSok+incrLigSok][*colSok+incrColSok] == 
-        CAISSE_CIBLE) {
-        deplacement_caisse_cible(plateau, &*ligSok, &*colSok, incrLigSok,
-            incrColSok, doubleIncrLigSok, doubleIncrColSok, &*nbDepla,
-            histoDepla, deplacementHistorique);
-    } else if (plateau[*ligSok+incrLigSok][*colSok+incrColSok] == CIBLE) {
-        deplacement_cible(plateau, &*ligSok, &*colSok, incrLigSok,
-            incrColSok, &*nbDepla, histoDepla, deplacementHistorique);
-    }
-}
-
-void deplacement_rien(t_Plateau plateau, int *ligSok, int *colSok,
-    int incrLigSok, int incrColSok, int *nbDepla, t_tabDeplacement histoDepla,
-    char deplacement){
-
-    // Si Sokoban se trouve sur une cible
-    if (plateau[*ligSok][*colSok] == SOKOBAN_CIBLE){
-        plateau[*ligSok][*colSok] = CIBLE;
-        plateau[*ligSok+incrLigSok][*colSok+incrColSok] = SOKOBAN;
-        deplacement_sokoban(incrLigSok, incrColSok, &*ligSok,
-            &*colSok, &*nbDepla);
-        
-        ajout_deplacement(histoDepla, deplacement, *nbDepla + ENLEVER);
-    } else {
-        plateau[*ligSok][*colSok] = RIEN;
-        plateau[*ligSok+incrLigSok][*colSok+incrColSok] = SOKOBAN;
-        deplacement_sokoban(incrLigSok, incrColSok, &*ligSok,
-            &*colSok, &*nbDepla);
-        
-        ajout_deplacement(histoDepla, deplacement, *nbDepla + ENLEVER);
+    ecran_printf(ecran, "Actions disponibles :\n");
+    ecran_printf(ecran, "'z' = Aller en haut\n");
+    ecran_printf(ecran, "'s' = Aller en bas\n");
+    ecran_printf(ecran, "'q' = Aller à gauche\n");
+    ecran_printf(ecran, "'d' = Aller à droite\n");
+    ecran_printf(ecran, "'x' = Abandonner\n");
+    ecran_printf(ecran, "'r' = Recommencer la partie\n");
+    ecran_printf(ecran, "'+' = Zoomer\n");
+    ecran_printf(ecran, "'-' = Dézoomer\n");
+    ecran_printf(ecran, "'u' = Mouvement précédent\n");
+    ecran_printf(ecran, "'y' = Refaire le mouvement annulé\n");
+    ecran_printf(ecran, "'j' = Aller à un mouvement donné\n");
+    ecran_printf(ecran, "'a' = Activer/désactiver l'alerte de blocage\n");
+    ecran_printf(ecran, "'c' = Supprimer la boucle qui ramène ici\n");
+    ecran_printf(ecran, "'m' = Marcher jusqu'à une case\n");
+    ecran_printf(ecran, "'p' = Pousser une caisse jusqu'à une case\n\n");
+    if (blocage) {
+        ecran_printf(ecran, "Attention : une caisse est bloquée, la partie ne"
+            " peut plus être gagnée\n\n");
+    }
+    if (dejaVu != AUCUN_DEPLACEMENT) {
+        ecran_printf(ecran, "Position déjà atteinte au déplacement %d : 'c'"
+            " pour supprimer la boucle\n\n", dejaVu);
     }
 }
 
-void deplacement_caisse(t_Plateau plateau, int *ligSok, int *colSok,
-    int incrLigSok, int incrColSok, int doubleIncrLigSok,
-    int doubleIncrColSok, int *nbDepla, t_tabDeplacement histoDepla,
-    char deplacement){
-    
-    // Si 2 cases plus loin il ne se trouve rien
-    if (plateau[*ligSok+doubleIncrLigSok][*colSok+doubleIncrColSok] == RIEN){
-        // Si Sokoban se trouve sur une cible
-        if (plateau[*ligSok][*colSok] == SOKOBAN_CIBLE){
-            plateau[*ligSok+doubleIncrLigSok]
-            [*colSok+doubleIncrColSok] = CAISSE;
-
-            plateau[*ligSok+incrLigSok][*colSok+incrColSok] = SOKOBAN;
-            plateau[*ligSok][*colSok] = CIBLE;
-            deplacement_sokoban(incrLigSok, incrColSok, &*ligSok,
-                &*colSok, &*nbDepla);
-                
-            ajout_deplacement_caisse(&deplacement);
-            ajout_deplacement(histoDepla, deplacement, *nbDepla + ENLEVER);
-        } else {
-            plateau[*ligSok+doubleIncrLigSok]
-            [*colSok+doubleIncrColSok] = CAISSE;
-
-            plateau[*ligSok+incrLigSok][*colSok+incrColSok] = SOKOBAN;
-            plateau[*ligSok][*colSok] = RIEN;
-            deplacement_sokoban(incrLigSok, incrColSok, &*ligSok,
-                &*colSok, &*nbDepla);
-                
-            ajout_deplacement_caisse(&deplacement);
-            ajout_deplacement(histoDepla, deplacement, *nbDepla + ENLEVER);
-        }
-    // Sinon si 2 cases plus loin il se trouve une cible
-    } else if (plateau[*ligSok+doubleIncrLigSok]
-        [*colSok+doubleIncrColSok] == CIBLE) {
-
-        // Si Sokoban se trouve sur une cible
-        if (plateau[*ligSok][*colSok] == SOKOBAN_CIBLE){
-            plateau[*ligSok+doubleIncrLigSok]
-            [*colSok+doubleIncrColSok] = CAISSE_CIBLE;
-
-            plateau[*ligSok+incrLigSok][*colSok+incrColSok] = SOKOBAN;
-            plateau[*ligSok][*colSok] = CIBLE;
-            deplacement_sokoban(incrLigSok, incrColSok, &*ligSok,
-                &*colSok, &*nbDepla);
-                
-            ajout_deplacement_caisse(&deplacement);
-            ajout_deplacement(histoDepla, deplacement, *nbDepla + ENLEVER);
-        } else {
-            plateau[*ligSok+doubleIncrLigSok]
-            [*colSok+doubleIncrColSok] = CAISSE_CIBLE;
-
-            plateau[*ligSok+incrLigSok][*colSok+incrColSok] = SOKOBAN;
-            plateau[*ligSok][*colSok] = RIEN;
-            deplacement_sokoban(incrLigSok, incrColSok, &*ligSok,
-                &*colSok, &*nbDepla);
-                
-            ajout_deplacement_caisse(&deplacement);
-            ajout_deplacement(histoDepla, deplacement, *nbDepla + ENLEVER);
-        }
+void sauter(t_Partie * partie){
+    int cible;
+    // La saisie se fait avec l'écho et le tampon de ligne habituels
+    terminal_restaurer();
+    printf("Aller au déplacement numéro (0 à %d) : ",
+        partie->historique.nbEnregistres);
+    if (scanf("%d", &cible) == 1) {
+        partie_aller(partie, cible);
     }
+    terminal_mode_brut();
 }
 
-void deplacement_caisse_cible(t_Plateau plateau, int *ligSok, int *colSok,
-    int incrLigSok, int incrColSok, int doubleIncrLigSok,
-    int doubleIncrColSok, int *nbDepla, t_tabDeplacement histoDepla,
-    char deplacement){
-
-    // Si 2 cases plus loin il ne se trouve rien
-    if (plateau[*ligSok+doubleIncrLigSok][*colSok+doubleIncrColSok] == RIEN){
-        // Si Sokoban se trouve sur une cible
-        if (plateau[*ligSok][*colSok] == SOKOBAN_CIBLE){
-            plateau[*ligSok+doubleIncrLigSok]
-            [*colSok+doubleIncrColSok] = CAISSE;
-
-            plateau[*ligSok+incrLigSok][*colSok+incrColSok] = SOKOBAN_CIBLE;
-            plateau[*ligSok][*colSok] = CIBLE;
-            deplacement_sokoban(incrLigSok, incrColSok, &*ligSok,
-                &*colSok, &*nbDepla);
-                
-            ajout_deplacement_caisse(&deplacement);
-            ajout_deplacement(histoDepla, deplacement, *nbDepla + ENLEVER);
-        } else {
-            plateau[*ligSok+doubleIncrLigSok]
-            [*colSok+doubleIncrColSok] = CAISSE;
-            plateau[*ligSok+incrLigSok][*colSok+incrColSok] = SOKOBAN_CIBLE;
-            plateau[*ligSok][*colSok] = RIEN;
-            deplacement_sokoban(incrLigSok, incrColSok, &*ligSok,
-                &*colSok, &*nbDepla);
-                
-            ajout_deplacement_caisse(&deplacement);
-            ajout_deplacement(histoDepla, deplacement, *nbDepla + ENLEVER);
-        }
-    // Sinon si 2 cases plus loin il se trouve une cible
-    } else if (plateau[*ligSok+doubleIncrLigSok]
-        [*colSok+doubleIncrColSok] == CIBLE) {
-        // Si Sokoban se trouve sur une cible
-        if (plateau[*ligSok][*colSok] == SOKOBAN_CIBLE){
-            plateau[*ligSok+doubleIncrLigSok]
-            [*colSok+doubleIncrColSok] = CAISSE_CIBLE;
-
-            plateau[*ligSok+incrLigSok][*colSok+incrColSok] = SOKOBAN_CIBLE;
-            plateau[*ligSok][*colSok] = CIBLE;
-            deplacement_sokoban(incrLigSok, incrColSok, &*ligSok,
-                &*colSok, &*nbDepla);
-                
-            ajout_deplacement_caisse(&deplacement);
-            ajout_deplacement(histoDepla, deplacement, *nbDepla + ENLEVER);
-        } else {
-            plateau[*ligSok+doubleIncrLigSok]
-            [*colSok+doubleIncrColSok] = CAISSE_CIBLE;
-
-            plateau[*ligSok+incrLigSok][*colSok+incrColSok] = SOKOBAN_CIBLE;
-            plateau[*ligSok][*colSok] = RIEN;
-            deplacement_sokoban(incrLigSok, incrColSok, &*ligSok,
-                &*colSok, &*nbDepla);
+void marcher(t_Partie * partie){
+    int ligne, colonne, nbDepla = AUCUN_DEPLACEMENT;
+    // La saisie se fait avec l'écho et le tampon de ligne habituels
+    terminal_restaurer();
+    printf("Aller à la case (ligne colonne, à partir de 1) : ");
+    if (scanf("%d %d", &ligne, &colonne) == DOUBLE) {
+        nbDepla = partie_marcher_vers(partie, ligne - 1, colonne - 1);
+    }
+    terminal_mode_brut();
+    if (nbDepla == AUCUN_DEPLACEMENT) {
+        printf("Case hors d'atteinte, appuyez sur une touche");
+        fflush(stdout);
+        attendre_touche(DELAI_INFINI);
+    }
+}
 
-            ajout_deplacement_caisse(&deplacement);
-            ajout_deplacement(histoDepla, deplacement, *nbDepla + ENLEVER);
+void pousser(t_Partie * partie){
+    int ligneCaisse, colonneCaisse, ligne, colonne;
+    int nbDepla = AUCUN_DEPLACEMENT;
+    // La saisie se fait avec l'écho et le tampon de ligne habituels
+    terminal_restaurer();
+    printf("Caisse à pousser (ligne colonne, à partir de 1) : ");
+    if (scanf("%d %d", &ligneCaisse, &colonneCaisse) == DOUBLE) {
+        printf("Case d'arrivée (ligne colonne) : ");
+        if (scanf("%d %d", &ligne, &colonne) == DOUBLE) {
+            nbDepla = partie_pousser_vers(partie, ligneCaisse - 1,
+                colonneCaisse - 1, ligne - 1, colonne - 1);
         }
     }
+    terminal_mode_brut();
+    if (nbDepla == AUCUN_DEPLACEMENT) {
+        printf("Cette caisse ne peut pas y être poussée, appuyez sur une"
+            " touche");
+        fflush(stdout);
+        attendre_touche(DELAI_INFINI);
+    }
 }
 
-void deplacement_cible(t_Plateau plateau, int *ligSok, int *colSok,
-    int incrLigSok, int incrColSok, int *nbDepla, t_tabDeplacement histoDepla,
-    char deplacement){
-    
-    // Si Sokoban se trouve sur une cible
-    if (plateau[*ligSok][*colSok] == SOKOBAN_CIBLE){
-        plateau[*ligSok][*colSok] = CIBLE;
-        plateau[*ligSok+incrLigSok][*colSok+incrColSok] = SOKOBAN_CIBLE;
-        deplacement_sokoban(incrLigSok, incrColSok, &*ligSok,
-            &*colSok, &*nbDepla);
-
-        ajout_deplacement(histoDepla, deplacement, *nbDepla + ENLEVER);
-    } else {
-        plateau[*ligSok][*colSok] = RIEN;
-        plateau[*ligSok+incrLigSok][*colSok+incrColSok] = SOKOBAN_CIBLE;
-        deplacement_sokoban(incrLigSok, incrColSok, &*ligSok,
-            &*colSok, &*nbDepla);
-        
-        ajout_deplacement(histoDepla, deplacement, *nbDepla + ENLEVER);
+void recommencer(t_Partie * partie){
+    char choix;
+    // La saisie se fait avec l'écho et le tampon de ligne habituels
+    terminal_restaurer();
+    printf("Êtes-vous sûr de vouloir recommencer ? (O/N) ");
+    scanf(" %c", &choix);
+    terminal_mode_brut();
+    // Regarde si le joueur a choisi de valider de recommencer
+    if (choix == VALIDATION) {
+        partie_recommencer(partie);
     }
 }
 
-void deplacement_sokoban(int nvLig, int nvCol, int *ligSok,
-    int *colSok, int *nbDepla){
-    
-    // Effectue les changements dans les coordonnées de Sokoban
-    *ligSok = *ligSok + nvLig;
-    *colSok = *colSok + nvCol;
-    *nbDepla = *nbDepla + 1;
+void abandon(const t_Plateau * plateauDeJeu){
+    char choix, nomNvFichier[TAILLE_CHEMIN];
+    printf("Souhaitez-vous enregistrer la partie ? (O/N) ");
+    scanf(" %c", &choix);
+    // Regarde si le joueur a choisi de sauvegarder
+    if (choix == VALIDATION){
+        printf("Quel nom au fichier ? ");
+        if (scanf(FORMAT_CHEMIN, nomNvFichier) == 1) {
+            moteur_verifier(enregistrer_partie(plateauDeJeu, nomNvFichier));
+        }
+    }
 }
 
-void ajout_deplacement(t_tabDeplacement histoDepla, char dernierDepla,
-    int nbDepla){
-    
-    histoDepla[nbDepla]=dernierDepla;
+static struct termios terminalOrigine;  // Réglage du terminal au lancement
+static volatile sig_atomic_t terminalSauvegarde = 0;
+static volatile sig_atomic_t terminalBrut = 0;
+// La taille du terminal est à lire avant la première image
+static volatile sig_atomic_t terminalRedimensionne = 1;
+
+/**
+ * @brief Restaure le terminal puis relaisse le signal tuer le programme
+ * @param numSignal Numéro du signal reçu
+ */
+static void terminal_signal(int numSignal){
+    terminal_restaurer();
+    signal(numSignal, SIG_DFL);
+    raise(numSignal);
+}
+
+void terminal_mode_brut(){
+    struct termios brut;
+    struct sigaction action;
+    int signaux[] = {SIGINT, SIGTERM, SIGHUP, SIGQUIT};
+
+    if (!isatty(STDIN_FILENO) || terminalBrut) {
+        return;
+    }
+    // Première utilisation : on sauvegarde le terminal et on prévoit sa
+    // restauration quelle que soit la façon dont le programme se termine
+    if (!terminalSauvegarde) {
+        tcgetattr(STDIN_FILENO, &terminalOrigine);
+        terminalSauvegarde = 1;
+        atexit(terminal_restaurer);
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = terminal_signal;
+        sigemptyset(&action.sa_mask);
+        for (size_t i = 0 ; i < sizeof(signaux) / sizeof(signaux[0]) ; i++) {
+            sigaction(signaux[i], &action, NULL);
+        }
+    }
+    brut = terminalOrigine;
+    brut.c_lflag &= ~(ICANON | ECHO);
+    brut.c_cc[VMIN] = 1;
+    brut.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &brut);
+    terminalBrut = 1;
+}
+
+void terminal_restaurer(){
+    if (terminalSauvegarde && terminalBrut) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &terminalOrigine);
+        terminalBrut = 0;
+    }
+}
+
+char attendre_touche(int delaiMs){
+    struct pollfd entree = {STDIN_FILENO, POLLIN, 0};
+    char touche = ATTENTE;
+    int pret;
+    ssize_t lus;
+
+    // Un changement de taille interrompt l'attente pour redessiner l'écran
+    do {
+        pret = poll(&entree, 1, delaiMs);
+    } while (pret < 0 && errno == EINTR && !terminalRedimensionne);
+
+    if (pret > 0) {
+        // read() direct : le tampon de stdio ne doit pas cacher de touche à poll
+        lus = read(STDIN_FILENO, &touche, 1);
+        if (lus <= 0) {
+            touche = ARRETER;
+        }
+    }
+    return touche;
+}
+
+/**
+ * @brief Garantit qu'une ligne peut contenir un certain nombre d'octets
+ * @param ligne Ligne à agrandir si besoin
+ * @param taille Nombre d'octets nécessaires
+ */
+static void ligne_reserver(t_LigneEcran * ligne, int taille){
+    if (taille > ligne->capacite) {
+        ligne->capacite = taille * DOUBLE;
+        ligne->texte = allouer(ligne->texte, ligne->capacite);
+    }
+}
+
+/**
+ * @brief Ajoute des octets au tampon de sortie de l'écran
+ * @param ecran Écran dont on complète la sortie
+ * @param octets Octets à ajouter
+ * @param nbOctets Nombre d'octets à ajouter
+ */
+static void sortie_ajouter(t_Ecran * ecran, const char octets[],
+    size_t nbOctets){
+
+    if (ecran->tailleSortie + nbOctets > ecran->capaciteSortie) {
+        ecran->capaciteSortie = (ecran->tailleSortie + nbOctets) * DOUBLE;
+        ecran->sortie = allouer(ecran->sortie, ecran->capaciteSortie);
+    }
+    memcpy(ecran->sortie + ecran->tailleSortie, octets, nbOctets);
+    ecran->tailleSortie += nbOctets;
+}
+
+/**
+ * @brief Ajoute une séquence ANSI plaçant le curseur (origine en 0, 0)
+ * @param ecran Écran dont on complète la sortie
+ * @param ligne Ligne où placer le curseur
+ * @param colonne Colonne où placer le curseur
+ */
+static void sortie_curseur(t_Ecran * ecran, int ligne, int colonne){
+    char sequence[TAILLE_SEQUENCE_ECRAN];
+    int n = snprintf(sequence, sizeof(sequence), "%c[%d;%dH", ECHAPPEMENT,
+        ligne + 1, colonne + 1);
+    sortie_ajouter(ecran, sequence, n);
+}
+
+/**
+ * @brief Compte les colonnes occupées par des octets UTF-8 à l'écran
+ * @param texte Texte à mesurer
+ * @param nbOctets Nombre d'octets à mesurer
+ * @return Nombre de caractères affichés
+ */
+static int colonnes_utf8(const char texte[], int nbOctets){
+    int colonnes = ZERO;
+    for (int i = ZERO ; i < nbOctets ; i++) {
+        // Les octets de continuation (10xxxxxx) n'occupent pas de colonne
+        if (((unsigned char)texte[i] & 0xC0) != 0x80) {
+            colonnes++;
+        }
+    }
+    return colonnes;
+}
+
+/**
+ * @brief Indique si une ligne ne contient que des caractères ASCII
+ * @param ligne Ligne à examiner
+ * @return true si chaque octet correspond à une colonne
+ */
+static bool ligne_ascii(const t_LigneEcran * ligne){
+    bool ascii = true;
+    for (int i = ZERO ; i < ligne->longueur && ascii ; i++) {
+        ascii = ((unsigned char)ligne->texte[i] < 0x80);
+    }
+    return ascii;
+}
+
+/**
+ * @brief Ajoute à la sortie ce qu'il faut pour passer d'une ligne à l'autre
+ * @param ecran Écran dont on complète la sortie
+ * @param numero Numéro de la ligne à l'écran
+ * @param ancienne Ligne affichée actuellement
+ * @param nouvelle Ligne à afficher
+ */
+static void ligne_differences(t_Ecran * ecran, int numero,
+    const t_LigneEcran * ancienne, const t_LigneEcran * nouvelle){
+
+    char effacer[] = {ECHAPPEMENT, '[', 'K'};
+    int commun = nouvelle->longueur < ancienne->longueur ?
+        nouvelle->longueur : ancienne->longueur;
+    int debut = ZERO, fin;
+
+    while (debut < commun && ancienne->texte[debut] == nouvelle->texte[debut]) {
+        debut++;
+    }
+    if (debut == commun && nouvelle->longueur == ancienne->longueur) {
+        return;
+    }
+    if (!ligne_ascii(ancienne) || !ligne_ascii(nouvelle)) {
+        // Avec des caractères multi-octets, on réécrit la fin de la ligne
+        while (debut > ZERO
+            && ((unsigned char)nouvelle->texte[debut] & 0xC0) == 0x80) {
+            debut--;
+        }
+        sortie_curseur(ecran, numero, colonnes_utf8(nouvelle->texte, debut));
+        sortie_ajouter(ecran, nouvelle->texte + debut,
+            nouvelle->longueur - debut);
+        sortie_ajouter(ecran, effacer, sizeof(effacer));
+        return;
+    }
+    // Sinon seules les suites de cellules modifiées sont envoyées ; deux
+    // suites proches sont fusionnées car un déplacement du curseur coûte plus
+    while (debut < commun) {
+        fin = debut + 1;
+        for (int j = fin ; j < commun && j < fin + ECART_FUSION_ECRAN ; j++) {
+            if (ancienne->texte[j] != nouvelle->texte[j]) {
+                fin = j + 1;
+            }
+        }
+        sortie_curseur(ecran, numero, debut);
+        sortie_ajouter(ecran, nouvelle->texte + debut, fin - debut);
+        debut = fin;
+        while (debut < commun
+            && ancienne->texte[debut] == nouvelle->texte[debut]) {
+            debut++;
+        }
+    }
+    if (nouvelle->longueur > commun) {
+        sortie_curseur(ecran, numero, commun);
+        sortie_ajouter(ecran, nouvelle->texte + commun,
+            nouvelle->longueur - commun);
+    } else if (ancienne->longueur > commun) {
+        sortie_curseur(ecran, numero, commun);
+        sortie_ajouter(ecran, effacer, sizeof(effacer));
+    }
+}
+
+/**
+ * @brief Note que le terminal a changé de taille (SIGWINCH)
+ * @param numSignal Numéro du signal reçu
+ */
+static void terminal_redimensionner(int numSignal){
+    (void)numSignal;
+    terminalRedimensionne = 1;
+}
+
+/**
+ * @brief Lit la taille du terminal ; si la sortie n'en est pas un, l'image
+ * n'est pas coupée
+ * @param ecran Écran qui garde la taille
+ */
+static void terminal_taille_lire(t_Ecran * ecran){
+    struct winsize taille;
+
+    terminalRedimensionne = 0;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &taille) == ZERO
+        && taille.ws_row > ZERO && taille.ws_col > ZERO) {
+        ecran->nbLignesTerminal = taille.ws_row;
+        ecran->nbColonnesTerminal = taille.ws_col;
+    } else {
+        ecran->nbLignesTerminal = INT32_MAX;
+        ecran->nbColonnesTerminal = INT32_MAX;
+    }
+}
+
+/**
+ * @brief Coupe une ligne de l'image à un nombre de colonnes à l'écran
+ * @param ligne Ligne à couper
+ * @param nbColonnes Nombre de colonnes du terminal
+ * @return true si la ligne dépassait
+ */
+static bool ligne_couper(t_LigneEcran * ligne, int nbColonnes){
+    int colonnes = ZERO, i = ZERO;
+
+    if (ligne->longueur <= nbColonnes) {
+        return false;
+    }
+    // Avance jusqu'au premier caractère qui tomberait hors de l'écran
+    while (i < ligne->longueur
+        && (colonnes < nbColonnes
+        || ((unsigned char)ligne->texte[i] & 0xC0) == 0x80)) {
+        if (((unsigned char)ligne->texte[i] & 0xC0) != 0x80) {
+            colonnes++;
+        }
+        i++;
+    }
+    if (i == ligne->longueur) {
+        return false;
+    }
+    ligne->longueur = i;
+    return true;
+}
+
+void ecran_initialiser(t_Ecran * ecran){
+    struct sigaction action;
+
+    memset(ecran, 0, sizeof(*ecran));
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = terminal_redimensionner;
+    sigemptyset(&action.sa_mask);
+    // Les lectures de scanf reprennent après le signal
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGWINCH, &action, NULL);
+    terminalRedimensionne = 1;
+}
+
+void ecran_liberer(t_Ecran * ecran){
+    for (int i = ZERO ; i < ecran->capaciteLignes ; i++) {
+        free(ecran->precedentes[i].texte);
+        free(ecran->courantes[i].texte);
+    }
+    free(ecran->precedentes);
+    free(ecran->courantes);
+    free(ecran->sortie);
+    free(ecran->glyphes);
+    memset(ecran, 0, sizeof(*ecran));
+}
+
+void ecran_commencer(t_Ecran * ecran){
+    if (ecran->capaciteLignes == ZERO) {
+        ecran->capaciteLignes = CAPACITE_INITIALE_ECRAN;
+        ecran->precedentes = allouer_zero(ecran->capaciteLignes,
+            sizeof(t_LigneEcran));
+        ecran->courantes = allouer_zero(ecran->capaciteLignes,
+            sizeof(t_LigneEcran));
+    }
+    ecran->nbCourantes = 1;
+    ecran->courantes[0].longueur = ZERO;
+}
+
+void ecran_ajouter(t_Ecran * ecran, const char octets[], int nbOctets){
+    t_LigneEcran * ligne = &ecran->courantes[ecran->nbCourantes - 1];
+    ligne_reserver(ligne, ligne->longueur + nbOctets);
+    memcpy(ligne->texte + ligne->longueur, octets, nbOctets);
+    ligne->longueur += nbOctets;
+}
+
+char * ecran_etendre(t_Ecran * ecran, int nbOctets, int marge){
+    t_LigneEcran * ligne = &ecran->courantes[ecran->nbCourantes - 1];
+    ligne_reserver(ligne, ligne->longueur + nbOctets + marge);
+    ligne->longueur += nbOctets;
+    return ligne->texte + ligne->longueur - nbOctets;
+}
+
+void ecran_fin_ligne(t_Ecran * ecran){
+    int ancienneCapacite = ecran->capaciteLignes;
+    if (ecran->nbCourantes == ecran->capaciteLignes) {
+        ecran->capaciteLignes = ecran->capaciteLignes * DOUBLE;
+        ecran->precedentes = allouer(ecran->precedentes,
+            ecran->capaciteLignes * sizeof(t_LigneEcran));
+        ecran->courantes = allouer(ecran->courantes,
+            ecran->capaciteLignes * sizeof(t_LigneEcran));
+        memset(ecran->precedentes + ancienneCapacite, 0,
+            (ecran->capaciteLignes - ancienneCapacite) * sizeof(t_LigneEcran));
+        memset(ecran->courantes + ancienneCapacite, 0,
+            (ecran->capaciteLignes - ancienneCapacite) * sizeof(t_LigneEcran));
+    }
+    ecran->courantes[ecran->nbCourantes].longueur = ZERO;
+    ecran->nbCourantes++;
+}
+
+void ecran_printf(t_Ecran * ecran, const char format[], ...){
+    char texte[TAILLE_TEXTE_ECRAN];
+    va_list arguments;
+    int longueur, debut = ZERO;
+
+    va_start(arguments, format);
+    longueur = vsnprintf(texte, sizeof(texte), format, arguments);
+    va_end(arguments);
+    if (longueur >= TAILLE_TEXTE_ECRAN) {
+        longueur = TAILLE_TEXTE_ECRAN - 1;
+    }
+    // Découpe le texte en lignes
+    for (int i = ZERO ; i < longueur ; i++) {
+        if (texte[i] == '\n') {
+            ecran_ajouter(ecran, texte + debut, i - debut);
+            ecran_fin_ligne(ecran);
+            debut = i + 1;
+        }
+    }
+    ecran_ajouter(ecran, texte + debut, longueur - debut);
+}
+
+void ecran_envoyer(t_Ecran * ecran){
+    char effacerTout[] = {ECHAPPEMENT, '[', 'H', ECHAPPEMENT, '[', '2', 'J'};
+    t_LigneEcran vide = {NULL, ZERO, ZERO};
+    t_LigneEcran * echange;
+    int nbLignes, nbLignesVisibles;
+    bool deborde = false;
+    size_t envoyes = ZERO;
+    ssize_t n;
+
+    if (terminalRedimensionne) {
+        terminal_taille_lire(ecran);
+        ecran->valide = false;
+    }
+    // Une dernière ligne vide vient seulement du '\n' final
+    if (ecran->courantes[ecran->nbCourantes - 1].longueur == ZERO) {
+        ecran->nbCourantes--;
+    }
+    // La dernière ligne du terminal reste libre pour le curseur : rien ne
+    // défile, et les positions absolues restent justes
+    nbLignesVisibles = ecran->nbLignesTerminal > 1 ?
+        ecran->nbLignesTerminal - 1 : 1;
+    if (ecran->nbCourantes > nbLignesVisibles) {
+        ecran->nbCourantes = nbLignesVisibles;
+        deborde = true;
+    }
+    for (int i = ZERO ; i < ecran->nbCourantes ; i++) {
+        deborde = ligne_couper(&ecran->courantes[i],
+            ecran->nbColonnesTerminal) || deborde;
+    }
+    // L'image qui commence ou cesse de déborder est redessinée en entier
+    if (deborde != ecran->deborde) {
+        ecran->deborde = deborde;
+        ecran->valide = false;
+    }
+    nbLignes = ecran->nbCourantes > ecran->nbPrecedentes ?
+        ecran->nbCourantes : ecran->nbPrecedentes;
+    ecran->tailleSortie = ZERO;
+    if (!ecran->valide) {
+        sortie_ajouter(ecran, effacerTout, sizeof(effacerTout));
+        ecran->nbPrecedentes = ZERO;
+    }
+    for (int i = ZERO ; i < nbLignes ; i++) {
+        ligne_differences(ecran, i,
+            i < ecran->nbPrecedentes ? &ecran->precedentes[i] : &vide,
+            i < ecran->nbCourantes ? &ecran->courantes[i] : &vide);
+    }
+    // Le curseur est laissé sous l'image pour les messages qui suivent
+    if (ecran->tailleSortie > ZERO) {
+        sortie_curseur(ecran, ecran->nbCourantes, ZERO);
+    }
+
+    fflush(stdout);
+    while (envoyes < ecran->tailleSortie) {
+        n = write(STDOUT_FILENO, ecran->sortie + envoyes,
+            ecran->tailleSortie - envoyes);
+        if (n < 0 && errno != EINTR) {
+            break;
+        }
+        envoyes += n > 0 ? (size_t)n : ZERO;
+    }
+
+    // L'image courante devient l'image précédente
+    echange = ecran->precedentes;
+    ecran->precedentes = ecran->courantes;
+    ecran->courantes = echange;
+    ecran->nbPrecedentes = ecran->nbCourantes;
+    ecran->valide = true;
+}
+
+void ecran_invalider(t_Ecran * ecran){
+    ecran->valide = false;
+}
+
+/**
+ * @brief Affiche le résultat d'une résolution et écrit la solution
+ * @param solution Résultat de la recherche
+ * @param trouvee true si une solution a été trouvée
+ * @param fichierSolution Fichier où écrire la solution (NULL pour l'écran)
+ */
+static void solution_afficher(const t_Solution * solution, bool trouvee,
+    char fichierSolution[]){
+
+    if (trouvee) {
+        printf("Solution : %d déplacements, %d poussées\n",
+            solution->nbDeplacements, solution->nbPoussees);
+        if (fichierSolution != NULL) {
+            moteur_verifier(enregistrer_deplacements(&solution->deplacements,
+                solution->nbDeplacements, fichierSolution));
+        } else {
+            moteur_verifier(historique_ecrire(&solution->deplacements,
+                solution->nbDeplacements, stdout));
+            printf("\n");
+        }
+    } else {
+        printf("Aucune solution\n");
+    }
+    printf("Noeuds développés : %lld\n", solution->noeudsDeveloppes);
+    printf("Noeuds créés : %lld\n", solution->noeudsCrees);
+    printf("Mémoire de la recherche : %zu Kio\n",
+        solution->memoireRecherche / OCTETS_PAR_KIO);
+    if (solution->octetsEtat > ZERO && solution->noeudsCrees > ZERO) {
+        printf("Octets par état : %d compacts, %.1f avec table et noeud\n",
+            solution->octetsEtat,
+            (double)solution->memoireEtats / solution->noeudsCrees);
+    }
+    printf("Mémoire maximale du processus : %ld Kio\n",
+        solution->memoireMaxKio);
+    printf("Durée : %.3f s\n",
+        (double)solution->dureeUs / MICROSECONDES_PAR_SECONDE);
+}
+
+int mode_resoudre(char fichier[], char fichierSolution[]){
+    t_Plateau plateau = PLATEAU_VIDE;
+    t_Niveau niveau;
+    t_Etat etat;
+    t_Solution solution;
+    t_Motifs motifs;
+    bool trouvee, recueil = separateur_niveau(fichier) != NULL;
+
+    moteur_verifier(charger_partie(&plateau, fichier));
+    moteur_verifier(etat_depuis_plateau(&plateau, &niveau, &etat));
+    motifs_preparer(&motifs, &niveau, &etat);
+    // Seuls les niveaux d'un recueil ont un fichier de motifs : un niveau
+    // seul est résolu une fois, ses motifs ne resserviraient pas
+    if (recueil) {
+        motifs_charger(&motifs, fichier);
+    }
+    trouvee = resoudre(&niveau, &etat, MINORANT_AFFECTATION, &motifs, true,
+        &solution);
+    solution_afficher(&solution, trouvee, fichierSolution);
+    printf("Motifs bloquants : %u lus, %u appris, %lld sous-recherches, "
+        "%lld poussées écartées\n", motifs.nbLus,
+        motifs.nbBloquants - motifs.nbLus, motifs.nbSousRecherches,
+        motifs.nbCoupures);
+    // Le fichier n'est réécrit que s'il y a des motifs nouveaux, et ne pas
+    // pouvoir l'écrire n'empêche pas d'avoir résolu le niveau
+    if (recueil && motifs.nbBloquants > motifs.nbLus
+        && !motifs_enregistrer(&motifs, fichier)) {
+        printf("Attention : motifs non enregistrés pour %s\n", fichier);
+    }
+    motifs_liberer(&motifs);
+    solution_liberer(&solution);
+    etat_liberer(&etat);
+    niveau_liberer(&niveau);
+    plateau_liberer(&plateau);
+    return trouvee ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int mode_rejouer(char fichier[], char fichierDeplacements[]){
+    t_Plateau plateau = PLATEAU_VIDE;
+    t_tabDeplacement historique = HISTORIQUE_VIDE;
+    t_Niveau niveau;
+    t_Etat etat;
+    t_Rejeu rejeu;
+    size_t taille;
+    char * lettres;
+
+    moteur_verifier(charger_partie(&plateau, fichier));
+    moteur_verifier(etat_depuis_plateau(&plateau, &niveau, &etat));
+    moteur_verifier(fichier_lire(fichierDeplacements, &lettres, &taille));
+    rejouer(&niveau, &etat, lettres, taille, &historique, &rejeu);
+    moteur_verifier(etat_verifier(&niveau, &etat));
+    printf("Résolu : %s\n", rejeu.resolu ? "oui" : "non");
+    printf("Déplacements : %d\n", rejeu.nbDeplacements);
+    printf("Poussées : %d\n", rejeu.nbPoussees);
+    if (rejeu.premierIllegal != ZERO) {
+        printf("Premier déplacement illégal : n° %d ('%c')\n",
+            rejeu.premierIllegal, rejeu.lettreIllegale);
+    } else {
+        printf("Premier déplacement illégal : aucun\n");
+    }
+    printf("Durée : %lld us\n", rejeu.dureeUs);
+    if (rejeu.dureeUs > ZERO) {
+        printf("Débit : %.0f déplacements/s\n",
+            (double)rejeu.nbDeplacements * MICROSECONDES_PAR_SECONDE
+            / rejeu.dureeUs);
+    }
+    free(lettres);
+    historique_liberer(&historique);
+    etat_liberer(&etat);
+    niveau_liberer(&niveau);
+    plateau_liberer(&plateau);
+    return rejeu.resolu ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Compare deux lignes du manifeste par nom de niveau (pour qsort)
+ * @param a Adresse d'un pointeur vers une ligne
+ * @param b Adresse d'un pointeur vers une ligne
+ * @return Résultat de strcmp sur les noms de niveau
+ */
+static int verification_comparer(const void * a, const void * b){
+    const t_Verification * va = *(const t_Verification * const *)a;
+    const t_Verification * vb = *(const t_Verification * const *)b;
+    return strcmp(va->niveau, vb->niveau);
+}
+
+void lot_verification_lire(const char fichier[], t_LotVerification * lot,
+    char ** texte, int * nbNiveaux){
+
+    t_Plateau plateau = PLATEAU_VIDE;
+    t_Verification ** tries;
+    char * champs[2], * curseur, * finLigne;
+    size_t taille;
+    int capacite = ZERO, nbChamps, numLigne = ZERO;
+
+    moteur_verifier(fichier_lire(fichier, texte, &taille));
+    (*texte)[taille] = '\0';
+    lot->verifications = NULL;
+    lot->nbVerifications = ZERO;
+    // Les noms restent dans le texte : chaque fin de champ devient un '\0'
+    for (curseur = *texte ; curseur < *texte + taille ; curseur = finLigne) {
+        finLigne = strchr(curseur, '\n');
+        finLigne = finLigne == NULL ? *texte + taille : finLigne + 1;
+        numLigne++;
+        nbChamps = ZERO;
+        while (curseur < finLigne) {
+            curseur += strspn(curseur, " \t\r\n");
+            if (curseur >= finLigne) {
+                break;
+            }
+            if (nbChamps == 2) {
+                nbChamps++;
+                break;
+            }
+            champs[nbChamps++] = curseur;
+            curseur += strcspn(curseur, " \t\r\n");
+            *curseur++ = '\0';
+        }
+        if (nbChamps == ZERO) {
+            continue;
+        }
+        if (nbChamps != 2) {
+            printf("ERREUR MANIFESTE LIGNE %d", numLigne);
+            exit(EXIT_FAILURE);
+        }
+        if (lot->nbVerifications == capacite) {
+            capacite = capacite * DOUBLE + AJOUTER;
+            lot->verifications = allouer(lot->verifications,
+                capacite * sizeof(t_Verification));
+        }
+        lot->verifications[lot->nbVerifications].niveau = champs[0];
+        lot->verifications[lot->nbVerifications].deplacements = champs[1];
+        lot->nbVerifications++;
+    }
+
+    // Les lignes triées par niveau donnent les niveaux distincts
+    tries = allouer(NULL, (lot->nbVerifications + 1)
+        * sizeof(t_Verification *));
+    for (int i = ZERO ; i < lot->nbVerifications ; i++) {
+        tries[i] = &lot->verifications[i];
+    }
+    qsort(tries, lot->nbVerifications, sizeof(t_Verification *),
+        verification_comparer);
+    lot->niveaux = allouer(NULL, (lot->nbVerifications + 1)
+        * sizeof(t_Niveau));
+    lot->departs = allouer(NULL, (lot->nbVerifications + 1)
+        * sizeof(t_Etat));
+    *nbNiveaux = ZERO;
+    for (int i = ZERO ; i < lot->nbVerifications ; i++) {
+        if (i > ZERO && strcmp(tries[i]->niveau, tries[i - 1]->niveau) == 0) {
+            tries[i]->numNiveau = tries[i - 1]->numNiveau;
+        } else if (charger_partie(&plateau, tries[i]->niveau) == MOTEUR_OK
+            && etat_depuis_plateau(&plateau, &lot->niveaux[*nbNiveaux],
+            &lot->departs[*nbNiveaux]) == MOTEUR_OK) {
+            tries[i]->numNiveau = (*nbNiveaux)++;
+        } else {
+            // Niveau introuvable, absent du recueil ou invalide : seules ses
+            // lignes sont écartées
+            tries[i]->numNiveau = AUCUN_NIVEAU;
+        }
+    }
+    plateau_liberer(&plateau);
+    free(tries);
+}
+
+void lot_verification_liberer(t_LotVerification * lot, char * texte,
+    int nbNiveaux){
+
+    for (int i = ZERO ; i < nbNiveaux ; i++) {
+        etat_liberer(&lot->departs[i]);
+        niveau_liberer(&lot->niveaux[i]);
+    }
+    free(lot->niveaux);
+    free(lot->departs);
+    free(lot->verifications);
+    free(texte);
+}
+
+/**
+ * @brief Boucle d'un fil de vérification : prend la prochaine ligne du lot
+ * tant qu'il en reste. La position et l'historique du fil servent pour toutes
+ * ses lignes
+ * @param argument Le t_LotVerification partagé
+ * @return NULL
+ */
+static void * verificateur_travailler(void * argument){
+    t_LotVerification * lot = argument;
+    t_tabDeplacement historique = HISTORIQUE_VIDE;
+    t_Verification * v;
+    t_Etat etat = {NULL, ZERO, ZERO, false, ZERO};
+    int nbMotsEtat = ZERO, i;
+    long long debut;
+    size_t taille;
+    char * lettres;
+
+    while ((i = atomic_fetch_add(&lot->prochaine, 1))
+        < lot->nbVerifications) {
+        v = &lot->verifications[i];
+        debut = horloge_us();
+        if (v->numNiveau == AUCUN_NIVEAU || fichier_lire(v->deplacements,
+            &lettres, &taille) != MOTEUR_OK) {
+            v->verdict = VERIFIE_ILLISIBLE;
+            memset(&v->rejeu, 0, sizeof(v->rejeu));
+            v->dureeUs = horloge_us() - debut;
+            continue;
+        }
+        // La couche des caisses n'est réallouée que pour un niveau plus grand
+        if (lot->niveaux[v->numNiveau].nbMots > nbMotsEtat) {
+            etat_liberer(&etat);
+            nbMotsEtat = lot->niveaux[v->numNiveau].nbMots;
+            etat.caisses = couches_creer(nbMotsEtat, 1);
+        }
+        etat_restaurer(&lot->niveaux[v->numNiveau], &etat,
+            &lot->departs[v->numNiveau]);
+        rejouer(&lot->niveaux[v->numNiveau], &etat, lettres, taille,
+            &historique, &v->rejeu);
+        free(lettres);
+        v->verdict = v->rejeu.premierIllegal != ZERO ? VERIFIE_ILLEGAL
+            : v->rejeu.resolu ? VERIFIE_RESOLU : VERIFIE_NON_RESOLU;
+        v->dureeUs = horloge_us() - debut;
+    }
+    etat_liberer(&etat);
+    historique_liberer(&historique);
+    return NULL;
+}
+
+long long verifier_lot(t_LotVerification * lot, int nbFils){
+    pthread_t * fils = allouer(NULL, nbFils * sizeof(pthread_t));
+    long long debut = horloge_us();
+
+    atomic_init(&lot->prochaine, ZERO);
+    for (int i = ZERO ; i < nbFils ; i++) {
+        pthread_create(&fils[i], NULL, verificateur_travailler, lot);
+    }
+    for (int i = ZERO ; i < nbFils ; i++) {
+        pthread_join(fils[i], NULL);
+    }
+    free(fils);
+    return horloge_us() - debut;
+}
+
+int mode_verifier(char manifeste[], char fichierResultats[], int nbFils){
+    t_LotVerification lot;
+    int nbVerdicts[] = {ZERO, ZERO, ZERO, ZERO}, nbNiveaux;
+    long long duree, nbDeplacements = ZERO;
+    const t_Verification * v;
+    char * texte;
+    FILE * f;
+
+    if (nbFils < 1 || nbFils > NB_FILS_MAX) {
+        printf("Nombre de fils entre 1 et %d\n", NB_FILS_MAX);
+        return EXIT_FAILURE;
+    }
+    lot_verification_lire(manifeste, &lot, &texte, &nbNiveaux);
+    duree = verifier_lot(&lot, nbFils);
+    f = fopen(fichierResultats, "w");
+    if (f == NULL) {
+        printf("ERREUR SUR FICHIER");
+        exit(EXIT_FAILURE);
+    }
+    fprintf(f, "# niveau\tdeplacements\tverdict\tnbDeplacements\t"
+        "nbPoussees\tpremierIllegal\tdureeUs\n");
+    for (int i = ZERO ; i < lot.nbVerifications ; i++) {
+        v = &lot.verifications[i];
+        fprintf(f, "%s\t%s\t%s\t%d\t%d\t%d\t%lld\n", v->niveau,
+            v->deplacements, NOMS_VERDICTS[v->verdict],
+            v->rejeu.nbDeplacements, v->rejeu.nbPoussees,
+            v->rejeu.premierIllegal, v->dureeUs);
+        nbVerdicts[v->verdict]++;
+        nbDeplacements += v->rejeu.nbDeplacements;
+    }
+    fclose(f);
+    printf("Solutions : %d (%d niveaux distincts)\n", lot.nbVerifications,
+        nbNiveaux);
+    for (int i = ZERO ; i <= VERIFIE_ILLISIBLE ; i++) {
+        printf("%-10s : %d\n", NOMS_VERDICTS[i], nbVerdicts[i]);
+    }
+    printf("Durée : %.3f ms avec %d fils\n", (double)duree / MILLE, nbFils);
+    if (duree > ZERO) {
+        printf("Débit : %.0f solutions/s, %.0f déplacements/s\n",
+            (double)lot.nbVerifications * MICROSECONDES_PAR_SECONDE / duree,
+            (double)nbDeplacements * MICROSECONDES_PAR_SECONDE / duree);
+    }
+    lot_verification_liberer(&lot, texte, nbNiveaux);
+    return nbVerdicts[VERIFIE_RESOLU] == lot.nbVerifications ? EXIT_SUCCESS
+        : EXIT_FAILURE;
+}
+
+int mode_bench_verifier(char manifeste[]){
+    const int NB_FILS_BENCH[] = {1, 2, 4, 8, 16};
+    const int NB_MESURES = sizeof(NB_FILS_BENCH) / sizeof(NB_FILS_BENCH[0]);
+    t_LotVerification lot;
+    long long duree, dureeUnFil = ZERO, nbDeplacements = ZERO;
+    int nbNiveaux;
+    char * texte;
+
+    lot_verification_lire(manifeste, &lot, &texte, &nbNiveaux);
+    // Un premier passage met les fichiers de déplacements dans le cache
+    verifier_lot(&lot, 1);
+    for (int i = ZERO ; i < lot.nbVerifications ; i++) {
+        nbDeplacements += lot.verifications[i].rejeu.nbDeplacements;
+    }
+    printf("Processeurs disponibles : %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+    printf("Solutions : %d, déplacements : %lld\n", lot.nbVerifications,
+        nbDeplacements);
+    printf("%6s %12s %14s %16s %12s\n", "Fils", "Durée (ms)", "Solutions/s",
+        "Déplacements/s", "Accélération");
+    for (int m = ZERO ; m < NB_MESURES ; m++) {
+        duree = verifier_lot(&lot, NB_FILS_BENCH[m]);
+        if (m == ZERO) {
+            dureeUnFil = duree;
+        }
+        duree = duree > ZERO ? duree : 1;
+        printf("%6d %12.3f %14.0f %16.0f %12.2f\n", NB_FILS_BENCH[m],
+            (double)duree / MILLE,
+            (double)lot.nbVerifications * MICROSECONDES_PAR_SECONDE / duree,
+            (double)nbDeplacements * MICROSECONDES_PAR_SECONDE / duree,
+            (double)dureeUnFil / duree);
+    }
+    lot_verification_liberer(&lot, texte, nbNiveaux);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Ouvre le compteur matériel des erreurs de prédiction de branchement
+ * du processus (désactivé jusqu'à compteur_demarrer)
+ * @return Descripteur du compteur, -1 s'il n'est pas disponible
+ */
+static int compteur_branches_ouvrir(void){
+    struct perf_event_attr attributs;
+
+    memset(&attributs, 0, sizeof(attributs));
+    attributs.type = PERF_TYPE_HARDWARE;
+    attributs.size = sizeof(attributs);
+    attributs.config = PERF_COUNT_HW_BRANCH_MISSES;
+    attributs.disabled = 1;
+    attributs.exclude_kernel = 1;
+    attributs.exclude_hv = 1;
+    return syscall(SYS_perf_event_open, &attributs, 0, -1, -1, 0);
+}
+
+/**
+ * @brief Remet à zéro et lance le compteur de branches, s'il est ouvert
+ * @param compteur Descripteur du compteur ou -1
+ * @return Heure du début de la mesure en microsecondes
+ */
+static long long compteur_demarrer(int compteur){
+    if (compteur >= ZERO) {
+        ioctl(compteur, PERF_EVENT_IOC_RESET, 0);
+        ioctl(compteur, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    return horloge_us();
+}
+
+/**
+ * @brief Arrête la mesure et affiche le temps et les erreurs de prédiction
+ * par opération
+ * @param nom Nom de la mesure
+ * @param compteur Descripteur du compteur ou -1
+ * @param debut Heure du début de la mesure
+ * @param nbOperations Nombre d'opérations mesurées
+ */
+static void compteur_arreter(const char nom[], int compteur, long long debut,
+    int nbOperations){
+
+    long long duree = horloge_us() - debut;
+    uint64_t nbRates = ZERO;
+
+    if (compteur >= ZERO) {
+        ioctl(compteur, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(compteur, &nbRates, sizeof(nbRates)) != sizeof(nbRates)) {
+            nbRates = ZERO;
+        }
+        printf("%-26s %10.2f %16.4f\n", nom,
+            (double)duree * MILLE / nbOperations,
+            (double)nbRates / nbOperations);
+    } else {
+        printf("%-26s %10.2f %16s\n", nom,
+            (double)duree * MILLE / nbOperations, "-");
+    }
+}
+
+/**
+ * @brief Ancienne conversion d'une touche en direction, par tests en cascade,
+ * gardée comme référence pour le banc d'essai
+ * @param deplacement Touche appuyée
+ * @return Indice de la direction, AUCUNE_DIRECTION sinon
+ */
+static __attribute__((noinline)) int direction_touche_cascade(
+    char deplacement){
+
+    int direction = AUCUNE_DIRECTION;
+    if(deplacement == HAUT) {
+        direction = 0;
+    } else if (deplacement == BAS) {
+        direction = 1;
+    } else if (deplacement == GAUCHE) {
+        direction = 2;
+    } else if (deplacement == DROITE) {
+        direction = 3;
+    }
+    return direction;
+}
+
+/**
+ * @brief Ancien déplacement par tests en cascade sur la case suivante et
+ * celle d'après, gardé comme référence pour le banc d'essai (sans
+ * historique). Hors ligne, comme la version du moteur, pour que gcc ne
+ * l'intègre pas à la boucle mesurée
+ * @param niveau Partie fixe du niveau
+ * @param etat Caisses et position de Sokoban
+ * @param direction Indice de la direction
+ * @param nbDepla Adresse du compteur de déplacements
+ * @param histoDepla Ignoré
+ */
+static __attribute__((noinline)) void deplacer_direction_cascade(
+    const t_Niveau * niveau, t_Etat * etat, int direction, int *nbDepla,
+    t_tabDeplacement * histoDepla){
+
+    int decalage = niveau->decalages[direction];
+    int caisse = etat->caseSok + decalage, arrivee = caisse + decalage;
+
+    (void)histoDepla;
+    if (bit_lire(etat->caisses, caisse)) {
+        if (!bit_lire(niveau->murs, arrivee)
+            && !bit_lire(etat->caisses, arrivee)) {
+            bit_deplacer(etat->caisses, caisse, arrivee);
+            etat->empreinte ^= niveau->zobrist[caisse]
+                ^ niveau->zobrist[arrivee];
+            etat->nbCaissesHorsCible += bit_lire(niveau->cibles, caisse)
+                - bit_lire(niveau->cibles, arrivee);
+            etat->caseSok = caisse;
+            etat->blocage = etat->blocage
+                || poussee_bloquante(niveau, etat->caisses, arrivee);
+            *nbDepla = *nbDepla + 1;
+        }
+    } else if (!bit_lire(niveau->murs, caisse)) {
+        etat->caseSok = caisse;
+        *nbDepla = *nbDepla + 1;
+    }
+}
+
+/**
+ * @brief Mesure une conversion de touches en directions
+ * @param nom Nom de la mesure
+ * @param conversion Fonction mesurée (appelée par pointeur dans les deux cas
+ * pour que la comparaison soit juste)
+ * @param touches Touches à convertir
+ * @param nbCoups Nombre de touches
+ * @param compteur Descripteur du compteur de branches ou -1
+ * @return Somme des directions, pour vérifier les deux versions
+ */
+static long long bench_touches(const char nom[], int (*conversion)(char),
+    const char touches[], int nbCoups, int compteur){
+
+    long long somme = ZERO, debut = compteur_demarrer(compteur);
+
+    for (int i = ZERO ; i < nbCoups ; i++) {
+        somme += conversion(touches[i]);
+    }
+    compteur_arreter(nom, compteur, debut, nbCoups);
+    return somme;
+}
+
+/**
+ * @brief Mesure une suite de déplacements depuis la position de départ
+ * @param nom Nom de la mesure
+ * @param deplacement Fonction de déplacement mesurée
+ * @param niveau Partie fixe du niveau
+ * @param depart Position de départ
+ * @param etat État de travail, remis à la position de départ
+ * @param directions Directions à jouer
+ * @param nbCoups Nombre de directions
+ * @param compteur Descripteur du compteur de branches ou -1
+ * @return Nombre de déplacements effectués
+ */
+static int bench_deplacements(const char nom[],
+    void (*deplacement)(const t_Niveau *, t_Etat *, int, int *,
+    t_tabDeplacement *), const t_Niveau * niveau, const t_Etat * depart,
+    t_Etat * etat, const uint8_t directions[], int nbCoups, int compteur){
+
+    int nbDepla = ZERO;
+    long long debut;
+
+    etat_restaurer(niveau, etat, depart);
+    debut = compteur_demarrer(compteur);
+    for (int i = ZERO ; i < nbCoups ; i++) {
+        deplacement(niveau, etat, directions[i], &nbDepla, NULL);
+    }
+    compteur_arreter(nom, compteur, debut, nbCoups);
+    return nbDepla;
+}
+
+int mode_bench_deplacements(char fichier[], int nbCoups){
+    const int NB_TOUCHES = sizeof(TOUCHES_BENCH) - 1;
+    t_Plateau plateau = PLATEAU_VIDE;
+    t_Niveau niveau;
+    t_Etat depart, etat, etatCascade;
+    char * touches;
+    uint8_t * directions;
+    long long sommeCascade, sommeTable;
+    int nbDeplaCascade, nbDeplaTable, compteur;
+    bool identiques;
+
+    if (nbCoups < 1) {
+        printf("Nombre de coups au moins égal à 1\n");
+        return EXIT_FAILURE;
+    }
+    moteur_verifier(charger_partie(&plateau, fichier));
+    moteur_verifier(etat_depuis_plateau(&plateau, &niveau, &depart));
+    moteur_verifier(etat_copier(&niveau, &etat, &depart));
+    moteur_verifier(etat_copier(&niveau, &etatCascade, &depart));
+    touches = allouer(NULL, nbCoups);
+    directions = allouer(NULL, nbCoups);
+    // Le hasard rend chaque branche des tests en cascade imprévisible
+    srand(1);
+    for (int i = ZERO ; i < nbCoups ; i++) {
+        touches[i] = TOUCHES_BENCH[rand() % NB_TOUCHES];
+        directions[i] = rand() % NB_DIRECTIONS;
+    }
+    compteur = compteur_branches_ouvrir();
+    if (compteur < ZERO) {
+        printf("Compteur de branches indisponible (%s) : temps seuls\n",
+            strerror(errno));
+    }
+    printf("Coups par mesure : %d\n", nbCoups);
+    printf("%-26s %10s %16s\n", "Mesure", "ns/coup", "Erreurs/coup");
+    sommeCascade = bench_touches("touche (cascade)", direction_touche_cascade,
+        touches, nbCoups, compteur);
+    sommeTable = bench_touches("touche (table)", direction_touche, touches,
+        nbCoups, compteur);
+    nbDeplaCascade = bench_deplacements("coup (cascade)",
+        deplacer_direction_cascade, &niveau, &depart, &etatCascade,
+        directions, nbCoups, compteur);
+    nbDeplaTable = bench_deplacements("coup (table)",
+        deplacer_direction, &niveau, &depart, &etat, directions, nbCoups,
+        compteur);
+    identiques = sommeCascade == sommeTable && nbDeplaCascade == nbDeplaTable
+        && etat.caseSok == etatCascade.caseSok
+        && etat.nbCaissesHorsCible == etatCascade.nbCaissesHorsCible
+        && etat.blocage == etatCascade.blocage
+        && memcmp(etat.caisses, etatCascade.caisses,
+        niveau.nbMots * sizeof(uint64_t)) == ZERO;
+    printf("Déplacements effectués : %d, positions identiques : %s\n",
+        nbDeplaTable, identiques ? "oui" : "non");
+    if (compteur >= ZERO) {
+        close(compteur);
+    }
+    free(touches);
+    free(directions);
+    etat_liberer(&etatCascade);
+    etat_liberer(&etat);
+    etat_liberer(&depart);
+    niveau_liberer(&niveau);
+    plateau_liberer(&plateau);
+    return identiques ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Prépare une marche au hasard sans poussée : à chaque pas, la
+ * première direction libre à partir de celle tirée au hasard
+ * @param niveau Partie fixe du niveau
+ * @param depart Position de départ de la marche
+ * @param touches Touches à remplir
+ * @param nbDeplacements Nombre de touches
+ */
+static void marche_preparer(const t_Niveau * niveau, const t_Etat * depart,
+    char touches[], int nbDeplacements){
+
+    t_Etat etat;
+    int nbDepla = ZERO, direction, suivante;
+
+    moteur_verifier(etat_copier(niveau, &etat, depart));
+    srand(1);
+    for (int i = ZERO ; i < nbDeplacements ; i++) {
+        direction = rand() % NB_DIRECTIONS;
+        for (int essai = ZERO ; essai < NB_DIRECTIONS ; essai++) {
+            suivante = etat.caseSok + niveau->decalages[direction];
+            if (!bit_lire(niveau->murs, suivante)
+                && !bit_lire(etat.caisses, suivante)) {
+                break;
+            }
+            direction = (direction + 1) % NB_DIRECTIONS;
+        }
+        touches[i] = TOUCHES_DIRECTIONS[direction];
+        deplacer_direction(niveau, &etat, direction, &nbDepla, NULL);
+    }
+    etat_liberer(&etat);
+}
+
+/**
+ * @brief Construit un couloir d'une ligne où Sokoban pousse une caisse vers
+ * la droite jusqu'à la cible du bout (largeur - 4 poussées)
+ * @param plateau Plateau à remplir
+ * @param largeur Nombre de colonnes, murs compris
+ */
+static void couloir_construire(t_Plateau * plateau, int largeur){
+    const int NB_LIGNES_COULOIR = 3;
+
+    moteur_verifier(plateau_allouer(plateau, NB_LIGNES_COULOIR, largeur));
+    memset(plateau->cases, MUR, NB_LIGNES_COULOIR * largeur);
+    memset(plateau->cases + largeur + BORDURE, RIEN, largeur - DOUBLE);
+    plateau->cases[largeur + 1] = SOKOBAN;
+    plateau->cases[largeur + 2] = CAISSE;
+    plateau->cases[DOUBLE * largeur - 2] = CIBLE;
+    plateau->ligneSok = 1;
+    plateau->colonneSok = 1;
+    plateau->nbCaisses = 1;
+    plateau->nbCibles = 1;
+}
+
+/**
+ * @brief Commence une répétition d'une mesure
+ * @param allocations Adresse où ranger le compteur d'allocations du début
+ * @return Heure du début en microsecondes
+ */
+static long long mesure_demarrer(long long * allocations){
+    *allocations = nb_allocations();
+    return horloge_us();
+}
+
+/**
+ * @brief Termine une répétition et garde la meilleure durée et le plus petit
+ * nombre d'allocations des répétitions
+ * @param mesure Mesure à compléter (dureeUs négative avant la première)
+ * @param debut Heure du début de la répétition
+ * @param allocations Compteur d'allocations au début de la répétition
+ */
+static void mesure_terminer(t_Mesure * mesure, long long debut,
+    long long allocations){
+
+    long long duree = horloge_us() - debut;
+
+    if (mesure->dureeUs < ZERO || duree < mesure->dureeUs) {
+        mesure->dureeUs = duree > ZERO ? duree : 1;
+    }
+    // Sans compteur, nbAllocations reste négative
+    if (allocations == ALLOCATIONS_NON_COMPTEES) {
+        return;
+    }
+    allocations = nb_allocations() - allocations;
+    if (mesure->nbAllocations < ZERO || allocations < mesure->nbAllocations) {
+        mesure->nbAllocations = allocations;
+    }
+}
+
+/**
+ * @brief Temps moyen d'une opération
+ * @param mesure Mesure terminée
+ * @return Nanosecondes par opération
+ */
+static double mesure_ns_par_operation(const t_Mesure * mesure){
+    return (double)mesure->dureeUs * MILLE / mesure->nbOperations;
+}
+
+/**
+ * @brief Nombre moyen d'allocations d'une opération
+ * @param mesure Mesure terminée
+ * @return Allocations par opération, ALLOCATIONS_NON_COMPTEES si le moteur
+ * ne les compte pas
+ */
+static double mesure_allocations_par_operation(const t_Mesure * mesure){
+    return mesure->nbAllocations < ZERO ? ALLOCATIONS_NON_COMPTEES
+        : (double)mesure->nbAllocations / mesure->nbOperations;
+}
+
+/**
+ * @brief Écrit les mesures en JSON, une mesure par ligne
+ * @param f Fichier ouvert en écriture
+ * @param fichier Fichier du niveau mesuré
+ * @param mesures Mesures terminées
+ */
+static void mesures_ecrire_json(FILE * f, const char fichier[],
+    const t_Mesure mesures[]){
+
+    fprintf(f, "{\n  \"niveau\": \"");
+    for (int i = ZERO ; fichier[i] != '\0' ; i++) {
+        if (fichier[i] == '"' || fichier[i] == '\\') {
+            fputc('\\', f);
+        }
+        fputc(fichier[i], f);
+    }
+    fprintf(f, "\",\n  \"repetitions\": %d,\n  \"mesures\": [\n",
+        NB_REPETITIONS_BENCH);
+    for (int i = ZERO ; i < NB_MESURES ; i++) {
+        fprintf(f, "    {\"nom\": \"%s\", \"operations\": %lld, "
+            "\"ns_par_op\": %.3f, \"ops_par_s\": %.1f, "
+            "\"allocations_par_op\": %.6f}%s\n", mesures[i].nom,
+            mesures[i].nbOperations, mesure_ns_par_operation(&mesures[i]),
+            (double)mesures[i].nbOperations * MICROSECONDES_PAR_SECONDE
+            / mesures[i].dureeUs, mesure_allocations_par_operation(&mesures[i]),
+            i + 1 < NB_MESURES ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+/**
+ * @brief Cherche une mesure dans un JSON écrit par mesures_ecrire_json
+ * @param texte Contenu du fichier, terminé par '\0'
+ * @param nom Nom de la mesure
+ * @param nsParOperation Adresse où ranger le temps par opération
+ * @param allocationsParOperation Adresse où ranger les allocations par
+ * opération
+ * @return true si la mesure a été trouvée
+ */
+static bool reference_lire(const char texte[], const char nom[],
+    double * nsParOperation, double * allocationsParOperation){
+
+    char cle[TAILLE_TEXTE_ECRAN];
+    const char * position;
+
+    snprintf(cle, sizeof(cle), "\"nom\": \"%s\"", nom);
+    position = strstr(texte, cle);
+    return position != NULL && sscanf(position + strlen(cle),
+        ", \"operations\": %*d, \"ns_par_op\": %lf, \"ops_par_s\": %*f, "
+        "\"allocations_par_op\": %lf", nsParOperation,
+        allocationsParOperation) == 2;
+}
+
+int mode_bench(char fichier[], char fichierResultats[],
+    char fichierReference[]){
+
+    const long long NB_OPERATIONS[] = {NB_CHARGEMENTS_BENCH,
+        NB_DEPLACEMENTS_BENCH, NB_DEPLACEMENTS_BENCH, NB_DEPLACEMENTS_BENCH,
+        NB_APPELS_GAGNE_BENCH, NB_IMAGES_BENCH, NB_IMAGES_BENCH,
+        NB_IMAGES_BENCH, NB_ENREGISTREMENTS_BENCH, NB_IMAGES_BENCH};
+    const int NB_POUSSEES_COULOIR = LARGEUR_COULOIR_BENCH - 4;
+    t_Plateau plateau = PLATEAU_VIDE, couloir = PLATEAU_VIDE;
+    t_Niveau niveau, niveauCouloir;
+    t_Etat depart, etat, departCouloir, etatCouloir;
+    t_tabDeplacement histoDepla = HISTORIQUE_VIDE;
+    t_Mesure mesures[NB_MESURES];
+    t_Ecran ecran;
+    char * touches, * texte;
+    long long debut, allocations;
+    double nsReference, allocationsReference, ecart;
+    int nbDepla, nbGagnes = ZERO, nbRegressions = ZERO;
+    size_t taille;
+    FILE * f;
+
+    moteur_verifier(charger_partie(&plateau, fichier));
+    moteur_verifier(etat_depuis_plateau(&plateau, &niveau, &depart));
+    moteur_verifier(etat_copier(&niveau, &etat, &depart));
+    couloir_construire(&couloir, LARGEUR_COULOIR_BENCH);
+    moteur_verifier(etat_depuis_plateau(&couloir, &niveauCouloir,
+        &departCouloir));
+    moteur_verifier(etat_copier(&niveauCouloir, &etatCouloir, &departCouloir));
+    touches = allouer(NULL, NB_DEPLACEMENTS_BENCH);
+    marche_preparer(&niveau, &depart, touches, NB_DEPLACEMENTS_BENCH);
+    ecran_initialiser(&ecran);
+    for (int i = ZERO ; i < NB_MESURES ; i++) {
+        mesures[i] = (t_Mesure){NOMS_MESURES[i], NB_OPERATIONS[i], INVERSE,
+            INVERSE};
+    }
+    // Les mesures sont entrelacées d'une répétition à l'autre et seule la
+    // meilleure est gardée, ce qui écarte les interruptions du système
+    for (int r = ZERO ; r < NB_REPETITIONS_BENCH ; r++) {
+        debut = mesure_demarrer(&allocations);
+        for (int i = ZERO ; i < NB_CHARGEMENTS_BENCH ; i++) {
+            moteur_verifier(charger_partie(&plateau, fichier));
+        }
+        mesure_terminer(&mesures[MESURE_CHARGER], debut, allocations);
+
+        // Chaque répétition part d'un historique vide, comme une partie
+        historique_liberer(&histoDepla);
+        etat_restaurer(&niveau, &etat, &depart);
+        nbDepla = ZERO;
+        debut = mesure_demarrer(&allocations);
+        for (int i = ZERO ; i < NB_DEPLACEMENTS_BENCH ; i++) {
+            deplacer(&niveau, &etat, touches[i], &nbDepla, &histoDepla);
+        }
+        mesure_terminer(&mesures[MESURE_MARCHE], debut, allocations);
+
+        debut = mesure_demarrer(&allocations);
+        for (int i = ZERO ; i < NB_ENREGISTREMENTS_BENCH ; i++) {
+            moteur_verifier(enregistrer_deplacements(&histoDepla,
+                nbDepla < TAILLE_ENREGISTREMENT_BENCH ? nbDepla
+                : TAILLE_ENREGISTREMENT_BENCH, (char *)FICHIER_BENCH));
+        }
+        mesure_terminer(&mesures[MESURE_ENREGISTRER], debut, allocations);
+
+        mesures[MESURE_ANNULATION].nbOperations = nbDepla > ZERO ? nbDepla : 1;
+        debut = mesure_demarrer(&allocations);
+        while (nbDepla > ZERO) {
+            annulation_deplacer(&niveau, &etat, &nbDepla, &histoDepla);
+        }
+        mesure_terminer(&mesures[MESURE_ANNULATION], debut, allocations);
+
+        // La caisse est ramenée au début du couloir quand elle arrive au bout
+        historique_liberer(&histoDepla);
+        debut = mesure_demarrer(&allocations);
+        for (int i = ZERO ; i < NB_DEPLACEMENTS_BENCH ; i++) {
+            if (i % NB_POUSSEES_COULOIR == ZERO) {
+                etat_restaurer(&niveauCouloir, &etatCouloir, &departCouloir);
+                initialiser_historique_deplacement(&histoDepla);
+                nbDepla = ZERO;
+            }
+            deplacer(&niveauCouloir, &etatCouloir, DROITE, &nbDepla,
+                &histoDepla);
+        }
+        mesure_terminer(&mesures[MESURE_POUSSEE], debut, allocations);
+
+        debut = mesure_demarrer(&allocations);
+        for (int i = ZERO ; i < NB_APPELS_GAGNE_BENCH ; i++) {
+            nbGagnes += gagne(&niveau, &depart);
+        }
+        mesure_terminer(&mesures[MESURE_GAGNE], debut, allocations);
+
+        moteur_verifier(etat_vers_plateau(&niveau, &depart, &plateau));
+        for (int zoom = ZOOM1 ; zoom <= ZOOM3 ; zoom++) {
+            debut = mesure_demarrer(&allocations);
+            for (int i = ZERO ; i < NB_IMAGES_BENCH ; i++) {
+                ecran_commencer(&ecran);
+                afficher_plateau(&plateau, zoom, &ecran);
+            }
+            mesure_terminer(&mesures[MESURE_ZOOM1 + zoom - ZOOM1], debut,
+                allocations);
+        }
+        debut = mesure_demarrer(&allocations);
+        for (int i = ZERO ; i < NB_IMAGES_BENCH ; i++) {
+            ecran_commencer(&ecran);
+            afficher_plateau(&plateau, ZOOM_BENCH_GRAND, &ecran);
+        }
+        mesure_terminer(&mesures[MESURE_ZOOM8], debut, allocations);
+    }
+    remove(FICHIER_BENCH);
+
+    (void)nbGagnes;
+    // Le tableau n'est pas affiché quand le JSON est écrit à l'écran
+    if (fichierResultats == NULL
+        || strcmp(fichierResultats, SORTIE_STANDARD) != ZERO) {
+        printf("Niveau : %s, meilleure de %d répétitions\n", fichier,
+            NB_REPETITIONS_BENCH);
+        if (nb_allocations() == ALLOCATIONS_NON_COMPTEES) {
+            printf("Allocations non comptées (compiler avec "
+                "-DCOMPTER_ALLOCATIONS)\n");
+        }
+        printf("%-26s %12s %14s %12s\n", "Mesure", "ns/op", "ops/s",
+            "alloc/op");
+        for (int i = ZERO ; i < NB_MESURES ; i++) {
+            printf("%-26s %12.1f %14.0f ", mesures[i].nom,
+                mesure_ns_par_operation(&mesures[i]),
+                (double)mesures[i].nbOperations * MICROSECONDES_PAR_SECONDE
+                / mesures[i].dureeUs);
+            if (mesures[i].nbAllocations < ZERO) {
+                printf("%12s\n", "-");
+            } else {
+                printf("%12.4f\n", mesure_allocations_par_operation(
+                    &mesures[i]));
+            }
+        }
+    }
+    if (fichierResultats != NULL) {
+        f = strcmp(fichierResultats, SORTIE_STANDARD) == ZERO ? stdout
+            : fopen(fichierResultats, "w");
+        if (f == NULL) {
+            printf("ERREUR SUR FICHIER");
+            exit(EXIT_FAILURE);
+        }
+        mesures_ecrire_json(f, fichier, mesures);
+        if (f != stdout) {
+            fclose(f);
+        }
+    }
+
+    // Une mesure régresse si elle est plus lente au-delà du seuil ou si elle
+    // fait au moins une allocation de plus (quand les deux sont comptées)
+    if (fichierReference != NULL) {
+        moteur_verifier(fichier_lire(fichierReference, &texte, &taille));
+        texte[taille] = '\0';
+        printf("\nComparaison avec %s (seuil %.0f %%) :\n", fichierReference,
+            SEUIL_REGRESSION * 100);
+        for (int i = ZERO ; i < NB_MESURES ; i++) {
+            if (!reference_lire(texte, mesures[i].nom, &nsReference,
+                &allocationsReference)) {
+                printf("%-26s absente de la référence\n", mesures[i].nom);
+                continue;
+            }
+            ecart = mesure_ns_par_operation(&mesures[i]) / nsReference - 1;
+            if (ecart > SEUIL_REGRESSION
+                || (mesures[i].nbAllocations >= ZERO
+                && allocationsReference >= ZERO
+                && mesure_allocations_par_operation(&mesures[i])
+                > allocationsReference + 0.5 / mesures[i].nbOperations)) {
+                nbRegressions++;
+                printf("%-26s %+8.1f %%  RÉGRESSION\n", mesures[i].nom,
+                    ecart * 100);
+            } else {
+                printf("%-26s %+8.1f %%\n", mesures[i].nom, ecart * 100);
+            }
+        }
+        printf("Régressions : %d\n", nbRegressions);
+        free(texte);
+    }
+
+    free(touches);
+    ecran_liberer(&ecran);
+    historique_liberer(&histoDepla);
+    etat_liberer(&etatCouloir);
+    etat_liberer(&departCouloir);
+    niveau_liberer(&niveauCouloir);
+    etat_liberer(&etat);
+    etat_liberer(&depart);
+    niveau_liberer(&niveau);
+    plateau_liberer(&couloir);
+    plateau_liberer(&plateau);
+    return nbRegressions == ZERO ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void solution_liberer(t_Solution * solution){
+    historique_liberer(&solution->deplacements);
+    solution->nbDeplacements = ZERO;
+}
+
+int zone_accessible(t_Solveur * solveur, const uint64_t caisses[],
+    int caseSok, int precedent[]){
+
+    int debut = ZERO, fin = ZERO, numCase, voisine, plusPetite = caseSok;
+
+    // Parcours en largeur : une marque égale à la génération = case visitée
+    solveur->generation++;
+    solveur->marque[caseSok] = solveur->generation;
+    solveur->file[fin++] = caseSok;
+    while (debut < fin) {
+        numCase = solveur->file[debut++];
+        for (int d = ZERO ; d < NB_DIRECTIONS ; d++) {
+            voisine = numCase + solveur->niveau->decalages[d];
+            if (solveur->marque[voisine] != solveur->generation
+                && !bit_lire(solveur->niveau->murs, voisine)
+                && !bit_lire(caisses, voisine)) {
+
+                solveur->marque[voisine] = solveur->generation;
+                solveur->file[fin++] = voisine;
+                if (precedent != NULL) {
+                    precedent[voisine] = d;
+                }
+                if (voisine < plusPetite) {
+                    plusPetite = voisine;
+                }
+            }
+        }
+    }
+    solveur->tailleZone = fin;
+    return plusPetite;
+}
+
+/**
+ * @brief Indique si Sokoban a atteint une case lors du dernier parcours
+ * @param solveur Solveur qui a fait le parcours
+ * @param numCase Case à tester
+ * @return true si la case est dans la zone de Sokoban
+ */
+static inline bool case_accessible(const t_Solveur * solveur, int numCase){
+    return solveur->marque[numCase] == solveur->generation;
+}
+
+/**
+ * @brief Donne le coût d'une paire de l'affectation : les poussées qu'il faut
+ * au moins pour amener la caisse d'une ligne sur une cible
+ * @param solveur Solveur contenant les distances précalculées
+ * @param ligne Ligne de la caisse (à partir de 1)
+ * @param cible Colonne de la cible (à partir de 1)
+ * @return Nombre de poussées, INFINI_POUSSEES si c'est impossible
+ */
+static inline int64_t affectation_cout(const t_Solveur * solveur, int ligne,
+    int cible){
+
+    return solveur->distancesPoussees[(size_t)(cible - 1)
+        * solveur->niveau->nbCases + solveur->affectation.lignes[ligne - 1]];
+}
+
+/**
+ * @brief Ajoute une ligne à l'affectation : cherche le chemin augmentant de
+ * plus petit coût réduit depuis cette ligne (méthode hongroise), en
+ * corrigeant les potentiels à chaque cible atteinte, puis échange les paires
+ * le long du chemin. Une ligne coûte O(nbCaisses * nbCibles)
+ * @param solveur Solveur contenant l'affectation
+ * @param ligne Ligne à ajouter, dont le potentiel est réalisable
+ */
+static void affectation_ajouter(t_Solveur * solveur, int ligne){
+    t_Affectation * a = &solveur->affectation;
+    int cible = ZERO, suivante = ZERO, ligneCourante;
+    int64_t ecart, plusPetit;
+
+    for (int j = ZERO ; j <= solveur->nbCibles ; j++) {
+        a->ecarts[j] = INT64_MAX;
+        a->vues[j] = false;
+    }
+    a->ligneDeCible[0] = ligne;
+    do {
+        a->vues[cible] = true;
+        ligneCourante = a->ligneDeCible[cible];
+        plusPetit = INT64_MAX;
+        for (int j = 1 ; j <= solveur->nbCibles ; j++) {
+            if (a->vues[j]) {
+                continue;
+            }
+            ecart = affectation_cout(solveur, ligneCourante, j)
+                - a->potentielsLignes[ligneCourante] - a->potentielsCibles[j];
+            if (ecart < a->ecarts[j]) {
+                a->ecarts[j] = ecart;
+                a->cibleAvant[j] = cible;
+            }
+            if (a->ecarts[j] < plusPetit) {
+                plusPetit = a->ecarts[j];
+                suivante = j;
+            }
+        }
+        for (int j = ZERO ; j <= solveur->nbCibles ; j++) {
+            if (a->vues[j]) {
+                a->potentielsLignes[a->ligneDeCible[j]] += plusPetit;
+                a->potentielsCibles[j] -= plusPetit;
+            } else {
+                a->ecarts[j] -= plusPetit;
+            }
+        }
+        cible = suivante;
+    } while (a->ligneDeCible[cible] != ZERO);
+    // Les paires sont décalées le long du chemin, de la cible libre atteinte
+    // jusqu'à la ligne ajoutée
+    do {
+        suivante = a->cibleAvant[cible];
+        a->ligneDeCible[cible] = a->ligneDeCible[suivante];
+        cible = suivante;
+    } while (cible != ZERO);
+}
+
+/**
+ * @brief Additionne les coûts des paires de l'affectation
+ * @param solveur Solveur contenant l'affectation
+ * @return Coût total, au plus INFINI_POUSSEES
+ */
+static int affectation_total(const t_Solveur * solveur){
+    int64_t total = ZERO;
+
+    for (int j = 1 ; j <= solveur->nbCibles ; j++) {
+        if (solveur->affectation.ligneDeCible[j] != ZERO) {
+            total += affectation_cout(solveur,
+                solveur->affectation.ligneDeCible[j], j);
+        }
+    }
+    return total < INFINI_POUSSEES ? total : INFINI_POUSSEES;
+}
+
+/**
+ * @brief Recopie l'affectation dans sa sauvegarde, ou l'inverse
+ * @param solveur Solveur contenant l'affectation
+ * @param sauver true pour sauver, false pour restaurer
+ */
+static void affectation_recopier(t_Solveur * solveur, bool sauver){
+    t_Affectation * a = &solveur->affectation;
+    size_t tailleLignes = (solveur->nbCaisses + 1) * sizeof(int64_t);
+    size_t tailleCibles = (solveur->nbCibles + 1) * sizeof(int64_t);
+    size_t tailleLigneDeCible = (solveur->nbCibles + 1) * sizeof(int32_t);
+
+    if (sauver) {
+        memcpy(a->sauvePotentielsLignes, a->potentielsLignes, tailleLignes);
+        memcpy(a->sauvePotentielsCibles, a->potentielsCibles, tailleCibles);
+        memcpy(a->sauveLigneDeCible, a->ligneDeCible, tailleLigneDeCible);
+    } else {
+        memcpy(a->potentielsLignes, a->sauvePotentielsLignes, tailleLignes);
+        memcpy(a->potentielsCibles, a->sauvePotentielsCibles, tailleCibles);
+        memcpy(a->ligneDeCible, a->sauveLigneDeCible, tailleLigneDeCible);
+    }
+}
+
+/**
+ * @brief Calcule entièrement l'affectation de coût minimal des caisses de
+ * la table des lignes
+ * @param solveur Solveur contenant l'affectation
+ * @return Coût de l'affectation, au plus INFINI_POUSSEES
+ */
+static int affectation_calculer(t_Solveur * solveur){
+    t_Affectation * a = &solveur->affectation;
+
+    memset(a->potentielsLignes, 0, (solveur->nbCaisses + 1) * sizeof(int64_t));
+    memset(a->potentielsCibles, 0, (solveur->nbCibles + 1) * sizeof(int64_t));
+    memset(a->ligneDeCible, 0, (solveur->nbCibles + 1) * sizeof(int32_t));
+    for (int ligne = 1 ; ligne <= solveur->nbCaisses ; ligne++) {
+        affectation_ajouter(solveur, ligne);
+    }
+    return affectation_total(solveur);
+}
+
+/**
+ * @brief Minorant du nombre de poussées restantes d'une position, selon le
+ * type de minorant du solveur. Les poussées sont comptées sur le plateau vide
+ * (distancesPoussees) : le minorant reste admissible. La position devient
+ * celle du père pour minorant_poussee()
+ * @param solveur Solveur contenant les distances précalculées
+ * @param caisses Cases des caisses
+ * @return Nombre minimal de poussées pour finir, INFINI_POUSSEES si une
+ * caisse ne peut plus atteindre de cible
+ */
+static int minorant(t_Solveur * solveur, const int32_t caisses[]){
+    int total = ZERO;
+
+    if (solveur->typeMinorant == MINORANT_AFFECTATION) {
+        memcpy(solveur->affectation.lignes, caisses,
+            solveur->nbCaisses * sizeof(int32_t));
+        total = affectation_calculer(solveur);
+        affectation_recopier(solveur, true);
+    } else {
+        for (int i = ZERO ; i < solveur->nbCaisses ; i++) {
+            total += solveur->distanceCible[caisses[i]];
+        }
+        total = total < INFINI_POUSSEES ? total : INFINI_POUSSEES;
+    }
+    solveur->minorantPere = total;
+    return total;
+}
+
+/**
+ * @brief Minorant d'un fils du dernier père passé à minorant() : seule la
+ * caisse poussée change. Pour l'affectation, l'affectation du père est
+ * reprise, la ligne de la caisse est retirée et ajoutée de nouveau avec ses
+ * nouveaux coûts ; seule cette ligne est recalculée
+ * @param solveur Solveur contenant les distances précalculées
+ * @param caisses Cases des caisses du père
+ * @param i Indice de la caisse poussée dans caisses
+ * @param arrivee Case de la caisse après la poussée
+ * @return Nombre minimal de poussées pour finir depuis le fils
+ */
+static int minorant_poussee(t_Solveur * solveur, const int32_t caisses[],
+    int i, int arrivee){
+
+    t_Affectation * a = &solveur->affectation;
+    int ligne = i + 1, total;
+    int64_t reduit;
+
+    if (solveur->typeMinorant == MINORANT_PLUS_PROCHES) {
+        total = solveur->minorantPere - solveur->distanceCible[caisses[i]]
+            + solveur->distanceCible[arrivee];
+        return solveur->minorantPere < INFINI_POUSSEES
+            && total < INFINI_POUSSEES ? total : INFINI_POUSSEES;
+    }
+    affectation_recopier(solveur, false);
+    a->lignes[i] = arrivee;
+    if (solveur->nbCaisses < solveur->nbCibles) {
+        // Une cible libérée garderait un potentiel qui fausserait le
+        // résultat : l'affectation est refaite
+        total = affectation_calculer(solveur);
+    } else {
+        for (int j = 1 ; j <= solveur->nbCibles ; j++) {
+            if (a->ligneDeCible[j] == ligne) {
+                a->ligneDeCible[j] = ZERO;
+            }
+        }
+        // Plus grand potentiel réalisable de la ligne avec ses nouveaux coûts
+        a->potentielsLignes[ligne] = INT64_MAX;
+        for (int j = 1 ; j <= solveur->nbCibles ; j++) {
+            reduit = affectation_cout(solveur, ligne, j)
+                - a->potentielsCibles[j];
+            if (reduit < a->potentielsLignes[ligne]) {
+                a->potentielsLignes[ligne] = reduit;
+            }
+        }
+        affectation_ajouter(solveur, ligne);
+        total = affectation_total(solveur);
+    }
+    a->lignes[i] = caisses[i];
+    return total;
+}
+
+/**
+ * @brief Ajoute une entrée dans le tas des noeuds à développer
+ * @param solveur Solveur contenant le tas
+ * @param entree Entrée à ajouter
+ */
+static void tas_ajouter(t_Solveur * solveur, t_EntreeTas entree){
+    uint32_t i, parent;
+
+    if (solveur->tailleTas == solveur->capaciteTas) {
+        solveur->capaciteTas *= DOUBLE;
+        solveur->tas = allouer(solveur->tas,
+            solveur->capaciteTas * sizeof(t_EntreeTas));
+    }
+    // Remonte l'entrée tant qu'elle est meilleure que son parent ; à
+    // estimation égale on préfère le noeud le plus profond
+    i = solveur->tailleTas++;
+    while (i > ZERO) {
+        parent = (i - 1) / DOUBLE;
+        if (solveur->tas[parent].estimation < entree.estimation
+            || (solveur->tas[parent].estimation == entree.estimation
+            && solveur->tas[parent].poussees >= entree.poussees)) {
+            break;
+        }
+        solveur->tas[i] = solveur->tas[parent];
+        i = parent;
+    }
+    solveur->tas[i] = entree;
+}
+
+/**
+ * @brief Retire la meilleure entrée du tas
+ * @param solveur Solveur contenant le tas (non vide)
+ * @return Entrée retirée
+ */
+static t_EntreeTas tas_retirer(t_Solveur * solveur){
+    t_EntreeTas meilleure = solveur->tas[0];
+    t_EntreeTas derniere = solveur->tas[--solveur->tailleTas];
+    uint32_t i = ZERO, enfant;
+
+    while ((enfant = i * DOUBLE + 1) < solveur->tailleTas) {
+        if (enfant + 1 < solveur->tailleTas
+            && (solveur->tas[enfant + 1].estimation
+            < solveur->tas[enfant].estimation
+            || (solveur->tas[enfant + 1].estimation
+            == solveur->tas[enfant].estimation
+            && solveur->tas[enfant + 1].poussees
+            > solveur->tas[enfant].poussees))) {
+            enfant++;
+        }
+        if (derniere.estimation < solveur->tas[enfant].estimation
+            || (derniere.estimation == solveur->tas[enfant].estimation
+            && derniere.poussees >= solveur->tas[enfant].poussees)) {
+            break;
+        }
+        solveur->tas[i] = solveur->tas[enfant];
+        i = enfant;
+    }
+    solveur->tas[i] = derniere;
+    return meilleure;
+}
+
+/**
+ * @brief Numérote les cases de sol d'un niveau : celles où Sokoban peut
+ * marcher quand il n'y a pas de caisse, les seules où une caisse peut aller
+ * @param ensemble Ensemble à préparer, vide
+ * @param niveau Partie fixe du niveau
+ * @param depart Position de départ
+ */
+static void ensemble_preparer(t_EnsembleEtats * ensemble,
+    const t_Niveau * niveau, const t_Etat * depart){
+
+    uint64_t * vide = couches_creer(niveau->nbMots, DOUBLE);
+    uint64_t * sol = vide + niveau->nbMots;
+
+    memset(ensemble, 0, sizeof(*ensemble));
+    ensemble->niveau = niveau;
+    zone_remplir(niveau, vide, depart->caseSok, sol);
+    ensemble->numeroSol = allouer(NULL, niveau->nbCases * sizeof(int32_t));
+    ensemble->caseSol = allouer(NULL, niveau->nbCases * sizeof(int32_t));
+    // Les indices suivent l'ordre des cases : des caisses triées par case le
+    // restent par indice de sol
+    for (int numCase = ZERO ; numCase < niveau->nbCases ; numCase++) {
+        ensemble->numeroSol[numCase] = AUCUNE_CASE;
+        if (bit_lire(sol, numCase)) {
+            ensemble->numeroSol[numCase] = ensemble->nbSol;
+            ensemble->caseSol[ensemble->nbSol++] = numCase;
+        }
+    }
+    for (ensemble->octetsSok = 1 ;
+        ensemble->octetsSok < (int)sizeof(int32_t)
+        && ensemble->nbSol > 1 << (ensemble->octetsSok * BITS_PAR_OCTET) ;
+        ensemble->octetsSok++) {
+    }
+    ensemble->taille = (ensemble->nbSol + BITS_PAR_OCTET - 1) / BITS_PAR_OCTET
+        + ensemble->octetsSok;
+    ensemble->capaciteTable = CAPACITE_INITIALE_RECHERCHE;
+    ensemble->table = allouer(NULL,
+        ensemble->capaciteTable * sizeof(uint32_t));
+    memset(ensemble->table, 0xFF, ensemble->capaciteTable * sizeof(uint32_t));
+    free(vide);
+}
+
+/**
+ * @brief Libère un ensemble d'états
+ * @param ensemble Ensemble préparé par ensemble_preparer()
+ */
+static void ensemble_liberer(t_EnsembleEtats * ensemble){
+    for (uint32_t i = ZERO ; i < ensemble->nbBlocs ; i++) {
+        free(ensemble->blocs[i]);
+    }
+    free(ensemble->blocs);
+    free(ensemble->table);
+    free(ensemble->numeroSol);
+    free(ensemble->caseSol);
+}
+
+/**
+ * @brief Donne la place occupée par un ensemble d'états
+ * @param ensemble Ensemble d'états
+ * @return Nombre d'octets
+ */
+static size_t ensemble_memoire(const t_EnsembleEtats * ensemble){
+    return (size_t)ensemble->nbBlocs * ensemble->taille
+        * ((size_t)1 << BITS_ETATS_PAR_BLOC)
+        + ensemble->capaciteBlocs * sizeof(uint8_t *)
+        + ensemble->capaciteTable * sizeof(uint32_t)
+        + (size_t)ensemble->niveau->nbCases * DOUBLE * sizeof(int32_t);
+}
+
+/**
+ * @brief Donne l'adresse d'un état de l'ensemble
+ * @param ensemble Ensemble d'états
+ * @param n Indice de l'état
+ * @return Octets de l'état compact
+ */
+static inline uint8_t * ensemble_etat(const t_EnsembleEtats * ensemble,
+    uint32_t n){
+
+    return ensemble->blocs[n >> BITS_ETATS_PAR_BLOC]
+        + (size_t)(n & ((1u << BITS_ETATS_PAR_BLOC) - 1)) * ensemble->taille;
+}
+
+/**
+ * @brief Écrit un état sous forme compacte
+ * @param ensemble Ensemble qui donne la numérotation du sol
+ * @param caisses Cases des caisses
+ * @param nbCaisses Nombre de caisses
+ * @param caseSok Case normalisée de Sokoban
+ * @param compact ensemble->taille octets à remplir
+ */
+static void etat_compacter(const t_EnsembleEtats * ensemble,
+    const int32_t caisses[], int nbCaisses, int caseSok, uint8_t compact[]){
+
+    int numero, octetsCaisses = ensemble->taille - ensemble->octetsSok;
+
+    memset(compact, 0, octetsCaisses);
+    for (int i = ZERO ; i < nbCaisses ; i++) {
+        numero = ensemble->numeroSol[caisses[i]];
+        compact[numero / BITS_PAR_OCTET] |= 1 << (numero % BITS_PAR_OCTET);
+    }
+    numero = ensemble->numeroSol[caseSok];
+    for (int i = ZERO ; i < ensemble->octetsSok ; i++) {
+        compact[octetsCaisses + i] = numero >> (i * BITS_PAR_OCTET);
+    }
+}
+
+/**
+ * @brief Relit un état compact
+ * @param ensemble Ensemble qui donne la numérotation du sol
+ * @param compact État écrit par etat_compacter()
+ * @param caisses Cases des caisses, triées, à remplir
+ * @return Case normalisée de Sokoban
+ */
+static int etat_decompacter(const t_EnsembleEtats * ensemble,
+    const uint8_t compact[], int32_t caisses[]){
+
+    int numero = ZERO, nbCaisses = ZERO;
+    int octetsCaisses = ensemble->taille - ensemble->octetsSok;
+
+    for (int i = ZERO ; i < octetsCaisses ; i++) {
+        for (unsigned octet = compact[i] ; octet != ZERO ; octet &= octet - 1) {
+            caisses[nbCaisses++] = ensemble->caseSol[i * BITS_PAR_OCTET
+                + __builtin_ctz(octet)];
+        }
+    }
+    for (int i = ensemble->octetsSok - 1 ; i >= ZERO ; i--) {
+        numero = numero << BITS_PAR_OCTET | compact[octetsCaisses + i];
+    }
+    return ensemble->caseSol[numero];
+}
+
+/**
+ * @brief Calcule l'empreinte de Zobrist d'un état compact, la même que celle
+ * tenue à jour poussée après poussée par le solveur
+ * @param ensemble Ensemble d'états
+ * @param compact État compact
+ * @param caisses nbCaisses cases de travail
+ * @return Empreinte des caisses et de la zone de Sokoban
+ */
+static uint64_t etat_empreinte(const t_EnsembleEtats * ensemble,
+    const uint8_t compact[], int32_t caisses[]){
+
+    const t_Niveau * niveau = ensemble->niveau;
+    int nbCaisses = ZERO, caseSok = etat_decompacter(ensemble, compact,
+        caisses);
+    uint64_t empreinte = niveau->zobristSok[caseSok];
+
+    // etat_decompacter ne donne pas le nombre de caisses : on les recompte
+    for (int i = ZERO ; i < ensemble->taille - ensemble->octetsSok ; i++) {
+        nbCaisses += __builtin_popcount(compact[i]);
+    }
+    for (int i = ZERO ; i < nbCaisses ; i++) {
+        empreinte ^= niveau->zobrist[caisses[i]];
+    }
+    return empreinte;
+}
+
+/**
+ * @brief Double la table de l'ensemble et y replace tous les états, dont on
+ * recalcule l'empreinte
+ * @param ensemble Ensemble d'états
+ * @param caisses Cases de travail pour relire les états
+ */
+static void ensemble_agrandir(t_EnsembleEtats * ensemble, int32_t caisses[]){
+    uint32_t masque, position, * table;
+
+    if (ensemble->capaciteTable == CAPACITE_TABLE_MAX) {
+        moteur_verifier(MOTEUR_ERREUR_MEMOIRE);
+    }
+    // L'ancienne table n'est rendue qu'une fois la nouvelle obtenue
+    table = allouer(NULL, DOUBLE * ensemble->capaciteTable * sizeof(uint32_t));
+    free(ensemble->table);
+    ensemble->table = table;
+    ensemble->capaciteTable *= DOUBLE;
+    memset(ensemble->table, 0xFF, ensemble->capaciteTable * sizeof(uint32_t));
+    masque = ensemble->capaciteTable - 1;
+    for (uint32_t n = ZERO ; n < ensemble->nbEtats ; n++) {
+        position = etat_empreinte(ensemble, ensemble_etat(ensemble, n),
+            caisses) & masque;
+        while (ensemble->table[position] != AUCUN_NOEUD) {
+            position = (position + 1) & masque;
+        }
+        ensemble->table[position] = n;
+    }
+}
+
+/**
+ * @brief Cherche un état dans l'ensemble
+ * @param ensemble Ensemble d'états
+ * @param compact État compact cherché
+ * @param empreinte Empreinte de Zobrist de l'état
+ * @param position Adresse où mettre la place de l'état dans la table
+ * @return Indice de l'état s'il existe, AUCUN_NOEUD sinon
+ */
+static uint32_t ensemble_chercher(const t_EnsembleEtats * ensemble,
+    const uint8_t compact[], uint64_t empreinte, uint32_t * position){
+
+    uint32_t masque = ensemble->capaciteTable - 1, n;
+
+    *position = empreinte & masque;
+    // Sondage linéaire jusqu'à l'état ou une place libre
+    while ((n = ensemble->table[*position]) != AUCUN_NOEUD) {
+        if (memcmp(ensemble_etat(ensemble, n), compact, ensemble->taille)
+            == ZERO) {
+            return n;
+        }
+        *position = (*position + 1) & masque;
+    }
+    return AUCUN_NOEUD;
+}
+
+/**
+ * @brief Ajoute un état à l'ensemble
+ * @param ensemble Ensemble d'états
+ * @param compact État compact absent de l'ensemble
+ * @param position Place libre trouvée par ensemble_chercher()
+ * @param caisses nbCaisses cases de travail, si la table doit grandir
+ * @return Indice du nouvel état
+ */
+static uint32_t ensemble_ajouter(t_EnsembleEtats * ensemble,
+    const uint8_t compact[], uint32_t position, int32_t caisses[]){
+
+    uint32_t n = ensemble->nbEtats;
+
+    // Un nouveau bloc quand le dernier est plein : rien n'est recopié
+    if ((n & ((1u << BITS_ETATS_PAR_BLOC) - 1)) == ZERO) {
+        if (ensemble->nbBlocs == ensemble->capaciteBlocs) {
+            ensemble->capaciteBlocs = ensemble->capaciteBlocs == ZERO
+                ? 1 : ensemble->capaciteBlocs * DOUBLE;
+            ensemble->blocs = allouer(ensemble->blocs,
+                ensemble->capaciteBlocs * sizeof(uint8_t *));
+        }
+        ensemble->blocs[ensemble->nbBlocs++] = allouer(NULL,
+            (size_t)ensemble->taille << BITS_ETATS_PAR_BLOC);
+    }
+    memcpy(ensemble_etat(ensemble, n), compact, ensemble->taille);
+    ensemble->table[position] = n;
+    ensemble->nbEtats++;
+    // La table reste remplie à moins de la moitié
+    if (ensemble->nbEtats * (uint64_t)DOUBLE > ensemble->capaciteTable) {
+        ensemble_agrandir(ensemble, caisses);
+    }
+    return n;
+}
+
+/**
+ * @brief Crée un noeud et inscrit son état dans la table de transposition
+ * @param solveur Solveur où créer le noeud
+ * @param noeud Contenu du noeud
+ * @param compact État compact du noeud
+ * @param position Place libre trouvée par ensemble_chercher()
+ * @return Indice du nouveau noeud (solveur->caissesFils a pu servir de
+ * mémoire de travail)
+ */
+static uint32_t noeud_creer(t_Solveur * solveur, t_Noeud noeud,
+    const uint8_t compact[], uint32_t position){
+
+    uint32_t n = ensemble_ajouter(&solveur->etats, compact, position,
+        solveur->caissesFils);
+
+    if (n == solveur->capaciteNoeuds) {
+        solveur->capaciteNoeuds *= DOUBLE;
+        solveur->noeuds = allouer(solveur->noeuds,
+            solveur->capaciteNoeuds * sizeof(t_Noeud));
+    }
+    solveur->noeuds[n] = noeud;
+    solveur->nbNoeuds++;
+    return n;
+}
+
+/**
+ * @brief Remplace la caisse d'indice i par une nouvelle case en gardant
+ * le tableau trié
+ * @param caisses Cases triées des caisses
+ * @param nbCaisses Nombre de caisses
+ * @param i Indice de la caisse déplacée
+ * @param arrivee Nouvelle case de la caisse
+ */
+static void caisses_remplacer(int32_t caisses[], int nbCaisses, int i,
+    int arrivee){
+
+    while (i > ZERO && caisses[i - 1] > arrivee) {
+        caisses[i] = caisses[i - 1];
+        i--;
+    }
+    while (i < nbCaisses - 1 && caisses[i + 1] < arrivee) {
+        caisses[i] = caisses[i + 1];
+        i++;
+    }
+    caisses[i] = arrivee;
+}
+
+/**
+ * @brief Ajoute à la solution le chemin le plus court de Sokoban vers une case
+ * @param solveur Solveur dont on utilise la mémoire de travail
+ * @param caisses Couche des caisses
+ * @param caseSok Case de départ de Sokoban
+ * @param arrivee Case à atteindre (accessible)
+ * @param solution Solution à compléter
+ */
+static void solution_chemin(t_Solveur * solveur, const uint64_t caisses[],
+    int caseSok, int arrivee, t_Solution * solution){
+
+    const int * decalages = solveur->niveau->decalages;
+    int * precedent = solveur->precedent, * directions = solveur->file;
+    int longueur = ZERO, numCase = arrivee;
+
+    zone_accessible(solveur, caisses, caseSok, precedent);
+    // Le parcours est fini : sa file sert à garder les directions du chemin,
+    // relevées en remontant de l'arrivée vers le départ
+    while (numCase != caseSok) {
+        directions[longueur++] = precedent[numCase];
+        numCase -= decalages[precedent[numCase]];
+    }
+    for (int i = longueur - 1 ; i >= ZERO ; i--) {
+        moteur_verifier(ajout_deplacement(&solution->deplacements,
+            LETTRES_DEPLACEMENT[directions[i]], solution->nbDeplacements++));
+    }
+}
+
+/**
+ * @brief Rejoue une suite de poussées pour écrire la solution : Sokoban
+ * marche jusqu'à chaque caisse puis la pousse
+ * @param solveur Solveur dont on utilise la mémoire de travail
+ * @param depart Position de départ
+ * @param nbPoussees Nombre de poussées
+ * @param departs Case de la caisse avant chaque poussée
+ * @param directions Direction de chaque poussée
+ * @param solution Solution à remplir
+ */
+static void solution_rejouer(t_Solveur * solveur, const t_Etat * depart,
+    int nbPoussees, const int32_t departs[], const int32_t directions[],
+    t_Solution * solution){
+
+    const int * decalages = solveur->niveau->decalages;
+    t_Etat etat;
+
+    moteur_verifier(etat_copier(solveur->niveau, &etat, depart));
+    for (int i = ZERO ; i < nbPoussees ; i++) {
+        solution_chemin(solveur, etat.caisses, etat.caseSok,
+            departs[i] - decalages[directions[i]], solution);
+        moteur_verifier(ajout_deplacement(&solution->deplacements,
+            LETTRES_POUSSEE[directions[i]], solution->nbDeplacements++));
+        bit_deplacer(etat.caisses, departs[i],
+            departs[i] + decalages[directions[i]]);
+        etat.caseSok = departs[i];
+    }
+    solution->nbPoussees = nbPoussees;
+    etat_liberer(&etat);
+}
+
+/**
+ * @brief Prolonge une poussée dans un tunnel : tant que la caisse y est et
+ * que la case suivante est libre et vivante, Sokoban la suit et la repousse.
+ * Rien n'est prolongé si la caisse n'était pas déjà dans le tunnel
+ * @param solveur Solveur en cours de recherche (couche : caisses, la caisse
+ * poussée comprise, tenue à jour)
+ * @param caisse Case de la caisse avant la poussée
+ * @param direction Direction de la poussée
+ * @param arrivee Case de la caisse après la poussée, puis après la dernière
+ * @return Nombre de poussées ajoutées
+ */
+static int tunnel_prolonger(t_Solveur * solveur, int caisse, int direction,
+    int * arrivee){
+
+    const t_Niveau * niveau = solveur->niveau;
+    const uint64_t * tunnel = niveau->tunnels
+        + direction / DOUBLE * niveau->nbMots;
+    int suivante, nbPoussees = ZERO;
+
+    if (!bit_lire(tunnel, caisse)) {
+        return ZERO;
+    }
+    suivante = *arrivee + niveau->decalages[direction];
+    while (bit_lire(tunnel, *arrivee) && !bit_lire(niveau->murs, suivante)
+        && !bit_lire(solveur->couche, suivante)
+        && !bit_lire(niveau->casesMortes, suivante)) {
+        bit_deplacer(solveur->couche, *arrivee, suivante);
+        *arrivee = suivante;
+        suivante += niveau->decalages[direction];
+        nbPoussees++;
+    }
+    return nbPoussees;
+}
+
+/**
+ * @brief Parcourt en largeur les poussées d'une caisse qui vient d'entrer
+ * dans la salle des cibles, les autres caisses restant en place. Un état est
+ * la case de la caisse et la direction de sa dernière poussée (case *
+ * NB_DIRECTIONS + direction), Sokoban se tenant juste derrière
+ * @param solveur Solveur en cours de recherche (couche : caisses, celle de
+ * l'entrée comprise, rendue inchangée)
+ * @param direction Direction de la poussée sur l'entrée
+ * @return Nombre de cibles atteintes ; solveur->ciblesSalle donne le premier
+ * état sur chacune et solveur->pereSalle l'état d'où vient chaque état
+ * (lui-même pour le départ)
+ */
+static int salle_parcourir(t_Solveur * solveur, int direction){
+    const t_Niveau * niveau = solveur->niveau;
+    const int * decalages = niveau->decalages;
+    int32_t * pere = solveur->pereSalle, * file = solveur->fileSalle;
+    int debut = ZERO, fin = ZERO, nbCibles = ZERO, etat, caisse, suivante;
+    bool nouvelle;
+
+    // Seuls les états du parcours précédent sont à effacer
+    for (int i = ZERO ; i < solveur->nbEtatsSalle ; i++) {
+        pere[file[i]] = AUCUNE_CASE;
+    }
+    etat = niveau->entreeSalle * NB_DIRECTIONS + direction;
+    pere[etat] = etat;
+    file[fin++] = etat;
+    while (debut < fin) {
+        etat = file[debut++];
+        caisse = etat / NB_DIRECTIONS;
+        bit_deplacer(solveur->couche, niveau->entreeSalle, caisse);
+        zone_remplir(niveau, solveur->couche,
+            caisse - decalages[etat % NB_DIRECTIONS], solveur->zoneFils);
+        bit_deplacer(solveur->couche, caisse, niveau->entreeSalle);
+        for (int d = ZERO ; d < NB_DIRECTIONS ; d++) {
+            suivante = caisse + decalages[d];
+            if (!bit_lire(niveau->salle, suivante)
+                || bit_lire(solveur->couche, suivante)
+                || bit_lire(niveau->casesMortes, suivante)
+                || !bit_lire(solveur->zoneFils, caisse - decalages[d])
+                || pere[suivante * NB_DIRECTIONS + d] != AUCUNE_CASE) {
+                continue;
+            }
+            nouvelle = true;
+            for (int k = ZERO ; k < NB_DIRECTIONS ; k++) {
+                nouvelle = nouvelle
+                    && pere[suivante * NB_DIRECTIONS + k] == AUCUNE_CASE;
+            }
+            pere[suivante * NB_DIRECTIONS + d] = etat;
+            file[fin++] = suivante * NB_DIRECTIONS + d;
+            if (nouvelle && bit_lire(niveau->cibles, suivante)) {
+                solveur->ciblesSalle[nbCibles++] = suivante * NB_DIRECTIONS
+                    + d;
+            }
+        }
+    }
+    solveur->nbEtatsSalle = fin;
+    return nbCibles;
+}
+
+/**
+ * @brief Transforme la suite de poussées menant à un noeud en déplacements.
+ * Un arc de plusieurs poussées est rejoué depuis l'état du père avec les
+ * mêmes règles que noeud_developper() pour retrouver chacune
+ * @param solveur Solveur ayant trouvé la solution
+ * @param depart Position de départ
+ * @param but Noeud où toutes les caisses sont sur une cible
+ * @param solution Solution à remplir
+ */
+static void solution_reconstruire(t_Solveur * solveur, const t_Etat * depart,
+    uint32_t but, t_Solution * solution){
+
+    const t_Niveau * niveau = solveur->niveau;
+    const t_Noeud * noeuds = solveur->noeuds;
+    const t_Noeud * noeud;
+    int nbPoussees = noeuds[but].poussees, nbArcs = ZERO, j = ZERO;
+    int32_t * departs, * directions;
+    uint32_t * arcs;
+    int reste, pas, arrivee, nbCibles, finale = AUCUNE_CASE;
+    int etat = AUCUNE_CASE;
+
+    for (uint32_t n = but ; noeuds[n].parent != AUCUN_NOEUD ;
+        n = noeuds[n].parent) {
+        nbArcs++;
+    }
+    arcs = allouer(NULL, (nbArcs + 1) * sizeof(uint32_t));
+    departs = allouer(NULL, (nbPoussees + 1) * sizeof(int32_t));
+    directions = allouer(NULL, (nbPoussees + 1) * sizeof(int32_t));
+    for (uint32_t n = but, i = nbArcs ; i > ZERO ; n = noeuds[n].parent) {
+        arcs[--i] = n;
+    }
+    for (int a = ZERO ; a < nbArcs ; a++) {
+        noeud = &noeuds[arcs[a]];
+        reste = noeud->poussees - noeuds[noeud->parent].poussees - 1;
+        departs[j] = noeud->depart;
+        directions[j++] = noeud->direction;
+        if (reste == ZERO) {
+            continue;
+        }
+        // Macro : caisses du père, poussée d'origine puis tunnel
+        etat_decompacter(&solveur->etats, ensemble_etat(&solveur->etats,
+            noeud->parent), solveur->caissesPere);
+        memset(solveur->couche, 0, niveau->nbMots * sizeof(uint64_t));
+        for (int i = ZERO ; i < solveur->nbCaisses ; i++) {
+            bit_inverser(solveur->couche, solveur->caissesPere[i]);
+        }
+        pas = niveau->decalages[noeud->direction];
+        arrivee = noeud->depart + pas;
+        bit_deplacer(solveur->couche, noeud->depart, arrivee);
+        reste -= tunnel_prolonger(solveur, noeud->depart, noeud->direction,
+            &arrivee);
+        while (departs[j - 1] + pas != arrivee) {
+            departs[j] = departs[j - 1] + pas;
+            directions[j++] = noeud->direction;
+        }
+        if (reste == ZERO) {
+            continue;
+        }
+        // Puis salle des cibles : la case d'arrivée est celle des caisses du
+        // fils qui n'est pas dans la couche
+        etat_decompacter(&solveur->etats, ensemble_etat(&solveur->etats,
+            arcs[a]), solveur->caissesFils);
+        for (int i = ZERO ; i < solveur->nbCaisses ; i++) {
+            if (!bit_lire(solveur->couche, solveur->caissesFils[i])) {
+                finale = solveur->caissesFils[i];
+            }
+        }
+        nbCibles = salle_parcourir(solveur, noeud->direction);
+        for (int k = ZERO ; k < nbCibles ; k++) {
+            if (solveur->ciblesSalle[k] / NB_DIRECTIONS == finale) {
+                etat = solveur->ciblesSalle[k];
+            }
+        }
+        // Le chemin se relève à rebours, de la cible vers l'entrée
+        j += reste;
+        for (int k = j - 1 ; solveur->pereSalle[etat] != etat ; k--) {
+            directions[k] = etat % NB_DIRECTIONS;
+            departs[k] = etat / NB_DIRECTIONS
+                - niveau->decalages[directions[k]];
+            etat = solveur->pereSalle[etat];
+        }
+    }
+    solution_rejouer(solveur, depart, nbPoussees, departs, directions,
+        solution);
+    free(arcs);
+    free(departs);
+    free(directions);
+}
+
+/**
+ * @brief Précalcule, pour chaque cible et chaque case, le nombre de poussées
+ * qu'il faut au moins pour amener une caisse de la case à la cible sur le
+ * plateau sans autre caisse : parcours en largeur à rebours depuis la cible,
+ * où une caisse recule d'une case si Sokoban a la place de la tirer. Garde
+ * aussi pour chaque case la distance à la cible la plus proche
+ * @param solveur Solveur à remplir
+ */
+static void distances_cibles(t_Solveur * solveur){
+    const t_Niveau * niveau = solveur->niveau;
+    const int * decalages = niveau->decalages;
+    int * file = solveur->file, * distances;
+    int debut, fin, numCase, precedente, cible = ZERO;
+
+    solveur->nbCibles = ZERO;
+    for (numCase = ZERO ; numCase < niveau->nbCases ; numCase++) {
+        solveur->nbCibles += bit_lire(niveau->cibles, numCase);
+        solveur->distanceCible[numCase] = INFINI_POUSSEES;
+    }
+    solveur->distancesPoussees = allouer(NULL, ((size_t)solveur->nbCibles
+        * niveau->nbCases + 1) * sizeof(int));
+    for (int caseCible = ZERO ; caseCible < niveau->nbCases ; caseCible++) {
+        if (!bit_lire(niveau->cibles, caseCible)) {
+            continue;
+        }
+        distances = &solveur->distancesPoussees[(size_t)cible++
+            * niveau->nbCases];
+        for (numCase = ZERO ; numCase < niveau->nbCases ; numCase++) {
+            distances[numCase] = INFINI_POUSSEES;
+        }
+        distances[caseCible] = ZERO;
+        debut = ZERO;
+        fin = ZERO;
+        file[fin++] = caseCible;
+        while (debut < fin) {
+            numCase = file[debut++];
+            for (int d = ZERO ; d < NB_DIRECTIONS ; d++) {
+                // La caisse arrive en numCase poussée dans la direction d
+                precedente = numCase - decalages[d];
+                if (distances[precedente] == INFINI_POUSSEES
+                    && !bit_lire(niveau->murs, precedente)
+                    && !bit_lire(niveau->murs, precedente - decalages[d])) {
+                    distances[precedente] = distances[numCase] + 1;
+                    file[fin++] = precedente;
+                }
+            }
+        }
+        for (numCase = ZERO ; numCase < niveau->nbCases ; numCase++) {
+            if (distances[numCase] < solveur->distanceCible[numCase]) {
+                solveur->distanceCible[numCase] = distances[numCase];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Range dans l'ordre croissant les cases des caisses d'une couche
+ * @param niveau Niveau de la couche
+ * @param caisses Couche des caisses
+ * @param liste Tableau à remplir (NULL pour seulement compter)
+ * @return Nombre de caisses
+ */
+static int caisses_lister(const t_Niveau * niveau, const uint64_t caisses[],
+    int32_t liste[]){
+
+    int nbCaisses = ZERO;
+    for (int i = ZERO ; i < niveau->nbMots ; i++) {
+        for (uint64_t mot = caisses[i] ; mot != ZERO ; mot &= mot - 1) {
+            if (liste != NULL) {
+                liste[nbCaisses] = i * BITS_PAR_MOT + __builtin_ctzll(mot);
+            }
+            nbCaisses++;
+        }
+    }
+    return nbCaisses;
+}
+
+/**
+ * @brief Alloue la mémoire de travail d'un solveur, dont la taille dépend
+ * du niveau, et précalcule les distances aux cibles
+ * @param solveur Solveur remis à zéro
+ * @param niveau Niveau à résoudre
+ * @param nbCaisses Nombre de caisses du niveau
+ */
+static void solveur_preparer(t_Solveur * solveur, const t_Niveau * niveau,
+    int nbCaisses){
+
+    t_Affectation * affectation = &solveur->affectation;
+    int nbColonnes;
+
+    solveur->niveau = niveau;
+    solveur->nbCaisses = nbCaisses;
+    solveur->distanceCible = allouer(NULL, niveau->nbCases * sizeof(int));
+    solveur->file = allouer(NULL, niveau->nbCases * sizeof(int));
+    solveur->precedent = allouer(NULL, niveau->nbCases * sizeof(int));
+    solveur->marque = allouer_zero(niveau->nbCases, sizeof(uint32_t));
+    solveur->couche = couches_creer(niveau->nbMots, 3);
+    solveur->zone = solveur->couche + niveau->nbMots;
+    solveur->zoneFils = solveur->zone + niveau->nbMots;
+    solveur->caissesFils = allouer(NULL,
+        (nbCaisses + 1) * sizeof(int32_t));
+    distances_cibles(solveur);
+    nbColonnes = solveur->nbCibles + 1;
+    // Sans assez de cibles, aucune affectation ne couvre toutes les caisses
+    solveur->typeMinorant = nbCaisses <= solveur->nbCibles
+        ? MINORANT_AFFECTATION : MINORANT_PLUS_PROCHES;
+    affectation->lignes = allouer(NULL, (nbCaisses + 1) * sizeof(int32_t));
+    affectation->potentielsLignes = allouer(NULL, DOUBLE
+        * (nbCaisses + 1) * sizeof(int64_t));
+    affectation->sauvePotentielsLignes = affectation->potentielsLignes
+        + nbCaisses + 1;
+    affectation->potentielsCibles = allouer(NULL, 3 * nbColonnes
+        * sizeof(int64_t));
+    affectation->sauvePotentielsCibles = affectation->potentielsCibles
+        + nbColonnes;
+    affectation->ecarts = affectation->sauvePotentielsCibles + nbColonnes;
+    affectation->ligneDeCible = allouer(NULL, 3 * nbColonnes
+        * sizeof(int32_t));
+    affectation->sauveLigneDeCible = affectation->ligneDeCible + nbColonnes;
+    affectation->cibleAvant = affectation->sauveLigneDeCible + nbColonnes;
+    affectation->vues = allouer(NULL, nbColonnes * sizeof(bool));
+}
+
+/**
+ * @brief Donne la taille de la mémoire de travail d'un solveur
+ * @param solveur Solveur préparé par solveur_preparer()
+ * @return Nombre d'octets
+ */
+static size_t solveur_memoire_travail(const t_Solveur * solveur){
+    return sizeof(t_Solveur) + (size_t)solveur->niveau->nbCases
+        * (3 * sizeof(int) + sizeof(uint32_t))
+        + (size_t)solveur->niveau->nbMots * 3 * sizeof(uint64_t)
+        + (solveur->nbCaisses + 1) * sizeof(int32_t)
+        + ((size_t)solveur->nbCibles * solveur->niveau->nbCases + 1)
+        * sizeof(int)
+        + (solveur->nbCaisses + 1) * (sizeof(int32_t) + DOUBLE
+        * sizeof(int64_t))
+        + (solveur->nbCibles + 1) * (3 * sizeof(int64_t) + 3
+        * sizeof(int32_t) + sizeof(bool));
+}
+
+/**
+ * @brief Libère la mémoire de travail d'un solveur
+ * @param solveur Solveur préparé par solveur_preparer()
+ */
+static void solveur_liberer_travail(t_Solveur * solveur){
+    free(solveur->distanceCible);
+    free(solveur->file);
+    free(solveur->precedent);
+    free(solveur->marque);
+    free(solveur->couche);
+    free(solveur->caissesFils);
+    free(solveur->distancesPoussees);
+    free(solveur->affectation.lignes);
+    free(solveur->affectation.potentielsLignes);
+    free(solveur->affectation.potentielsCibles);
+    free(solveur->affectation.ligneDeCible);
+    free(solveur->affectation.vues);
+}
+
+/**
+ * @brief Donne la clé d'un groupe de caisses
+ * @param cases Cases triées des caisses
+ * @param nbCases Nombre de caisses (NB_CAISSES_MOTIF_MAX au plus)
+ * @return Cases à la suite, BITS_CASE_MOTIF bits chacune
+ */
+static uint64_t motif_cle(const int32_t cases[], int nbCases){
+    uint64_t cle = ZERO;
+
+    for (int i = ZERO ; i < nbCases ; i++) {
+        cle |= (uint64_t)cases[i] << (i * BITS_CASE_MOTIF);
+    }
+    return cle;
+}
+
+/**
+ * @brief Donne l'empreinte de Zobrist d'un groupe de caisses, qui sert à le
+ * ranger dans la table
+ * @param niveau Partie fixe du niveau
+ * @param cle Clé du groupe (sans MOTIF_BLOQUANT)
+ * @return Empreinte
+ */
+static uint64_t motif_empreinte(const t_Niveau * niveau, uint64_t cle){
+    const uint64_t MASQUE_CASE = (1ull << BITS_CASE_MOTIF) - 1;
+    uint64_t empreinte = ZERO;
+
+    // Une case 0 est dans la bordure : elle marque la fin du groupe
+    for ( ; cle != ZERO ; cle >>= BITS_CASE_MOTIF) {
+        empreinte ^= niveau->zobrist[cle & MASQUE_CASE];
+    }
+    return empreinte;
+}
+
+/**
+ * @brief Cherche un groupe dans la base
+ * @param motifs Base de motifs
+ * @param cle Clé du groupe
+ * @return Place du groupe, ou place libre où l'inscrire
+ */
+static uint32_t motifs_chercher(const t_Motifs * motifs, uint64_t cle){
+    uint32_t masque = motifs->capaciteTable - 1;
+    uint32_t position = motif_empreinte(motifs->niveau, cle) & masque;
+
+    while (motifs->table[position] != ZERO
+        && (motifs->table[position] & ~MOTIF_BLOQUANT) != cle) {
+        position = (position + 1) & masque;
+    }
+    return position;
+}
+
+/**
+ * @brief Inscrit un groupe absent de la base, et double la table quand elle
+ * est à moitié pleine
+ * @param motifs Base de motifs
+ * @param cle Clé du groupe
+ * @param bloquant true si le groupe est un motif bloquant
+ */
+static void motifs_inscrire(t_Motifs * motifs, uint64_t cle, bool bloquant){
+    uint64_t * ancienne = motifs->table;
+    uint32_t ancienneCapacite = motifs->capaciteTable;
+
+    motifs->table[motifs_chercher(motifs, cle)] = cle
+        | (bloquant ? MOTIF_BLOQUANT : ZERO);
+    motifs->nbGroupes++;
+    motifs->nbBloquants += bloquant;
+    if (motifs->nbGroupes * DOUBLE > motifs->capaciteTable) {
+        motifs->capaciteTable *= DOUBLE;
+        motifs->table = allouer_zero(motifs->capaciteTable,
+            sizeof(uint64_t));
+        for (uint32_t i = ZERO ; i < ancienneCapacite ; i++) {
+            if (ancienne[i] != ZERO) {
+                motifs->table[motifs_chercher(motifs,
+                    ancienne[i] & ~MOTIF_BLOQUANT)] = ancienne[i];
+            }
+        }
+        free(ancienne);
+    }
+}
+
+void motifs_preparer(t_Motifs * motifs, const t_Niveau * niveau,
+    const t_Etat * depart){
+
+    memset(motifs, 0, sizeof(*motifs));
+    motifs->niveau = niveau;
+    // Changer de version écarte les motifs appris par une version dont la
+    // détection des blocages était fausse (version 2 : gel des caisses
+    // voisines d'une caisse mobile corrigé)
+    motifs->empreinteNiveau = ((uint64_t)niveau->nbLignes << BITS_PAR_MOT
+        / DOUBLE) | (uint64_t)niveau->nbColonnes
+        | VERSION_MOTIFS << DECALAGE_VERSION_MOTIFS;
+    for (int numCase = ZERO ; numCase < niveau->nbCases ; numCase++) {
+        if (bit_lire(niveau->murs, numCase)) {
+            motifs->empreinteNiveau ^= niveau->zobrist[numCase];
+        }
+        if (bit_lire(niveau->cibles, numCase)) {
+            motifs->empreinteNiveau ^= niveau->zobristSok[numCase];
+        }
+    }
+    motifs->capaciteTable = CAPACITE_INITIALE_RECHERCHE;
+    motifs->table = allouer_zero(motifs->capaciteTable, sizeof(uint64_t));
+    motifs->sol = couches_creer(niveau->nbMots, 4);
+    motifs->caisses = motifs->sol + niveau->nbMots;
+    motifs->zone = motifs->caisses + niveau->nbMots;
+    motifs->couvertes = motifs->zone + niveau->nbMots;
+    motifs->clesVisites = allouer(NULL,
+        NB_ETATS_SOUS_RECHERCHE * sizeof(uint64_t));
+    motifs->casesVisites = allouer(NULL,
+        NB_ETATS_SOUS_RECHERCHE * sizeof(int32_t));
+    motifs->tableVisites = allouer(NULL,
+        DOUBLE * NB_ETATS_SOUS_RECHERCHE * sizeof(uint32_t));
+    zone_remplir(niveau, motifs->caisses, depart->caseSok, motifs->sol);
+}
+
+void motifs_liberer(t_Motifs * motifs){
+    free(motifs->table);
+    free(motifs->sol);
+    free(motifs->clesVisites);
+    free(motifs->casesVisites);
+    free(motifs->tableVisites);
+}
+
+/**
+ * @brief Donne le fichier des motifs d'un niveau : celui de son recueil
+ * @param fichier Fichier du niveau ("recueil.sok#12" ou "niveau.sok")
+ * @param chemin TAILLE_CHEMIN caractères à remplir
+ */
+static void motifs_chemin(const char fichier[], char chemin[]){
+    char * numero;
+
+    snprintf(chemin, TAILLE_CHEMIN, "%s", fichier);
+    numero = strrchr(chemin, SEPARATEUR_NIVEAU);
+    if (numero != NULL) {
+        *numero = '\0';
+    }
+    strncat(chemin, EXTENSION_MOTIFS, TAILLE_CHEMIN - strlen(chemin) - 1);
+}
+
+void motifs_charger(t_Motifs * motifs, const char fichier[]){
+    char chemin[TAILLE_CHEMIN];
+    unsigned long long empreinte, cle;
+    FILE * f;
+
+    motifs_chemin(fichier, chemin);
+    f = fopen(chemin, "r");
+    if (f == NULL) {
+        return;
+    }
+    // Une ligne par motif : empreinte du niveau puis clé du groupe
+    while (fscanf(f, "%llx %llx", &empreinte, &cle) == DOUBLE) {
+        if (empreinte == motifs->empreinteNiveau && cle != ZERO
+            && motifs->table[motifs_chercher(motifs, cle)] == ZERO) {
+            motifs_inscrire(motifs, cle, true);
+            motifs->nbLus++;
+        }
+    }
+    fclose(f);
+}
+
+bool motifs_enregistrer(const t_Motifs * motifs, const char fichier[]){
+    char chemin[TAILLE_CHEMIN], temporaire[TAILLE_CHEMIN];
+    unsigned long long empreinte, cle;
+    FILE * ancien, * nouveau;
+
+    motifs_chemin(fichier, chemin);
+    snprintf(temporaire, TAILLE_CHEMIN, "%s%s", chemin, EXTENSION_TEMPORAIRE);
+    nouveau = fopen(temporaire, "w");
+    if (nouveau == NULL) {
+        return false;
+    }
+    ancien = fopen(chemin, "r");
+    if (ancien != NULL) {
+        while (fscanf(ancien, "%llx %llx", &empreinte, &cle) == DOUBLE) {
+            if (empreinte != motifs->empreinteNiveau) {
+                fprintf(nouveau, "%016llx %016llx\n", empreinte, cle);
+            }
+        }
+        fclose(ancien);
+    }
+    for (uint32_t i = ZERO ; i < motifs->capaciteTable ; i++) {
+        if (motifs->table[i] & MOTIF_BLOQUANT) {
+            fprintf(nouveau, "%016llx %016llx\n",
+                (unsigned long long)motifs->empreinteNiveau,
+                (unsigned long long)(motifs->table[i] & ~MOTIF_BLOQUANT));
+        }
+    }
+    // Le fichier n'est remplacé qu'une fois le nouveau complet
+    if (fclose(nouveau) != ZERO || rename(temporaire, chemin) != ZERO) {
+        remove(temporaire);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Inscrit un état dans la sous-recherche s'il est nouveau
+ * @param motifs Base de motifs (mémoire de la sous-recherche)
+ * @param cle Caisses de l'état
+ * @param caseSok Case normalisée de Sokoban
+ * @param nbEtats Nombre d'états de la file, augmenté si l'état est nouveau
+ * @return false si la file est pleine
+ */
+static bool sous_recherche_ajouter(t_Motifs * motifs, uint64_t cle,
+    int caseSok, int * nbEtats){
+
+    const uint32_t MASQUE = DOUBLE * NB_ETATS_SOUS_RECHERCHE - 1;
+    uint32_t position = (motif_empreinte(motifs->niveau, cle)
+        ^ motifs->niveau->zobristSok[caseSok]) & MASQUE, n;
+
+    while ((n = motifs->tableVisites[position]) != AUCUN_NOEUD) {
+        if (motifs->clesVisites[n] == cle && motifs->casesVisites[n] == caseSok) {
+            return true;
+        }
+        position = (position + 1) & MASQUE;
+    }
+    if (*nbEtats == NB_ETATS_SOUS_RECHERCHE) {
+        return false;
+    }
+    motifs->tableVisites[position] = *nbEtats;
+    motifs->clesVisites[*nbEtats] = cle;
+    motifs->casesVisites[*nbEtats] = caseSok;
+    (*nbEtats)++;
+    return true;
+}
+
+/**
+ * @brief Sous-recherche en largeur sur le plateau où seules les caisses du
+ * groupe restent, partie de toutes les zones de Sokoban à la fois
+ * @param motifs Base de motifs (mémoire de la sous-recherche)
+ * @param cases Cases triées des caisses du groupe
+ * @param nbCases Nombre de caisses du groupe
+ * @return true si aucune suite de poussées ne met toutes ces caisses sur une
+ * cible : le groupe est un motif bloquant
+ */
+static bool sous_recherche_bloquee(t_Motifs * motifs, const int32_t cases[],
+    int nbCases){
+
+    const t_Niveau * niveau = motifs->niveau;
+    size_t taille = niveau->nbMots * sizeof(uint64_t);
+    int32_t groupe[NB_CAISSES_MOTIF_MAX], fils[NB_CAISSES_MOTIF_MAX];
+    int nbEtats = ZERO, caisse, arrivee;
+    bool complete = true, resolu = true, surCibles;
+
+    for (int i = ZERO ; i < nbCases ; i++) {
+        resolu = resolu && bit_lire(niveau->cibles, cases[i]);
+    }
+    motifs->nbSousRecherches++;
+    memset(motifs->tableVisites, 0xFF,
+        DOUBLE * NB_ETATS_SOUS_RECHERCHE * sizeof(uint32_t));
+    // Un état de départ par zone du sol : Sokoban peut être n'importe où
+    memset(motifs->caisses, 0, taille);
+    for (int i = ZERO ; i < nbCases ; i++) {
+        bit_inverser(motifs->caisses, cases[i]);
+    }
+    memset(motifs->couvertes, 0, taille);
+    for (int numCase = ZERO ; numCase < niveau->nbCases && complete ;
+        numCase++) {
+        if (bit_lire(motifs->sol, numCase)
+            && !bit_lire(motifs->caisses, numCase)
+            && !bit_lire(motifs->couvertes, numCase)) {
+            complete = sous_recherche_ajouter(motifs,
+                motif_cle(cases, nbCases), zone_remplir(niveau,
+                motifs->caisses, numCase, motifs->zone), &nbEtats);
+            for (int i = ZERO ; i < niveau->nbMots ; i++) {
+                motifs->couvertes[i] |= motifs->zone[i];
+            }
+        }
+    }
+
+    for (int n = ZERO ; n < nbEtats && complete && !resolu ; n++) {
+        for (int i = ZERO ; i < nbCases ; i++) {
+            groupe[i] = motifs->clesVisites[n] >> (i * BITS_CASE_MOTIF)
+                & ((1ull << BITS_CASE_MOTIF) - 1);
+        }
+        memset(motifs->caisses, 0, taille);
+        for (int i = ZERO ; i < nbCases ; i++) {
+            bit_inverser(motifs->caisses, groupe[i]);
+        }
+        // Les zones couvertes ne servent plus : la couche garde celle du père
+        zone_remplir(niveau, motifs->caisses, motifs->casesVisites[n],
+            motifs->couvertes);
+        for (int i = ZERO ; i < nbCases && complete && !resolu ; i++) {
+            caisse = groupe[i];
+            for (int d = ZERO ; d < NB_DIRECTIONS && !resolu ; d++) {
+                arrivee = caisse + niveau->decalages[d];
+                if (!bit_lire(motifs->couvertes, caisse - niveau->decalages[d])
+                    || bit_lire(niveau->murs, arrivee)
+                    || bit_lire(motifs->caisses, arrivee)) {
+                    continue;
+                }
+                bit_deplacer(motifs->caisses, caisse, arrivee);
+                if (!poussee_bloquante(niveau, motifs->caisses, arrivee)) {
+                    memcpy(fils, groupe, nbCases * sizeof(int32_t));
+                    caisses_remplacer(fils, nbCases, i, arrivee);
+                    surCibles = true;
+                    for (int j = ZERO ; j < nbCases ; j++) {
+                        surCibles = surCibles
+                            && bit_lire(niveau->cibles, fils[j]);
+                    }
+                    resolu = surCibles;
+                    complete = sous_recherche_ajouter(motifs,
+                        motif_cle(fils, nbCases), zone_remplir(niveau,
+                        motifs->caisses, caisse, motifs->zone), &nbEtats)
+                        && complete;
+                }
+                bit_deplacer(motifs->caisses, arrivee, caisse);
+            }
+        }
+    }
+    // Une recherche arrêtée faute de place ne prouve rien
+    return complete && !resolu;
+}
+
+/**
+ * @brief Dit si un groupe de caisses est un motif bloquant, en lançant sa
+ * sous-recherche la première fois qu'on le rencontre
+ * @param motifs Base de motifs
+ * @param cases Cases triées des caisses du groupe
+ * @param nbCases Nombre de caisses du groupe
+ * @param apprendre false pour seulement consulter la base : un groupe
+ * inconnu n'est alors pas bloquant
+ * @return true si le groupe est un motif bloquant
+ */
+static bool groupe_bloquant(t_Motifs * motifs, const int32_t cases[],
+    int nbCases, bool apprendre){
+
+    uint64_t cle = motif_cle(cases, nbCases);
+    uint64_t entree = motifs->table[motifs_chercher(motifs, cle)];
+    bool bloquant;
+
+    if (entree != ZERO || !apprendre) {
+        return entree & MOTIF_BLOQUANT;
+    }
+    bloquant = sous_recherche_bloquee(motifs, cases, nbCases);
+    motifs_inscrire(motifs, cle, bloquant);
+    return bloquant;
+}
+
+/**
+ * @brief Dit si une caisse qui vient d'être poussée forme un motif bloquant
+ * avec une ou deux des caisses des 8 cases autour d'elle
+ * @param motifs Base de motifs
+ * @param caisses Couche des caisses après la poussée
+ * @param arrivee Case de la caisse poussée
+ * @param apprendre true pour lancer la sous-recherche des groupes jamais
+ * vus, false pour ne faire que 8 + 28 recherches dans la table
+ * @return true si la position est perdue
+ */
+static bool motifs_poussee_bloquante(t_Motifs * motifs,
+    const uint64_t caisses[], int arrivee, bool apprendre){
+
+    const int * decalages = motifs->niveau->decalages;
+    // Haut, bas, gauche, droite puis les quatre coins
+    const int VOISINES[] = {decalages[0], decalages[1], decalages[2],
+        decalages[3], decalages[0] + decalages[2], decalages[0] + decalages[3],
+        decalages[1] + decalages[2], decalages[1] + decalages[3]};
+    const int NB_VOISINES = sizeof(VOISINES) / sizeof(VOISINES[0]);
+    int32_t voisines[NB_VOISINES], groupe[NB_CAISSES_MOTIF_MAX];
+    int nbVoisines = ZERO;
+    bool bloquant = false;
+
+    for (int v = ZERO ; v < NB_VOISINES ; v++) {
+        if (bit_lire(caisses, arrivee + VOISINES[v])) {
+            voisines[nbVoisines++] = arrivee + VOISINES[v];
+        }
+    }
+    for (int a = ZERO ; a < nbVoisines && !bloquant ; a++) {
+        groupe[0] = arrivee;
+        groupe[1] = voisines[a];
+        caisses_remplacer(groupe, DOUBLE, ZERO, arrivee);
+        bloquant = groupe_bloquant(motifs, groupe, DOUBLE, apprendre);
+        // Les voisines sont relevées dans un ordre qui n'est pas celui des
+        // cases : on les range avant d'y placer la caisse poussée
+        for (int b = a + 1 ; b < nbVoisines && !bloquant ; b++) {
+            groupe[0] = arrivee;
+            groupe[1] = voisines[a] < voisines[b] ? voisines[a] : voisines[b];
+            groupe[2] = voisines[a] < voisines[b] ? voisines[b] : voisines[a];
+            caisses_remplacer(groupe, NB_CAISSES_MOTIF_MAX, ZERO, arrivee);
+            bloquant = groupe_bloquant(motifs, groupe, NB_CAISSES_MOTIF_MAX,
+                apprendre);
+        }
+    }
+    motifs->nbCoupures += bloquant;
+    return bloquant;
+}
+
+void motifs_precalculer(t_Motifs * motifs){
+    const t_Niveau * niveau = motifs->niveau;
+    // Droite, bas et les deux coins du bas : chaque paire une seule fois
+    const int VOISINES[] = {niveau->decalages[3], niveau->decalages[1],
+        niveau->decalages[1] + niveau->decalages[2],
+        niveau->decalages[1] + niveau->decalages[3]};
+    const int NB_VOISINES = sizeof(VOISINES) / sizeof(VOISINES[0]);
+    int32_t groupe[NB_CAISSES_MOTIF_MAX];
+
+    for (int numCase = ZERO ; numCase < niveau->nbCases ; numCase++) {
+        if (!bit_lire(motifs->sol, numCase)
+            || bit_lire(niveau->casesMortes, numCase)) {
+            continue;
+        }
+        for (int v = ZERO ; v < NB_VOISINES ; v++) {
+            groupe[0] = numCase;
+            groupe[1] = numCase + VOISINES[v];
+            if (bit_lire(motifs->sol, groupe[1])
+                && !bit_lire(niveau->casesMortes, groupe[1])) {
+                groupe_bloquant(motifs, groupe, DOUBLE, true);
+            }
+        }
+    }
+}
+
+bool motifs_poussee_connue(t_Motifs * motifs, const uint64_t caisses[],
+    int arrivee){
+
+    return motifs_poussee_bloquante(motifs, caisses, arrivee, false);
+}
+
+bool motifs_position_connue(t_Motifs * motifs, const uint64_t caisses[]){
+    bool bloquant = false;
+
+    // Un motif appris contient la caisse poussée et des voisines : chaque
+    // caisse est essayée comme caisse poussée
+    for (int numCase = ZERO ; numCase < motifs->niveau->nbCases && !bloquant ;
+        numCase++) {
+        bloquant = bit_lire(caisses, numCase)
+            && motifs_poussee_bloquante(motifs, caisses, numCase, false);
+    }
+    return bloquant;
+}
+
+/**
+ * @brief Remplit les couches de travail d'un solveur : les caisses d'un
+ * noeud, puis la zone où Sokoban peut marcher
+ * @param solveur Solveur dont on utilise la mémoire de travail
+ * @param caisses Cases des caisses du noeud
+ * @param caseSok Case de Sokoban dans sa zone
+ */
+static void couches_preparer(t_Solveur * solveur, const int32_t caisses[],
+    int caseSok){
+
+    size_t taille = solveur->niveau->nbMots * sizeof(uint64_t);
+
+    memset(solveur->couche, 0, taille);
+    for (int i = ZERO ; i < solveur->nbCaisses ; i++) {
+        bit_inverser(solveur->couche, caisses[i]);
+    }
+    zone_remplir(solveur->niveau, solveur->couche, caseSok, solveur->zone);
+}
+
+/**
+ * @brief Ajoute le fils d'un noeud où une caisse a quitté sa case pour une
+ * autre, en une poussée ou en plusieurs (macro), sauf si la position est
+ * bloquée
+ * @param solveur Solveur en cours de recherche (couche : caisses du fils)
+ * @param n Indice du père, dont les caisses sont dans solveur->caissesPere
+ * @param empreinte Empreinte des seules caisses du père
+ * @param i Indice de la caisse poussée
+ * @param direction Direction de la première poussée
+ * @param arrivee Case finale de la caisse
+ * @param caseSok Case de Sokoban après la dernière poussée
+ * @param poussees Poussées depuis le départ jusqu'au fils
+ */
+static void fils_ajouter(t_Solveur * solveur, uint32_t n, uint64_t empreinte,
+    int i, int direction, int arrivee, int caseSok, int poussees){
+
+    const t_Niveau * niveau = solveur->niveau;
+    int32_t * caisses = solveur->caissesPere;
+    int32_t * caissesFils = solveur->caissesFils;
+    t_Noeud fils;
+    t_EntreeTas entree;
+    uint32_t position, existant;
+    uint64_t empreinteFils;
+    int estimation;
+
+    // Élagage des poussées qui rendent le niveau insoluble
+    estimation = poussee_bloquante(niveau, solveur->couche, arrivee)
+        || (solveur->motifs != NULL && motifs_poussee_bloquante(
+        solveur->motifs, solveur->couche, arrivee, true))
+        ? INFINI_POUSSEES
+        : minorant_poussee(solveur, caisses, i, arrivee);
+    if (estimation == INFINI_POUSSEES) {
+        return;
+    }
+    memcpy(caissesFils, caisses, solveur->nbCaisses * sizeof(int32_t));
+    caisses_remplacer(caissesFils, solveur->nbCaisses, i, arrivee);
+    caseSok = zone_remplir(niveau, solveur->couche, caseSok,
+        solveur->zoneFils);
+
+    empreinteFils = empreinte ^ niveau->zobrist[caisses[i]]
+        ^ niveau->zobrist[arrivee] ^ niveau->zobristSok[caseSok];
+    etat_compacter(&solveur->etats, caissesFils, solveur->nbCaisses,
+        caseSok, solveur->etatFils);
+    fils.parent = n;
+    fils.poussees = poussees;
+    fils.estimation = poussees + estimation;
+    fils.depart = caisses[i];
+    fils.direction = direction;
+    existant = ensemble_chercher(&solveur->etats, solveur->etatFils,
+        empreinteFils, &position);
+    if (existant == AUCUN_NOEUD) {
+        existant = noeud_creer(solveur, fils, solveur->etatFils, position);
+    } else if (solveur->noeuds[existant].poussees > poussees) {
+        // Un chemin plus court vers un état déjà vu
+        solveur->noeuds[existant] = fils;
+    } else {
+        return;
+    }
+    entree.estimation = fils.estimation;
+    entree.poussees = fils.poussees;
+    entree.noeud = existant;
+    tas_ajouter(solveur, entree);
+}
+
+/**
+ * @brief Développe un noeud : crée les états obtenus par chaque poussée.
+ * Avec les macros, une caisse poussée dans un tunnel y est poussée jusqu'au
+ * bout, et une caisse poussée de l'extérieur sur l'entrée de la salle des
+ * cibles peut aussi aller d'un coup sur chaque cible libre qu'elle atteint
+ * @param solveur Solveur en cours de recherche
+ * @param n Indice du noeud à développer
+ * @param caseSokExacte Case exacte de Sokoban si connue (départ), sinon
+ * AUCUNE_CASE pour partir de la case normalisée, qui est dans la même zone
+ */
+static void noeud_developper(t_Solveur * solveur, uint32_t n,
+    int caseSokExacte){
+
+    const t_Niveau * niveau = solveur->niveau;
+    int32_t * caisses = solveur->caissesPere;
+    uint64_t * couche = solveur->couche, * zone = solveur->zone;
+    int caisse, arrivee, caseSok, nbPoussees, nbCibles, etat, longueur;
+    int poussees = solveur->noeuds[n].poussees;
+    uint64_t empreinte = ZERO;
+
+    caseSok = etat_decompacter(&solveur->etats,
+        ensemble_etat(&solveur->etats, n), caisses);
+    // Empreinte des seules caisses du père, mise à jour à chaque poussée
+    for (int i = ZERO ; i < solveur->nbCaisses ; i++) {
+        empreinte ^= niveau->zobrist[caisses[i]];
+    }
+    // La zone du père est gardée : les marques servent aux fils
+    couches_preparer(solveur, caisses,
+        caseSokExacte == AUCUNE_CASE ? caseSok : caseSokExacte);
+    minorant(solveur, caisses);
+    solveur->noeudsDeveloppes++;
+
+    for (int i = ZERO ; i < solveur->nbCaisses ; i++) {
+        caisse = caisses[i];
+        for (int d = ZERO ; d < NB_DIRECTIONS ; d++) {
+            arrivee = caisse + niveau->decalages[d];
+            // Sokoban doit pouvoir se placer derrière la caisse
+            if (!bit_lire(zone, caisse - niveau->decalages[d])
+                || bit_lire(niveau->murs, arrivee)
+                || bit_lire(couche, arrivee)) {
+                continue;
+            }
+            bit_deplacer(couche, caisse, arrivee);
+            nbPoussees = 1;
+            nbCibles = ZERO;
+            if (solveur->macros) {
+                nbPoussees += tunnel_prolonger(solveur, caisse, d, &arrivee);
+                if (arrivee == niveau->entreeSalle && !bit_lire(niveau->salle,
+                    arrivee - niveau->decalages[d])) {
+                    nbCibles = salle_parcourir(solveur, d);
+                }
+                solveur->filsMacros += nbCibles + (nbPoussees > 1);
+            }
+            // Les cibles de la salle s'ajoutent à la poussée sur l'entrée :
+            // sans ordre de remplissage calculé, garer la caisse en chemin
+            // peut être nécessaire
+            for (int k = ZERO ; k < nbCibles ; k++) {
+                etat = solveur->ciblesSalle[k];
+                longueur = nbPoussees;
+                for (int e = etat ; solveur->pereSalle[e] != e ;
+                    e = solveur->pereSalle[e]) {
+                    longueur++;
+                }
+                bit_deplacer(couche, arrivee, etat / NB_DIRECTIONS);
+                fils_ajouter(solveur, n, empreinte, i, d,
+                    etat / NB_DIRECTIONS, etat / NB_DIRECTIONS
+                    - niveau->decalages[etat % NB_DIRECTIONS],
+                    poussees + longueur);
+                bit_deplacer(couche, etat / NB_DIRECTIONS, arrivee);
+            }
+            fils_ajouter(solveur, n, empreinte, i, d, arrivee,
+                arrivee - niveau->decalages[d], poussees + nbPoussees);
+            bit_deplacer(couche, arrivee, caisse);
+        }
+    }
+}
+
+bool resoudre(const t_Niveau * niveau, const t_Etat * depart,
+    t_Minorant typeMinorant, t_Motifs * motifs, bool macros,
+    t_Solution * solution){
+
+    t_Solveur * solveur = allouer_zero(1, sizeof(t_Solveur));
+    int32_t * caissesDepart;
+    t_Noeud racine;
+    t_EntreeTas entree = {ZERO, ZERO, ZERO};
+    uint32_t position, but = AUCUN_NOEUD;
+    long long debut = horloge_us();
+    struct rusage ressources;
+    bool fini = false;
+    int caseSok;
+
+    memset(solution, 0, sizeof(*solution));
+    solveur_preparer(solveur, niveau,
+        caisses_lister(niveau, depart->caisses, NULL));
+    if (typeMinorant == MINORANT_PLUS_PROCHES) {
+        solveur->typeMinorant = MINORANT_PLUS_PROCHES;
+    }
+    solveur->motifs = motifs;
+    solveur->macros = macros;
+    if (macros && niveau->entreeSalle != AUCUNE_CASE) {
+        // Parcours de la salle : un état par case et par direction, effacés
+        // ici une fois, puis par salle_parcourir() sur ses seuls états
+        solveur->pereSalle = allouer(NULL, (size_t)DOUBLE * NB_DIRECTIONS
+            * niveau->nbCases * sizeof(int32_t));
+        solveur->fileSalle = solveur->pereSalle
+            + (size_t)NB_DIRECTIONS * niveau->nbCases;
+        solveur->ciblesSalle = allouer(NULL,
+            (solveur->nbCibles + 1) * sizeof(int32_t));
+        for (int i = ZERO ; i < NB_DIRECTIONS * niveau->nbCases ; i++) {
+            solveur->pereSalle[i] = AUCUNE_CASE;
+        }
+    }
+    caissesDepart = allouer(NULL, (solveur->nbCaisses + 1) * sizeof(int32_t));
+    caisses_lister(niveau, depart->caisses, caissesDepart);
+    solveur->capaciteNoeuds = CAPACITE_INITIALE_RECHERCHE;
+    solveur->noeuds = allouer(NULL,
+        solveur->capaciteNoeuds * sizeof(t_Noeud));
+    solveur->caissesPere = allouer(NULL,
+        (solveur->nbCaisses + 1) * sizeof(int32_t));
+    ensemble_preparer(&solveur->etats, niveau, depart);
+    solveur->etatFils = allouer(NULL, solveur->etats.taille);
+    solveur->capaciteTas = CAPACITE_INITIALE_RECHERCHE;
+    solveur->tas = allouer(NULL, solveur->capaciteTas * sizeof(t_EntreeTas));
+
+    racine.parent = AUCUN_NOEUD;
+    racine.poussees = ZERO;
+    racine.estimation = minorant(solveur, caissesDepart);
+    racine.depart = AUCUNE_CASE;
+    racine.direction = AUCUNE_DIRECTION;
+    caseSok = zone_accessible(solveur, depart->caisses, depart->caseSok, NULL);
+    etat_compacter(&solveur->etats, caissesDepart, solveur->nbCaisses, caseSok,
+        solveur->etatFils);
+    ensemble_chercher(&solveur->etats, solveur->etatFils,
+        empreinte_position(niveau, depart, caseSok), &position);
+    noeud_creer(solveur, racine, solveur->etatFils, position);
+    entree.estimation = racine.estimation;
+    tas_ajouter(solveur, entree);
+
+    // A* : on développe toujours le noeud de plus petite estimation
+    while (!fini && solveur->tailleTas > ZERO) {
+        entree = tas_retirer(solveur);
+        if (entree.poussees != solveur->noeuds[entree.noeud].poussees) {
+            continue; // Entrée périmée : le noeud a été atteint plus court
+        }
+        if (entree.estimation == entree.poussees) {
+            // Le minorant est nul : toutes les caisses sont sur une cible
+            but = entree.noeud;
+            fini = true;
+        } else {
+            noeud_developper(solveur, entree.noeud,
+                entree.noeud == ZERO ? depart->caseSok : AUCUNE_CASE);
+        }
+    }
+
+    if (but != AUCUN_NOEUD) {
+        solution_reconstruire(solveur, depart, but, solution);
+    }
+    solution->noeudsDeveloppes = solveur->noeudsDeveloppes;
+    solution->noeudsCrees = solveur->nbNoeuds;
+    solution->filsMacros = solveur->filsMacros;
+    solution->octetsEtat = solveur->etats.taille;
+    // Places prises seulement : les blocs et tableaux à moitié vides du
+    // début ne comptent pas
+    solution->memoireEtats = (size_t)solveur->nbNoeuds
+        * (solveur->etats.taille + sizeof(t_Noeud))
+        + solveur->etats.capaciteTable * sizeof(uint32_t);
+    solution->memoireRecherche = solveur_memoire_travail(solveur)
+        + ensemble_memoire(&solveur->etats)
+        + solveur->capaciteNoeuds * sizeof(t_Noeud)
+        + (solveur->nbCaisses + 1) * sizeof(int32_t) + solveur->etats.taille
+        + solveur->capaciteTas * sizeof(t_EntreeTas)
+        + (solveur->pereSalle == NULL ? ZERO : (size_t)DOUBLE * NB_DIRECTIONS
+        * niveau->nbCases * sizeof(int32_t)
+        + (solveur->nbCibles + 1) * sizeof(int32_t));
+    getrusage(RUSAGE_SELF, &ressources);
+    solution->memoireMaxKio = ressources.ru_maxrss;
+    solution->dureeUs = horloge_us() - debut;
+
+    free(caissesDepart);
+    free(solveur->noeuds);
+    free(solveur->caissesPere);
+    free(solveur->etatFils);
+    free(solveur->pereSalle);
+    free(solveur->ciblesSalle);
+    ensemble_liberer(&solveur->etats);
+    free(solveur->tas);
+    solveur_liberer_travail(solveur);
+    free(solveur);
+    return but != AUCUN_NOEUD;
+}
+
+/**
+ * @brief Tire une position au hasard : des caisses sur des cases de sol
+ * distinctes et Sokoban sur une autre
+ * @param ensemble Ensemble qui donne la numérotation du sol
+ * @param nbCaisses Nombre de caisses (moins que de cases de sol)
+ * @param compact ensemble->taille octets à remplir
+ * @return Empreinte de Zobrist de la position
+ */
+static uint64_t etat_aleatoire(const t_EnsembleEtats * ensemble,
+    int nbCaisses, uint8_t compact[]){
+
+    const t_Niveau * niveau = ensemble->niveau;
+    int numero, octetsCaisses = ensemble->taille - ensemble->octetsSok;
+    uint64_t empreinte = ZERO;
+
+    memset(compact, 0, octetsCaisses);
+    for (int i = ZERO ; i < nbCaisses ; i++) {
+        do {
+            numero = rand() % ensemble->nbSol;
+        } while (compact[numero / BITS_PAR_OCTET]
+            & 1 << (numero % BITS_PAR_OCTET));
+        compact[numero / BITS_PAR_OCTET] |= 1 << (numero % BITS_PAR_OCTET);
+        empreinte ^= niveau->zobrist[ensemble->caseSol[numero]];
+    }
+    do {
+        numero = rand() % ensemble->nbSol;
+    } while (compact[numero / BITS_PAR_OCTET]
+        & 1 << (numero % BITS_PAR_OCTET));
+    for (int i = ZERO ; i < ensemble->octetsSok ; i++) {
+        compact[octetsCaisses + i] = numero >> (i * BITS_PAR_OCTET);
+    }
+    return empreinte ^ niveau->zobristSok[ensemble->caseSol[numero]];
+}
+
+int mode_bench_etats(char fichier[], long long nbEtats){
+    t_Plateau plateau = PLATEAU_VIDE;
+    t_Niveau niveau;
+    t_Etat etat;
+    t_EnsembleEtats ensemble;
+    int32_t * caisses;
+    uint8_t * compact;
+    uint32_t position;
+    uint64_t empreinte;
+    long long debut, dureeInsertion, dureeRecherche, nbRetrouves = ZERO;
+    int nbCaisses;
+    struct rusage ressources;
+
+    moteur_verifier(charger_partie(&plateau, fichier));
+    moteur_verifier(etat_depuis_plateau(&plateau, &niveau, &etat));
+    ensemble_preparer(&ensemble, &niveau, &etat);
+    nbCaisses = caisses_lister(&niveau, etat.caisses, NULL);
+    if (nbCaisses >= ensemble.nbSol || nbEtats < 1) {
+        printf("Niveau sans place pour Sokoban ou aucun état à tirer\n");
+        return EXIT_FAILURE;
+    }
+    caisses = allouer(NULL, (nbCaisses + 1) * sizeof(int32_t));
+    compact = allouer(NULL, ensemble.taille);
+
+    srand(1);
+    debut = horloge_us();
+    for (long long i = ZERO ; i < nbEtats ; i++) {
+        empreinte = etat_aleatoire(&ensemble, nbCaisses, compact);
+        if (ensemble_chercher(&ensemble, compact, empreinte, &position)
+            == AUCUN_NOEUD) {
+            ensemble_ajouter(&ensemble, compact, position, caisses);
+        }
+    }
+    dureeInsertion = horloge_us() - debut;
+    // Mêmes tirages : chaque position doit être retrouvée
+    srand(1);
+    debut = horloge_us();
+    for (long long i = ZERO ; i < nbEtats ; i++) {
+        empreinte = etat_aleatoire(&ensemble, nbCaisses, compact);
+        nbRetrouves += ensemble_chercher(&ensemble, compact, empreinte,
+            &position) != AUCUN_NOEUD;
+    }
+    dureeRecherche = horloge_us() - debut;
+    getrusage(RUSAGE_SELF, &ressources);
+
+    printf("Sol : %d cases, %d caisses\n", ensemble.nbSol, nbCaisses);
+    printf("États tirés : %lld, distincts : %u, retrouvés : %lld\n",
+        nbEtats, ensemble.nbEtats, nbRetrouves);
+    printf("Octets par état : %d compacts, %.1f avec l'arène et la table\n",
+        ensemble.taille,
+        (double)ensemble_memoire(&ensemble) / ensemble.nbEtats);
+    printf("Insertion : %.1f ns, recherche : %.1f ns par état\n",
+        dureeInsertion * (double)MILLE / nbEtats,
+        dureeRecherche * (double)MILLE / nbEtats);
+    printf("Mémoire maximale du processus : %ld Kio\n", ressources.ru_maxrss);
+
+    free(caisses);
+    free(compact);
+    ensemble_liberer(&ensemble);
+    etat_liberer(&etat);
+    niveau_liberer(&niveau);
+    plateau_liberer(&plateau);
+    return nbRetrouves == nbEtats ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int mode_resoudre_parallele(char fichier[], int nbFils,
+    char fichierSolution[]){
+
+    t_Plateau plateau = PLATEAU_VIDE;
+    t_Niveau niveau;
+    t_Etat etat;
+    t_Solution solution;
+    bool trouvee;
+
+    if (nbFils < 1 || nbFils > NB_FILS_MAX) {
+        printf("Nombre de fils entre 1 et %d\n", NB_FILS_MAX);
+        return EXIT_FAILURE;
+    }
+    moteur_verifier(charger_partie(&plateau, fichier));
+    moteur_verifier(etat_depuis_plateau(&plateau, &niveau, &etat));
+    trouvee = resoudre_parallele(&niveau, &etat, nbFils, &solution);
+    solution_afficher(&solution, trouvee, fichierSolution);
+    solution_liberer(&solution);
+    etat_liberer(&etat);
+    niveau_liberer(&niveau);
+    plateau_liberer(&plateau);
+    return trouvee ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
-void ajout_deplacement_caisse(char *dernierDepla){
-    if (*dernierDepla == SOKOBAN_GAUCHE) {
-        *dernierDepla = SOKOBAN_CAISSE_GAUCHE;
+/**
+ * @brief Résout des niveaux avec plusieurs réglages du solveur et compare les
+ * noeuds développés, les fils obtenus par une macro et les durées
+ * @param nbFichiers Nombre de niveaux
+ * @param fichiers Fichiers des niveaux
+ * @param colonne Titre de la colonne des réglages
+ * @param reglages Réglages comparés, le premier servant de référence au gain
+ * @param nbReglages Nombre de réglages
+ * @return EXIT_SUCCESS si tous les réglages trouvent partout une solution
+ * avec le même nombre de poussées
+ */
+static int bench_reglages(int nbFichiers, char * fichiers[],
+    const char colonne[], const t_ReglageSolveur reglages[], int nbReglages){
+
+    t_Plateau plateau = PLATEAU_VIDE;
+    t_Niveau niveau;
+    t_Etat etat;
+    t_Solution solution;
+    long long developpes[nbReglages];
+    int poussees[nbReglages];
+    bool trouvee, identiques = true;
 
-    } else if (*dernierDepla == SOKOBAN_DROITE) {
-        *dernierDepla = SOKOBAN_CAISSE_DROITE;
+    printf("%-20s %-13s %9s %12s %12s %9s %10s\n", "Niveau", colonne,
+        "Poussées", "Développés", "Créés", "Macros", "Durée ms");
+    for (int i = ZERO ; i < nbFichiers ; i++) {
+        moteur_verifier(charger_partie(&plateau, fichiers[i]));
+        moteur_verifier(etat_depuis_plateau(&plateau, &niveau, &etat));
+        for (int r = ZERO ; r < nbReglages ; r++) {
+            trouvee = resoudre(&niveau, &etat, reglages[r].typeMinorant, NULL,
+                reglages[r].macros, &solution);
+            developpes[r] = solution.noeudsDeveloppes;
+            poussees[r] = trouvee ? solution.nbPoussees : AUCUN_DEPLACEMENT;
+            printf("%-20s %-13s %9d %12lld %12lld %9lld %10.1f\n", fichiers[i],
+                reglages[r].nom, poussees[r], solution.noeudsDeveloppes,
+                solution.noeudsCrees, solution.filsMacros,
+                solution.dureeUs / (double)MILLE);
+            solution_liberer(&solution);
+            identiques = identiques && poussees[r] != AUCUN_DEPLACEMENT
+                && poussees[r] == poussees[0];
+        }
+        printf("%-20s %-13s %9s %11.1fx\n", "", "gain", "",
+            developpes[nbReglages - 1] > ZERO
+            ? (double)developpes[0] / developpes[nbReglages - 1] : ZERO);
+        etat_liberer(&etat);
+        niveau_liberer(&niveau);
+        plateau_liberer(&plateau);
+    }
+    printf("Mêmes poussées : %s\n", identiques ? "oui" : "non");
+    return identiques ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
-    } else if (*dernierDepla == SOKOBAN_HAUT) {
-        *dernierDepla = SOKOBAN_CAISSE_HAUT;
+int mode_bench_minorant(int nbFichiers, char * fichiers[]){
+    const t_ReglageSolveur REGLAGES[] = {
+        {"plus proches", MINORANT_PLUS_PROCHES, false},
+        {"affectation", MINORANT_AFFECTATION, false}};
 
+    return bench_reglages(nbFichiers, fichiers, "Minorant", REGLAGES,
+        sizeof(REGLAGES) / sizeof(REGLAGES[0]));
+}
+
+int mode_bench_macros(int nbFichiers, char * fichiers[]){
+    const t_ReglageSolveur REGLAGES[] = {
+        {"sans macros", MINORANT_AFFECTATION, false},
+        {"macros", MINORANT_AFFECTATION, true}};
+
+    return bench_reglages(nbFichiers, fichiers, "Recherche", REGLAGES,
+        sizeof(REGLAGES) / sizeof(REGLAGES[0]));
+}
+
+int mode_bench_parallele(int nbFichiers, char * fichiers[]){
+    const int NB_FILS_BENCH[] = {1, 2, 4, 8, 16};
+    const int NB_MESURES = sizeof(NB_FILS_BENCH) / sizeof(NB_FILS_BENCH[0]);
+    t_Plateau plateau = PLATEAU_VIDE;
+    t_Niveau * niveaux = allouer(NULL, nbFichiers * sizeof(t_Niveau));
+    t_Etat * etats = allouer(NULL, nbFichiers * sizeof(t_Etat));
+    t_Solution solution;
+    long long duree, dureeUnFil = ZERO, developpes;
+    bool tousResolus = true;
+
+    for (int i = ZERO ; i < nbFichiers ; i++) {
+        moteur_verifier(charger_partie(&plateau, fichiers[i]));
+        moteur_verifier(etat_depuis_plateau(&plateau, &niveaux[i], &etats[i]));
+    }
+    plateau_liberer(&plateau);
+    printf("Processeurs disponibles : %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%6s %12s %14s %12s\n", "Fils", "Durée (ms)", "Noeuds", "Accélération");
+    for (int m = ZERO ; m < NB_MESURES ; m++) {
+        duree = ZERO;
+        developpes = ZERO;
+        for (int i = ZERO ; i < nbFichiers ; i++) {
+            if (!resoudre_parallele(&niveaux[i], &etats[i], NB_FILS_BENCH[m],
+                &solution)) {
+                printf("%s : aucune solution\n", fichiers[i]);
+                tousResolus = false;
+            }
+            duree += solution.dureeUs;
+            developpes += solution.noeudsDeveloppes;
+            solution_liberer(&solution);
+        }
+        if (m == ZERO) {
+            dureeUnFil = duree;
+        }
+        printf("%6d %12.3f %14lld %12.2f\n", NB_FILS_BENCH[m],
+            (double)duree / MILLE, developpes,
+            duree > ZERO ? (double)dureeUnFil / duree : 1.0);
+    }
+    for (int i = ZERO ; i < nbFichiers ; i++) {
+        etat_liberer(&etats[i]);
+        niveau_liberer(&niveaux[i]);
+    }
+    free(niveaux);
+    free(etats);
+    return tousResolus ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Réserve un noeud dans les blocs d'un fil
+ * @param ouvrier Fil propriétaire du noeud
+ * @return Noeud non initialisé, qui ne sera jamais déplacé
+ */
+static t_NoeudParallele * ouvrier_nouveau_noeud(t_Ouvrier * ouvrier){
+    size_t taille = sizeof(t_NoeudParallele)
+        + ouvrier->partage->nbCaisses * sizeof(int32_t);
+    t_BlocNoeuds * bloc = ouvrier->blocs;
+    t_NoeudParallele * noeud;
+
+    // Taille arrondie pour garder l'alignement des noeuds
+    taille = (taille + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *);
+    if (bloc == NULL || bloc->utilise + taille > TAILLE_BLOC_NOEUDS) {
+        bloc = allouer(NULL, sizeof(t_BlocNoeuds) + TAILLE_BLOC_NOEUDS);
+        bloc->suivant = ouvrier->blocs;
+        bloc->utilise = ZERO;
+        ouvrier->blocs = bloc;
+    }
+    noeud = (t_NoeudParallele *)(bloc->octets + bloc->utilise);
+    bloc->utilise += taille;
+    ouvrier->noeudsCrees++;
+    return noeud;
+}
+
+/**
+ * @brief Rend le dernier noeud réservé par un fil, qui n'a pas servi
+ * @param ouvrier Fil propriétaire du noeud
+ */
+static void ouvrier_rendre_noeud(t_Ouvrier * ouvrier){
+    size_t taille = sizeof(t_NoeudParallele)
+        + ouvrier->partage->nbCaisses * sizeof(int32_t);
+    taille = (taille + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *);
+    ouvrier->blocs->utilise -= taille;
+    ouvrier->noeudsCrees--;
+}
+
+/**
+ * @brief Ajoute un noeud en bas de la pile d'un fil
+ * @param deque Pile du fil
+ * @param noeud Noeud à ajouter
+ */
+static void deque_empiler(t_Deque * deque, t_NoeudParallele * noeud){
+    pthread_mutex_lock(&deque->verrou);
+    if (deque->bas == deque->capacite) {
+        // On récupère d'abord la place laissée en haut par les vols
+        if (deque->haut > ZERO) {
+            memmove(deque->elements, deque->elements + deque->haut,
+                (deque->bas - deque->haut) * sizeof(t_NoeudParallele *));
+            deque->bas -= deque->haut;
+            deque->haut = ZERO;
+        }
+        if (deque->bas == deque->capacite) {
+            deque->capacite = deque->capacite * DOUBLE
+                + CAPACITE_INITIALE_RECHERCHE;
+            deque->elements = allouer(deque->elements,
+                deque->capacite * sizeof(t_NoeudParallele *));
+        }
+    }
+    deque->elements[deque->bas++] = noeud;
+    pthread_mutex_unlock(&deque->verrou);
+}
+
+/**
+ * @brief Retire un noeud d'une pile, en bas (propriétaire) ou en haut (vol)
+ * @param deque Pile à vider
+ * @param enHaut true pour voler le noeud le plus ancien
+ * @return Noeud retiré, NULL si la pile est vide
+ */
+static t_NoeudParallele * deque_retirer(t_Deque * deque, bool enHaut){
+    t_NoeudParallele * noeud = NULL;
+
+    pthread_mutex_lock(&deque->verrou);
+    if (deque->haut < deque->bas) {
+        noeud = enHaut ? deque->elements[deque->haut++]
+            : deque->elements[--deque->bas];
+        if (deque->haut == deque->bas) {
+            deque->haut = ZERO;
+            deque->bas = ZERO;
+        }
+    }
+    pthread_mutex_unlock(&deque->verrou);
+    return noeud;
+}
+
+/**
+ * @brief Indique si deux noeuds sont le même état : mêmes caisses et même
+ * zone de Sokoban
+ * @param partage Données communes de la recherche
+ * @param a Premier noeud
+ * @param b Second noeud
+ * @return true si les deux états sont identiques
+ */
+static bool noeuds_identiques(const t_RecherchePartagee * partage,
+    const t_NoeudParallele * a, const t_NoeudParallele * b){
+
+    return a->empreinte == b->empreinte && a->caseSok == b->caseSok
+        && memcmp(a->caisses, b->caisses,
+        partage->nbCaisses * sizeof(int32_t)) == ZERO;
+}
+
+/**
+ * @brief Marque un état comme vu dans la table partagée, qui garde l'adresse
+ * de son noeud. Une empreinte égale ne suffit pas : l'état déjà rangé est
+ * comparé en entier, si bien qu'une collision ne fait jamais écarter un état
+ * @param partage Données communes de la recherche
+ * @param noeud Noeud de l'état, dont les caisses, la case de Sokoban et
+ * l'empreinte sont remplies et ne changeront plus
+ * @return true si l'état n'avait encore jamais été vu (le noeud est alors
+ * rangé dans la table)
+ */
+static bool table_partagee_inserer(t_RecherchePartagee * partage,
+    t_NoeudParallele * noeud){
+
+    uint64_t position = (noeud->empreinte
+        ^ partage->niveau->zobristSok[noeud->caseSok]) & partage->masqueTable;
+    t_NoeudParallele * present;
+
+    for (int essai = ZERO ; essai < SONDAGES_MAX_TABLE ; essai++) {
+        present = atomic_load_explicit(&partage->table[position],
+            memory_order_acquire);
+        // La place est libre : un seul fil réussira à la prendre ; sinon
+        // present devient le noeud qui l'a prise
+        if (present == NULL && atomic_compare_exchange_strong(
+            &partage->table[position], &present, noeud)) {
+            return true;
+        }
+        if (noeuds_identiques(partage, present, noeud)) {
+            return false;
+        }
+        position = (position + 1) & partage->masqueTable;
+    }
+    // Zone de la table pleine : l'état est développé, au pire deux fois
+    return true;
+}
+
+/**
+ * @brief Développe un noeud pour un fil : les fils de ce noeud sont empilés
+ * du moins bon au meilleur pour que le meilleur soit développé en premier
+ * @param ouvrier Fil qui développe le noeud
+ * @param noeud Noeud à développer
+ * @param caseSokExacte Case de Sokoban dans la zone du noeud
+ */
+static void ouvrier_developper(t_Ouvrier * ouvrier, t_NoeudParallele * noeud,
+    int caseSokExacte){
+
+    t_RecherchePartagee * partage = ouvrier->partage;
+    t_Solveur * outils = ouvrier->outils;
+    const t_Niveau * niveau = partage->niveau;
+    int nbCaisses = partage->nbCaisses, caisse, arrivee, nbFils = ZERO;
+    int estimation;
+    uint64_t * couche = outils->couche, * zone = outils->zone;
+    t_NoeudParallele ** fils = ouvrier->fils, * echange;
+    t_NoeudParallele * attendu = NULL, * libre = NULL;
+    const uint64_t * zobrist = niveau->zobrist;
+
+    couches_preparer(outils, noeud->caisses, caseSokExacte);
+    minorant(outils, noeud->caisses);
+    ouvrier->noeudsDeveloppes++;
+
+    for (int i = ZERO ; i < nbCaisses && !atomic_load(&partage->fini) ; i++) {
+        caisse = noeud->caisses[i];
+        for (int d = ZERO ; d < NB_DIRECTIONS ; d++) {
+            arrivee = caisse + niveau->decalages[d];
+            if (!bit_lire(zone, caisse - niveau->decalages[d])
+                || bit_lire(niveau->murs, arrivee)
+                || bit_lire(couche, arrivee)) {
+                continue;
+            }
+            bit_deplacer(couche, caisse, arrivee);
+            estimation = poussee_bloquante(niveau, couche, arrivee)
+                ? INFINI_POUSSEES
+                : minorant_poussee(outils, noeud->caisses, i, arrivee);
+            bit_deplacer(couche, arrivee, caisse);
+            if (estimation == INFINI_POUSSEES) {
+                continue;
+            }
+            if (libre == NULL) {
+                libre = ouvrier_nouveau_noeud(ouvrier);
+            }
+            memcpy(libre->caisses, noeud->caisses,
+                nbCaisses * sizeof(int32_t));
+            caisses_remplacer(libre->caisses, nbCaisses, i, arrivee);
+            bit_deplacer(couche, caisse, arrivee);
+            libre->caseSok = zone_remplir(niveau, couche, caisse,
+                outils->zoneFils);
+            bit_deplacer(couche, arrivee, caisse);
+            libre->empreinte = noeud->empreinte ^ zobrist[caisse]
+                ^ zobrist[arrivee];
+            if (!table_partagee_inserer(partage, libre)) {
+                continue; // Le noeud réservé servira au fils suivant
+            }
+            libre->parent = noeud;
+            libre->poussees = noeud->poussees + 1;
+            libre->depart = caisse;
+            libre->direction = d;
+            libre->estimation = estimation;
+            if (libre->estimation == ZERO) {
+                // Toutes les caisses sont sur une cible
+                if (atomic_compare_exchange_strong(&partage->but, &attendu,
+                    libre)) {
+                    atomic_store(&partage->fini, true);
+                }
+                return;
+            }
+            fils[nbFils++] = libre;
+            libre = NULL;
+        }
+    }
+    if (libre != NULL) {
+        ouvrier_rendre_noeud(ouvrier);
+    }
+    // Tri par insertion : estimation décroissante
+    for (int i = 1 ; i < nbFils ; i++) {
+        for (int j = i ; j > ZERO
+            && fils[j - 1]->estimation < fils[j]->estimation ; j--) {
+            echange = fils[j];
+            fils[j] = fils[j - 1];
+            fils[j - 1] = echange;
+        }
+    }
+    atomic_fetch_add(&partage->enCours, nbFils);
+    for (int i = ZERO ; i < nbFils ; i++) {
+        deque_empiler(&ouvrier->deque, fils[i]);
+    }
+}
+
+/**
+ * @brief Boucle d'un fil : développe ses noeuds, vole quand il n'en a plus
+ * @param argument Le t_Ouvrier du fil
+ * @return NULL
+ */
+static void * ouvrier_travailler(void * argument){
+    t_Ouvrier * ouvrier = argument;
+    t_RecherchePartagee * partage = ouvrier->partage;
+    t_NoeudParallele * noeud;
+    int victime;
+
+    while (!atomic_load(&partage->fini)) {
+        noeud = deque_retirer(&ouvrier->deque, false);
+        for (int essai = ZERO ; noeud == NULL && partage->nbOuvriers > 1
+            && essai < NB_ESSAIS_VOL * partage->nbOuvriers ; essai++) {
+            victime = rand_r(&ouvrier->graine) % partage->nbOuvriers;
+            if (victime != ouvrier->numero) {
+                noeud = deque_retirer(&partage->ouvriers[victime].deque, true);
+            }
+        }
+        if (noeud == NULL) {
+            // Plus rien en attente nulle part : la recherche est épuisée
+            if (atomic_load(&partage->enCours) == ZERO) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        ouvrier_developper(ouvrier, noeud, noeud->caseSok);
+        atomic_fetch_sub(&partage->enCours, 1);
+    }
+    return NULL;
+}
+
+bool resoudre_parallele(const t_Niveau * niveau, const t_Etat * depart,
+    int nbFils, t_Solution * solution){
+
+    t_RecherchePartagee partage;
+    t_Ouvrier * ouvriers = allouer_zero(nbFils, sizeof(t_Ouvrier));
+    t_NoeudParallele * racine, * but;
+    t_BlocNoeuds * bloc;
+    int32_t * departs, * directions;
+    int nbPoussees = ZERO;
+    size_t tailleTable = (size_t)1 << BITS_TABLE_PARALLELE;
+    long long debut = horloge_us();
+    struct rusage ressources;
+    bool trouvee;
+
+    memset(solution, 0, sizeof(*solution));
+    memset(&partage, 0, sizeof(partage));
+    partage.niveau = niveau;
+    partage.nbOuvriers = nbFils;
+    partage.ouvriers = ouvriers;
+    partage.table = allouer_zero(tailleTable, sizeof(*partage.table));
+    partage.masqueTable = tailleTable - 1;
+    atomic_init(&partage.enCours, 1);
+    atomic_init(&partage.fini, false);
+    atomic_init(&partage.but, NULL);
+    partage.nbCaisses = caisses_lister(niveau, depart->caisses, NULL);
+    for (int i = ZERO ; i < nbFils ; i++) {
+        ouvriers[i].numero = i;
+        ouvriers[i].graine = i + 1;
+        ouvriers[i].partage = &partage;
+        ouvriers[i].outils = allouer_zero(1, sizeof(t_Solveur));
+        solveur_preparer(ouvriers[i].outils, niveau, partage.nbCaisses);
+        ouvriers[i].fils = allouer(NULL, (partage.nbCaisses + 1)
+            * NB_DIRECTIONS * sizeof(t_NoeudParallele *));
+        pthread_mutex_init(&ouvriers[i].deque.verrou, NULL);
+    }
+
+    // La racine est la position de départ, confiée au premier fil
+    racine = ouvrier_nouveau_noeud(&ouvriers[0]);
+    racine->parent = NULL;
+    racine->poussees = ZERO;
+    racine->depart = AUCUNE_CASE;
+    racine->direction = AUCUNE_DIRECTION;
+    caisses_lister(niveau, depart->caisses, racine->caisses);
+    racine->estimation = minorant(ouvriers[0].outils, racine->caisses);
+    racine->caseSok = zone_accessible(ouvriers[0].outils, depart->caisses,
+        depart->caseSok, NULL);
+    racine->empreinte = depart->empreinte;
+    table_partagee_inserer(&partage, racine);
+    if (racine->estimation == ZERO) {
+        atomic_store(&partage.but, racine);
+        atomic_store(&partage.fini, true);
     } else {
-        *dernierDepla = SOKOBAN_CAISSE_BAS;
-    }
-}
-
-void annulation_deplacer(t_Plateau plateau, int *ligSok, int *colSok,
-    int *nbDepla, t_tabDeplacement histoDepla){
-
-    int incrLigSok = ZERO, incrColSok = ZERO;
-    // incrLigSok et incrColSok changent en fonction de la direction choisie
-    if(histoDepla[*nbDepla + ENLEVER] == SOKOBAN_HAUT) {
-        incrLigSok = AJOUTER;
-    } else if (histoDepla[*nbDepla + ENLEVER] == SOKOBAN_BAS) {
-        incrLigSok = ENLEVER;
-    } else if (histoDepla[*nbDepla + ENLEVER] == SOKOBAN_GAUCHE) {
-        incrColSok = AJOUTER;
-    } else if (histoDepla[*nbDepla + ENLEVER] == SOKOBAN_DROITE) {
-        incrColSok = ENLEVER;
-    } else if (histoDepla[*nbDepla + ENLEVER] == SOKOBAN_CAISSE_HAUT) {
-        incrLigSok = ENLEVER;
-    } else if (histoDepla[*nbDepla + ENLEVER] == SOKOBAN_CAISSE_BAS) {
-        incrLigSok = AJOUTER;
-    } else if (histoDepla[*nbDepla + ENLEVER] == SOKOBAN_CAISSE_GAUCHE) {
-        incrColSok = ENLEVER;
-    } else if (histoDepla[*nbDepla + ENLEVER] == SOKOBAN_CAISSE_DROITE){
-        incrColSok = AJOUTER;
-    }
-
-    // Le déplacement se fait en fonction du cas dans lequel le joueur se trouve
-    if(plateau[*ligSok+incrLigSok][*colSok+incrColSok] == RIEN){
-        annule_deplacement_rien(plateau, &*ligSok, &*colSok, incrLigSok,
-            incrColSok, &*nbDepla, histoDepla);
-    } else if (plateau[*ligSok+incrLigSok][*colSok+incrColSok] == CAISSE) {
-        annule_deplacement_caisse(plateau, &*ligSok, &*colSok, incrLigSok,
-            incrColSok, &*nbDepla, histoDepla);
-    } else if (plateau[*ligSok+incrLigSok][*colSok+incrColSok] == 
-        CAISSE_CIBLE) {
-        annule_deplacement_caisse_cible(plateau, &*ligSok, &*colSok, incrLigSok,
-            incrColSok, &*nbDepla, histoDepla);
-    } else if (plateau[*ligSok+incrLigSok][*colSok+incrColSok] == CIBLE) {
-        annule_deplacement_cible(plateau, &*ligSok, &*colSok, incrLigSok,
-            incrColSok, &*nbDepla, histoDepla);
-    }
-}
-
-void annule_deplacement_rien(t_Plateau plateau, int *ligSok, int *colSok,
-    int incrLigSok, int incrColSok, int *nbDepla, t_tabDeplacement histoDepla){
-
-    // Si Sokoban se trouve sur une cible
-    if (plateau[*ligSok][*colSok] == SOKOBAN_CIBLE){
-        plateau[*ligSok][*colSok] = CIBLE;
-        plateau[*ligSok+incrLigSok][*colSok+incrColSok] = SOKOBAN;
-        annulation_deplacement(histoDepla, *nbDepla + ENLEVER);
-        
-        annulation_deplacement_sokoban(incrLigSok, incrColSok, &*ligSok,
-            &*colSok, &*nbDepla);
-    } else {
-        plateau[*ligSok][*colSok] = RIEN;
-        plateau[*ligSok+incrLigSok][*colSok+incrColSok] = SOKOBAN;
-        annulation_deplacement(histoDepla, *nbDepla + ENLEVER);
-        
-        annulation_deplacement_sokoban(incrLigSok, incrColSok, &*ligSok,
-            &*colSok, &*nbDepla);
+        deque_empiler(&ouvriers[0].deque, racine);
+    }
+
+    for (int i = ZERO ; i < nbFils ; i++) {
+        pthread_create(&ouvriers[i].fil, NULL, ouvrier_travailler,
+            &ouvriers[i]);
+    }
+    for (int i = ZERO ; i < nbFils ; i++) {
+        pthread_join(ouvriers[i].fil, NULL);
     }
+
+    // Reconstruction : on remonte les parents puis on rejoue les poussées
+    but = atomic_load(&partage.but);
+    trouvee = (but != NULL);
+    if (trouvee) {
+        for (t_NoeudParallele * n = but ; n->parent != NULL ; n = n->parent) {
+            nbPoussees++;
+        }
+        departs = allouer(NULL, (nbPoussees + 1) * sizeof(int32_t));
+        directions = allouer(NULL, (nbPoussees + 1) * sizeof(int32_t));
+        for (int i = nbPoussees ; i > ZERO ; i--) {
+            departs[i - 1] = but->depart;
+            directions[i - 1] = but->direction;
+            but = but->parent;
+        }
+        solution_rejouer(ouvriers[0].outils, depart, nbPoussees, departs,
+            directions, solution);
+        free(departs);
+        free(directions);
+    }
+
+    solution->memoireRecherche = tailleTable * sizeof(*partage.table);
+    for (int i = ZERO ; i < nbFils ; i++) {
+        solution->memoireRecherche +=
+            solveur_memoire_travail(ouvriers[i].outils)
+            + (partage.nbCaisses + 1) * NB_DIRECTIONS
+            * sizeof(t_NoeudParallele *);
+        solution->noeudsDeveloppes += ouvriers[i].noeudsDeveloppes;
+        solution->noeudsCrees += ouvriers[i].noeudsCrees;
+        solution->memoireRecherche += ouvriers[i].deque.capacite
+            * sizeof(t_NoeudParallele *);
+        while ((bloc = ouvriers[i].blocs) != NULL) {
+            ouvriers[i].blocs = bloc->suivant;
+            solution->memoireRecherche += TAILLE_BLOC_NOEUDS;
+            free(bloc);
+        }
+        free(ouvriers[i].deque.elements);
+        free(ouvriers[i].fils);
+        solveur_liberer_travail(ouvriers[i].outils);
+        free(ouvriers[i].outils);
+        pthread_mutex_destroy(&ouvriers[i].deque.verrou);
+    }
+    getrusage(RUSAGE_SELF, &ressources);
+    solution->memoireMaxKio = ressources.ru_maxrss;
+    solution->dureeUs = horloge_us() - debut;
+    free(partage.table);
+    free(ouvriers);
+    return trouvee;
 }
 
-void annule_deplacement_caisse(t_Plateau plateau, int *ligSok, int *colSok,
-    int incrLigSok, int incrColSok, int *nbDepla, t_tabDeplacement histoDepla){
+/**
+ * @brief Construit une carte carrée entourée de murs, dont chaque case
+ * intérieure est tirée au hasard : mur, caisse ou vide. Sokoban est au centre
+ * @param plateau Plateau à remplir
+ * @param cote Nombre de lignes et de colonnes, murs compris
+ * @param pourcentMurs Part des cases intérieures qui sont des murs
+ * @param pourcentCaisses Part des cases intérieures qui sont des caisses
+ */
+static void carte_construire(t_Plateau * plateau, int cote, int pourcentMurs,
+    int pourcentCaisses){
+
+    const int CENT = 100;
+    int tirage;
+    char * c;
 
-    int invIncrColSok = incrColSok*INVERSE, invIncrLigSok = incrLigSok*INVERSE;
-    
-    // Si 2 cases plus loin il ne se trouve rien
-    if (plateau[*ligSok+invIncrLigSok][*colSok+invIncrColSok] == RIEN){
-        // Si Sokoban se trouve sur une cible
-        if (plateau[*ligSok][*colSok] == SOKOBAN_CIBLE){
-            plateau[*ligSok+invIncrLigSok][*colSok+invIncrColSok] = SOKOBAN;
-            plateau[*ligSok+incrLigSok][*colSok+incrColSok] = RIEN;
-            plateau[*ligSok][*colSok] = CAISSE_CIBLE;
-            annulation_deplacement(histoDepla, *nbDepla + ENLEVER);
-            annulation_deplacement_sokoban(invIncrLigSok, invIncrColSok,
-                &*ligSok, &*colSok, &*nbDepla);
-        } else {
-            plateau[*ligSok+invIncrLigSok][*colSok+invIncrColSok] = SOKOBAN;
-            plateau[*ligSok+incrLigSok][*colSok+incrColSok] = RIEN;
-            plateau[*ligSok][*colSok] = CAISSE;
-            annulation_deplacement(histoDepla, *nbDepla + ENLEVER);
-            annulation_deplacement_sokoban(invIncrLigSok, invIncrColSok,
-                &*ligSok, &*colSok, &*nbDepla);
-        }
-    // Sinon si 2 cases plus loin il se trouve une cible
-    } else if (plateau[*ligSok+invIncrLigSok][*colSok+invIncrColSok] == CIBLE) {
-
-        // Si Sokoban se trouve sur une cible
-        if (plateau[*ligSok][*colSok] == SOKOBAN_CIBLE){
-            plateau[*ligSok+invIncrLigSok]
-            [*colSok+invIncrColSok] = SOKOBAN_CIBLE;
-
-            plateau[*ligSok+incrLigSok][*colSok+incrColSok] = RIEN;
-            plateau[*ligSok][*colSok] = CAISSE_CIBLE;
-            annulation_deplacement(histoDepla, *nbDepla + ENLEVER);
-            annulation_deplacement_sokoban(invIncrLigSok, invIncrColSok,
-                &*ligSok, &*colSok, &*nbDepla);
+    moteur_verifier(plateau_allouer(plateau, cote, cote));
+    memset(plateau->cases, MUR, cote * cote);
+    plateau->nbCaisses = ZERO;
+    srand(cote + pourcentMurs * CENT + pourcentCaisses);
+    for (int lig = 1 ; lig < cote - 1 ; lig++) {
+        for (int col = 1 ; col < cote - 1 ; col++) {
+            c = &plateau->cases[lig * cote + col];
+            tirage = rand() % CENT;
+            if (tirage >= pourcentMurs + pourcentCaisses) {
+                *c = RIEN;
+            } else if (tirage >= pourcentMurs) {
+                *c = CAISSE;
+                plateau->nbCaisses++;
+            }
+        }
+    }
+    plateau->ligneSok = cote / DOUBLE;
+    plateau->colonneSok = cote / DOUBLE;
+    plateau->cases[plateau->ligneSok * cote + plateau->colonneSok] = SOKOBAN;
+    plateau->nbCibles = ZERO;
+}
+
+/**
+ * @brief Construit une carte carrée en serpentin : une ligne sur deux est un
+ * mur percé à un bout, à droite puis à gauche. La zone est un seul couloir
+ * qui change de sens à chaque ligne, le pire cas du remplissage par passes
+ * @param plateau Plateau à remplir
+ * @param cote Nombre de lignes et de colonnes, murs compris
+ */
+static void serpentin_construire(t_Plateau * plateau, int cote){
+    carte_construire(plateau, cote, ZERO, ZERO);
+    for (int lig = DOUBLE ; lig < cote - DOUBLE ; lig += DOUBLE) {
+        memset(&plateau->cases[lig * cote + 1], MUR, cote - DOUBLE);
+        if (lig % (DOUBLE * DOUBLE) == DOUBLE) {
+            plateau->cases[lig * cote + cote - DOUBLE] = RIEN;
         } else {
-            plateau[*ligSok+invIncrLigSok]
-            [*colSok+invIncrColSok] = SOKOBAN_CIBLE;
+            plateau->cases[lig * cote + 1] = RIEN;
+        }
+    }
+    plateau->cases[plateau->ligneSok * cote + plateau->colonneSok] = RIEN;
+    plateau->ligneSok = 1;
+    plateau->colonneSok = 1;
+    plateau->cases[cote + 1] = SOKOBAN;
+}
+
+/**
+ * @brief Mesure les deux calculs de la zone de Sokoban sur un plateau et
+ * affiche une ligne du tableau de comparaison
+ * @param nom Nom du plateau
+ * @param plateau Plateau à mesurer
+ * @return true si les deux calculs donnent la même zone et la même case
+ * normalisée
+ */
+static bool bench_zone(const char nom[], const t_Plateau * plateau){
+    t_Niveau niveau;
+    t_Etat etat;
+    t_Solveur * solveur = allouer_zero(1, sizeof(t_Solveur));
+    uint64_t * zone;
+    long long debut, dureeParcours, dureeRemplissage;
+    int nbAppels, normaliseeParcours = ZERO, normaliseeRemplissage = ZERO;
+    bool identiques;
+
+    moteur_verifier(etat_depuis_plateau(plateau, &niveau, &etat));
+    solveur_preparer(solveur, &niveau, plateau->nbCaisses);
+    zone = couches_creer(niveau.nbMots, 1);
+
+    // Même nombre de cases visitées par mesure, quelle que soit la zone
+    zone_accessible(solveur, etat.caisses, etat.caseSok, NULL);
+    nbAppels = NB_CASES_REMPLIES_BENCH / solveur->tailleZone + 1;
+    debut = horloge_us();
+    for (int i = ZERO ; i < nbAppels ; i++) {
+        normaliseeParcours = zone_accessible(solveur, etat.caisses,
+            etat.caseSok, NULL);
+    }
+    dureeParcours = horloge_us() - debut;
+    debut = horloge_us();
+    for (int i = ZERO ; i < nbAppels ; i++) {
+        normaliseeRemplissage = zone_remplir(&niveau, etat.caisses,
+            etat.caseSok, zone);
+    }
+    dureeRemplissage = horloge_us() - debut;
+
+    // Chaque case de la zone remplie doit avoir été visitée par le parcours
+    identiques = normaliseeParcours == normaliseeRemplissage;
+    for (int numCase = ZERO ; numCase < niveau.nbCases ; numCase++) {
+        identiques = identiques && bit_lire(zone, numCase)
+            == (solveur->marque[numCase] == solveur->generation);
+    }
+    printf("%-26s %8d %6d %12.1f %12.1f %8.2f %s\n", nom, niveau.nbCases,
+        solveur->tailleZone,
+        dureeParcours * (double)MILLE / nbAppels,
+        dureeRemplissage * (double)MILLE / nbAppels,
+        dureeRemplissage > ZERO
+        ? (double)dureeParcours / dureeRemplissage : ZERO,
+        identiques ? "" : "DIFFÉRENTES");
+
+    free(zone);
+    solveur_liberer_travail(solveur);
+    free(solveur);
+    etat_liberer(&etat);
+    niveau_liberer(&niveau);
+    return identiques;
+}
+
+int mode_bench_zone(int nbFichiers, char * fichiers[]){
+    t_Plateau plateau = PLATEAU_VIDE;
+    bool identiques = true;
+
+    printf("%-26s %8s %6s %12s %12s %8s\n", "Plateau", "Cases", "Zone",
+        "Parcours ns", "Mots ns", "Gain");
+    for (int i = ZERO ; i < nbFichiers ; i++) {
+        moteur_verifier(charger_partie(&plateau, fichiers[i]));
+        identiques = bench_zone(fichiers[i], &plateau) && identiques;
+        plateau_liberer(&plateau);
+    }
+    carte_construire(&plateau, COTE_CARTE_BENCH, ZERO, ZERO);
+    identiques = bench_zone("64x64 vide", &plateau) && identiques;
+    plateau_liberer(&plateau);
+    carte_construire(&plateau, COTE_CARTE_BENCH, 10, 15);
+    identiques = bench_zone("64x64 murs 10% caisses 15%", &plateau)
+        && identiques;
+    plateau_liberer(&plateau);
+    carte_construire(&plateau, COTE_CARTE_BENCH, 20, 10);
+    identiques = bench_zone("64x64 murs 20% caisses 10%", &plateau)
+        && identiques;
+    plateau_liberer(&plateau);
+    serpentin_construire(&plateau, COTE_CARTE_BENCH);
+    identiques = bench_zone("64x64 serpentin", &plateau) && identiques;
+    plateau_liberer(&plateau);
+    printf("Zones identiques : %s\n", identiques ? "oui" : "non");
+    return identiques ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Compare deux positions entier par entier
+ * @param a Première position
+ * @param b Seconde position
+ * @param taille Entiers par position
+ * @return Négatif, nul ou positif selon que a est avant, égale ou après b
+ */
+static int position_comparer(const int32_t a[], const int32_t b[],
+    int taille){
 
-            plateau[*ligSok+incrLigSok][*colSok+incrColSok] = RIEN;
-            plateau[*ligSok][*colSok] = CAISSE;
-            annulation_deplacement(histoDepla, *nbDepla + ENLEVER);
-            annulation_deplacement_sokoban(invIncrLigSok, invIncrColSok,
-                &*ligSok, &*colSok, &*nbDepla);
+    for (int i = ZERO ; i < taille ; i++) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
         }
     }
+    return ZERO;
 }
 
-void annule_deplacement_caisse_cible(t_Plateau plateau, int *ligSok,
-    int *colSok, int incrLigSok, int incrColSok, int *nbDepla,
-    t_tabDeplacement histoDepla){
+/**
+ * @brief Écrit un entier positif en longueur variable
+ * @param f Fichier ouvert en écriture
+ * @param valeur Entier à écrire
+ */
+static void entier_ecrire(t_FichierPositions * f, uint32_t valeur){
+    while (valeur >= (uint32_t)SUITE_OCTET_VARIABLE) {
+        putc((valeur & (SUITE_OCTET_VARIABLE - 1)) | SUITE_OCTET_VARIABLE,
+            f->fichier);
+        valeur >>= BITS_PAR_OCTET_VARIABLE;
+        f->octets++;
+    }
+    putc(valeur, f->fichier);
+    f->octets++;
+}
 
-    int invIncrColSok = incrColSok*INVERSE, invIncrLigSok = incrLigSok*INVERSE;
-    
-    // Si 2 cases plus loin il ne se trouve rien
-    if (plateau[*ligSok+invIncrLigSok][*colSok+invIncrColSok] == RIEN){
-        // Si Sokoban se trouve sur une cible
-        if (plateau[*ligSok][*colSok]==SOKOBAN_CIBLE){
-            plateau[*ligSok+invIncrLigSok][*colSok+invIncrColSok] = SOKOBAN;
-            plateau[*ligSok+incrLigSok][*colSok+incrColSok] = CIBLE;
-            plateau[*ligSok][*colSok] = CAISSE_CIBLE;
-            annulation_deplacement(histoDepla, *nbDepla + ENLEVER);
-            annulation_deplacement_sokoban(invIncrLigSok, invIncrColSok,
-                &*ligSok, &*colSok, &*nbDepla);
-        } else {
-            plateau[*ligSok+invIncrLigSok][*colSok+invIncrColSok] = SOKOBAN;
-            plateau[*ligSok+incrLigSok][*colSok+incrColSok] = CIBLE;
-            plateau[*ligSok][*colSok] = CAISSE;
-            annulation_deplacement(histoDepla, *nbDepla + ENLEVER);
-            annulation_deplacement_sokoban(invIncrLigSok, invIncrColSok,
-                &*ligSok, &*colSok, &*nbDepla);
-        }
-    // Sinon si 2 cases plus loin il se trouve une cible
-    } else if (plateau[*ligSok+invIncrLigSok]
-        [*colSok+invIncrColSok] == CIBLE) {
-        // Si Sokoban se trouve sur une cible
-        if (plateau[*ligSok][*colSok] == SOKOBAN_CIBLE){
-            plateau[*ligSok+invIncrLigSok]
-            [*colSok+invIncrColSok] = SOKOBAN_CIBLE;
-
-            plateau[*ligSok+incrLigSok][*colSok+incrColSok] = CIBLE;
-            plateau[*ligSok][*colSok] = CAISSE_CIBLE;
-            annulation_deplacement(histoDepla, *nbDepla + ENLEVER);
-            annulation_deplacement_sokoban(invIncrLigSok, invIncrColSok,
-                &*ligSok, &*colSok, &*nbDepla);
-        } else {
-            plateau[*ligSok+invIncrLigSok]
-            [*colSok+invIncrColSok] = SOKOBAN_CIBLE;
+/**
+ * @brief Lit un entier écrit par entier_ecrire
+ * @param f Fichier ouvert en lecture
+ * @param valeur Entier lu
+ * @return false à la fin du fichier
+ */
+static bool entier_lire(t_FichierPositions * f, uint32_t * valeur){
+    int octet, decalage = ZERO;
+
+    *valeur = ZERO;
+    do {
+        octet = getc(f->fichier);
+        if (octet == EOF) {
+            return false;
+        }
+        f->octets++;
+        *valeur |= (uint32_t)(octet & (SUITE_OCTET_VARIABLE - 1)) << decalage;
+        decalage += BITS_PAR_OCTET_VARIABLE;
+    } while (octet & SUITE_OCTET_VARIABLE);
+    return true;
+}
 
-            plateau[*ligSok+incrLigSok][*colSok+incrColSok] = CIBLE;
-            plateau[*ligSok][*colSok] = CAISSE;
-            annulation_deplacement(histoDepla, *nbDepla + ENLEVER);
-            annulation_deplacement_sokoban(invIncrLigSok, invIncrColSok,
-                &*ligSok, &*colSok, &*nbDepla);
+/**
+ * @brief Écrit une position plus grande que la précédente ; une position
+ * égale à la précédente n'est pas écrite, ce qui retire les doublons
+ * @param f Fichier ouvert en écriture
+ * @param position Position à écrire
+ */
+static void position_ecrire(t_FichierPositions * f, const int32_t position[]){
+    int premier = ZERO;
+
+    while (premier < f->taille && position[premier] == f->courante[premier]) {
+        premier++;
+    }
+    if (premier == f->taille && f->nbPositions > ZERO) {
+        return;
+    }
+    // Premier entier qui change, son écart à la précédente, puis la suite
+    entier_ecrire(f, premier);
+    if (premier < f->taille) {
+        entier_ecrire(f, position[premier] - f->courante[premier]);
+        for (int i = premier + 1 ; i < f->taille ; i++) {
+            entier_ecrire(f, position[i]);
         }
     }
+    memcpy(f->courante, position, f->taille * sizeof(int32_t));
+    f->nbPositions++;
 }
 
-void annule_deplacement_cible(t_Plateau plateau, int *ligSok, int *colSok,
-    int incrLigSok, int incrColSok, int *nbDepla, t_tabDeplacement histoDepla){
-    
-    // Si Sokoban se trouve sur une cible
-    if (plateau[*ligSok][*colSok] == SOKOBAN_CIBLE){
-        plateau[*ligSok][*colSok] = CIBLE;
-        plateau[*ligSok+incrLigSok][*colSok+incrColSok] = SOKOBAN_CIBLE;
-        annulation_deplacement(histoDepla, *nbDepla + ENLEVER);
-        
-        annulation_deplacement_sokoban(incrLigSok, incrColSok, &*ligSok,
-            &*colSok, &*nbDepla);
-    } else {
-        plateau[*ligSok][*colSok] = RIEN;
-        plateau[*ligSok+incrLigSok][*colSok+incrColSok] = SOKOBAN_CIBLE;
-        annulation_deplacement(histoDepla, *nbDepla + ENLEVER);
-        
-        annulation_deplacement_sokoban(incrLigSok, incrColSok, &*ligSok,
-            &*colSok, &*nbDepla);
+/**
+ * @brief Lit la position suivante dans f->courante
+ * @param f Fichier ouvert en lecture
+ * @return false à la fin du fichier (f->valide passe à false)
+ */
+static bool position_lire(t_FichierPositions * f){
+    uint32_t premier, valeur;
+
+    f->valide = entier_lire(f, &premier);
+    if (f->valide && premier < (uint32_t)f->taille) {
+        entier_lire(f, &valeur);
+        f->courante[premier] += valeur;
+        for (int i = premier + 1 ; i < f->taille ; i++) {
+            entier_lire(f, &valeur);
+            f->courante[i] = valeur;
+        }
+    }
+    if (f->valide) {
+        f->nbPositions++;
     }
+    return f->valide;
 }
 
-void annulation_deplacement_sokoban(int nvLig, int nvCol, int *ligSok,
-    int *colSok, int *nbDepla){
-    
-    // Effectue les changements dans les coordonnées de Sokoban
-    *ligSok = *ligSok + nvLig;
-    *colSok = *colSok + nvCol;
-    *nbDepla = *nbDepla - 1;
+/**
+ * @brief Ouvre un fichier de positions ; en lecture, la première position
+ * est aussitôt lue
+ * @param f Fichier à ouvrir
+ * @param format FORMAT_COUCHE ou FORMAT_SERIE
+ * @param repertoire Répertoire des fichiers temporaires
+ * @param numero Numéro de la couche ou de la série
+ * @param ecriture true pour écrire, false pour lire
+ * @param taille Entiers par position
+ */
+static void fichier_positions_ouvrir(t_FichierPositions * f,
+    const char format[], const char repertoire[], int numero, bool ecriture,
+    int taille){
+
+    char chemin[TAILLE_CHEMIN];
+
+    snprintf(chemin, TAILLE_CHEMIN, format, repertoire, numero);
+    f->fichier = fopen(chemin, ecriture ? "wb" : "rb");
+    if (f->fichier == NULL) {
+        printf("ERREUR SUR FICHIER %s", chemin);
+        exit(EXIT_FAILURE);
+    }
+    f->courante = allouer_zero(taille, sizeof(int32_t));
+    f->taille = taille;
+    f->valide = false;
+    f->nbPositions = ZERO;
+    f->octets = ZERO;
+    if (!ecriture) {
+        position_lire(f);
+    }
 }
 
-void annulation_deplacement(t_tabDeplacement histoDepla,  int nbDepla){
-    histoDepla[nbDepla] = AUCUN_DEPLACEMENT;
+/**
+ * @brief Ferme un fichier de positions
+ * @param f Fichier ouvert par fichier_positions_ouvrir
+ * @return Octets lus ou écrits
+ */
+static long long fichier_positions_fermer(t_FichierPositions * f){
+    // Un disque plein ne se voit qu'ici, à l'écriture des derniers octets
+    if (ferror(f->fichier) || fclose(f->fichier) != ZERO) {
+        printf("ERREUR SUR FICHIER");
+        exit(EXIT_FAILURE);
+    }
+    free(f->courante);
+    return f->octets;
+}
+
+/**
+ * @brief Efface un fichier de positions
+ * @param format FORMAT_COUCHE ou FORMAT_SERIE
+ * @param repertoire Répertoire des fichiers temporaires
+ * @param numero Numéro de la couche ou de la série
+ */
+static void fichier_positions_effacer(const char format[],
+    const char repertoire[], int numero){
+
+    char chemin[TAILLE_CHEMIN];
+
+    snprintf(chemin, TAILLE_CHEMIN, format, repertoire, numero);
+    remove(chemin);
 }
 
+/**
+ * @brief Trie des positions par fusions successives de paquets de 1, 2,
+ * 4... positions ; qsort ne saurait pas la taille des positions
+ * @param positions Positions à trier
+ * @param tampon Place pour autant de positions
+ * @param nbPositions Nombre de positions
+ * @param taille Entiers par position
+ */
+static void positions_trier(int32_t positions[], int32_t tampon[],
+    size_t nbPositions, int taille){
+
+    int32_t * source = positions, * destination = tampon, * echange;
+    size_t milieu, fin, i, j, k;
 
-void initialiser_historique_deplacement(t_tabDeplacement histoDepla){
-    for (int i = ZERO ; i < MILLE ; i++){
-        histoDepla[i] = AUCUN_DEPLACEMENT;
+    for (size_t largeur = 1 ; largeur < nbPositions ; largeur *= DOUBLE) {
+        for (size_t debut = ZERO ; debut < nbPositions ;
+            debut += DOUBLE * largeur) {
+            milieu = debut + largeur < nbPositions
+                ? debut + largeur : nbPositions;
+            fin = milieu + largeur < nbPositions ? milieu + largeur
+                : nbPositions;
+            i = debut;
+            j = milieu;
+            for (k = debut ; k < fin ; k++) {
+                if (j == fin || (i < milieu && position_comparer(
+                    &source[i * taille], &source[j * taille], taille) <= 0)) {
+                    memcpy(&destination[k * taille], &source[i++ * taille],
+                        taille * sizeof(int32_t));
+                } else {
+                    memcpy(&destination[k * taille], &source[j++ * taille],
+                        taille * sizeof(int32_t));
+                }
+            }
+        }
+        echange = source;
+        source = destination;
+        destination = echange;
+    }
+    if (source != positions) {
+        memcpy(positions, source, nbPositions * taille * sizeof(int32_t));
     }
 }
 
-void recommencer(int *nbDepla, t_Plateau plateauDeJeu, char nomFichier[],
-    int *ligneSokoban, int *colonneSokoban, t_tabDeplacement histoDepla){
+/**
+ * @brief Fusionne des fichiers triés en un seul, sans doublon et sans les
+ * positions présentes dans les fichiers exclus
+ * @param entrees Fichiers à fusionner, ouverts en lecture
+ * @param nbEntrees Nombre de fichiers à fusionner
+ * @param exclus Fichiers exclus, ouverts en lecture
+ * @param nbExclus Nombre de fichiers exclus
+ * @param sortie Fichier résultat, ouvert en écriture
+ */
+static void fichiers_fusionner(t_FichierPositions entrees[], int nbEntrees,
+    t_FichierPositions exclus[], int nbExclus, t_FichierPositions * sortie){
 
-    char choix;
-    printf("Êtes-vous sûr de vouloir recommencer ? (O/N) ");
-    scanf("%c", &choix);
-    // Regarde si le joueur a choisi de valider de recommencer
-    if (choix == VALIDATION) {
-        charger_partie(plateauDeJeu, nomFichier);
-        *nbDepla=0;
-        for (int i = 0 ; i < NB_LIGNES ; i++) {
-            for (int j = 0 ; j < NB_COLONNES ; j++) {
-                if (plateauDeJeu[i][j] == SOKOBAN){
-                    *ligneSokoban = i;
-                    *colonneSokoban = j;
+    t_FichierPositions * plusPetit;
+    int taille = sortie->taille, ordre;
+    bool exclue;
+
+    do {
+        plusPetit = NULL;
+        for (int i = ZERO ; i < nbEntrees ; i++) {
+            if (entrees[i].valide && (plusPetit == NULL || position_comparer(
+                entrees[i].courante, plusPetit->courante, taille) < 0)) {
+                plusPetit = &entrees[i];
+            }
+        }
+        if (plusPetit != NULL) {
+            // Les exclus avancent avec la fusion : chacun n'est lu qu'une fois
+            exclue = false;
+            for (int i = ZERO ; i < nbExclus ; i++) {
+                ordre = 1;
+                while (exclus[i].valide && (ordre = position_comparer(
+                    exclus[i].courante, plusPetit->courante, taille)) < 0) {
+                    position_lire(&exclus[i]);
                 }
+                exclue = exclue || (exclus[i].valide && ordre == ZERO);
             }
+            if (!exclue) {
+                position_ecrire(sortie, plusPetit->courante);
+            }
+            position_lire(plusPetit);
         }
-        initialiser_historique_deplacement(histoDepla);
+    } while (plusPetit != NULL);
+}
+
+/**
+ * @brief Fusionne les séries de la couche en cours vers un fichier
+ * @param recherche Recherche en cours
+ * @param exclus Fichiers exclus, ouverts en lecture
+ * @param nbExclus Nombre de fichiers exclus
+ * @param sortie Fichier résultat, ouvert en écriture
+ */
+static void series_fusionner(t_RechercheDisque * recherche,
+    t_FichierPositions exclus[], int nbExclus, t_FichierPositions * sortie){
+
+    t_FichierPositions * entrees = allouer(NULL,
+        (recherche->nbSeries + 1) * sizeof(t_FichierPositions));
+
+    for (int i = ZERO ; i < recherche->nbSeries ; i++) {
+        fichier_positions_ouvrir(&entrees[i], FORMAT_SERIE,
+            recherche->repertoire, recherche->series[i], false,
+            recherche->taille);
+    }
+    fichiers_fusionner(entrees, recherche->nbSeries, exclus, nbExclus, sortie);
+    for (int i = ZERO ; i < recherche->nbSeries ; i++) {
+        recherche->octetsLus += fichier_positions_fermer(&entrees[i]);
+        fichier_positions_effacer(FORMAT_SERIE, recherche->repertoire,
+            recherche->series[i]);
     }
+    recherche->nbSeries = ZERO;
+    free(entrees);
 }
 
-void abandon(t_Plateau plateauDeJeu){
-    char choix, nomNvFichier[TAILLE_FICHIER];
-    printf("Souhaitez-vous enregistrer la partie ? (O/N) ");
-    scanf("%c", &choix);
-    // Regarde si le joueur a choisi de sauvegarder
-    if (choix == VALIDATION){
-        printf("Quel nom au fichier ? (15 caractères maximum) ");
-        scanf("%s", nomNvFichier);
-        enregistrer_partie(plateauDeJeu, nomNvFichier);
+/**
+ * @brief Trie les positions en attente et les écrit dans une nouvelle série
+ * @param recherche Recherche en cours
+ */
+static void serie_ecrire(t_RechercheDisque * recherche){
+    t_FichierPositions serie;
+    int taille = recherche->taille;
+
+    if (recherche->nbTampon == ZERO) {
+        return;
+    }
+    // Trop de séries ouvertes à la fois : on les regroupe d'abord en une
+    if (recherche->nbSeries == NB_SERIES_MAX) {
+        fichier_positions_ouvrir(&serie, FORMAT_SERIE, recherche->repertoire,
+            recherche->numeroSerie, true, taille);
+        series_fusionner(recherche, NULL, ZERO, &serie);
+        recherche->octetsEcrits += fichier_positions_fermer(&serie);
+        recherche->series[recherche->nbSeries++] = recherche->numeroSerie++;
+    }
+    positions_trier(recherche->tampon, recherche->tri, recherche->nbTampon,
+        taille);
+    fichier_positions_ouvrir(&serie, FORMAT_SERIE, recherche->repertoire,
+        recherche->numeroSerie, true, taille);
+    for (size_t i = ZERO ; i < recherche->nbTampon ; i++) {
+        position_ecrire(&serie, &recherche->tampon[i * taille]);
+    }
+    recherche->octetsEcrits += fichier_positions_fermer(&serie);
+    recherche->series[recherche->nbSeries++] = recherche->numeroSerie++;
+    recherche->nbTampon = ZERO;
+}
+
+/**
+ * @brief Dit si toutes les caisses d'une position sont sur une cible
+ * @param niveau Partie fixe du niveau
+ * @param position Position à tester
+ * @param nbCaisses Nombre de caisses
+ * @return true si la position est gagnante
+ */
+static bool position_gagnante(const t_Niveau * niveau,
+    const int32_t position[], int nbCaisses){
+
+    bool gagnante = true;
+
+    for (int i = ZERO ; i < nbCaisses && gagnante ; i++) {
+        gagnante = bit_lire(niveau->cibles, position[i]);
     }
+    return gagnante;
 }
 
-bool gagne(t_Plateau plateauDeJeu){
-    bool victoire = true;
-    // Regarde si il reste des caisses ou Sokoban sur une cible
-    for (int i = 0 ; i < NB_LIGNES ; i++){
-        for (int j = 0 ; j < NB_COLONNES ; j++){
-            if (plateauDeJeu[i][j] == CAISSE
-                || plateauDeJeu[i][j] == SOKOBAN_CIBLE){
-                victoire = false;
+/**
+ * @brief Calcule les fils d'une position : les poussées qui ne bloquent pas
+ * le niveau, rangées dans recherche->fils avec leur case et leur direction
+ * @param recherche Recherche en cours
+ * @param position Position à développer
+ * @return Nombre de fils
+ */
+static int position_developper(t_RechercheDisque * recherche,
+    const int32_t position[]){
+
+    t_Solveur * outils = recherche->outils;
+    const t_Niveau * niveau = outils->niveau;
+    int nbCaisses = outils->nbCaisses, nbFils = ZERO, caisse, arrivee;
+    int32_t * fils;
+
+    couches_preparer(outils, position, position[nbCaisses]);
+    for (int i = ZERO ; i < nbCaisses ; i++) {
+        caisse = position[i];
+        for (int d = ZERO ; d < NB_DIRECTIONS ; d++) {
+            arrivee = caisse + niveau->decalages[d];
+            if (!bit_lire(outils->zone, caisse - niveau->decalages[d])
+                || bit_lire(niveau->murs, arrivee)
+                || bit_lire(outils->couche, arrivee)
+                || outils->distanceCible[arrivee] == INFINI_POUSSEES) {
+                continue;
+            }
+            bit_deplacer(outils->couche, caisse, arrivee);
+            if (!poussee_bloquante(niveau, outils->couche, arrivee)) {
+                fils = &recherche->fils[(size_t)nbFils * recherche->taille];
+                memcpy(fils, position, nbCaisses * sizeof(int32_t));
+                caisses_remplacer(fils, nbCaisses, i, arrivee);
+                fils[nbCaisses] = zone_remplir(niveau, outils->couche, caisse,
+                    outils->zoneFils);
+                recherche->departsFils[nbFils] = caisse;
+                recherche->directionsFils[nbFils] = d;
+                nbFils++;
             }
+            bit_deplacer(outils->couche, arrivee, caisse);
         }
     }
-    return victoire;
+    return nbFils;
 }
 
+/**
+ * @brief Cherche dans une couche le père d'une position
+ * @param recherche Recherche en cours
+ * @param numCouche Couche du père
+ * @param position Position du fils, remplacée par celle du père
+ * @param depart Case de la caisse poussée
+ * @param direction Direction de la poussée
+ */
+static void position_pere(t_RechercheDisque * recherche, int numCouche,
+    int32_t position[], int32_t * depart, int32_t * direction){
 
-void charger_partie(t_Plateau plateau, char fichier[]){
-    FILE * f;
-    char finDeLigne;
+    t_FichierPositions couche;
+    int taille = recherche->taille, nbFils;
+    bool trouve = false;
 
-    f = fopen(fichier, "r");
-    if (f==NULL){
-        printf("ERREUR SUR FICHIER");
-        exit(EXIT_FAILURE);
-    } else {
-        for (int ligne = 0 ; ligne < TAILLE ; ligne++){
-            for (int colonne = 0 ; colonne < TAILLE ; colonne++){
-                fread(&plateau[ligne][colonne], sizeof(char), 1, f);
+    fichier_positions_ouvrir(&couche, FORMAT_COUCHE, recherche->repertoire,
+        numCouche, false, taille);
+    while (!trouve && couche.valide) {
+        nbFils = position_developper(recherche, couche.courante);
+        for (int i = ZERO ; i < nbFils && !trouve ; i++) {
+            if (position_comparer(&recherche->fils[(size_t)i * taille],
+                position, taille) == ZERO) {
+                *depart = recherche->departsFils[i];
+                *direction = recherche->directionsFils[i];
+                memcpy(position, couche.courante, taille * sizeof(int32_t));
+                trouve = true;
             }
-            fread(&finDeLigne, sizeof(char), 1, f);
         }
-        fclose(f);
+        if (!trouve) {
+            position_lire(&couche);
+        }
+    }
+    recherche->octetsLus += fichier_positions_fermer(&couche);
+    if (!trouve) {
+        printf("ERREUR COUCHE %d", numCouche);
+        exit(EXIT_FAILURE);
     }
 }
 
+bool resoudre_disque(const t_Niveau * niveau, const t_Etat * depart,
+    const char repertoire[], long long budgetOctets, t_Solution * solution){
 
+    t_RechercheDisque recherche;
+    t_FichierPositions couche, * exclus;
+    int32_t * but, * fils, * departs, * directions;
+    int nbCaisses, taille, nbFils, profondeur = ZERO;
+    long long nbPositions = 1, octetsEcrits = ZERO, octetsLus = ZERO;
+    long long debut = horloge_us();
+    struct rusage ressources;
+    bool trouvee;
 
-void enregistrer_partie(t_Plateau plateau, char fichier[]){
-    FILE * f;
-    char finDeLigne='\n';
+    memset(solution, 0, sizeof(*solution));
+    memset(&recherche, 0, sizeof(recherche));
+    recherche.outils = allouer_zero(1, sizeof(t_Solveur));
+    nbCaisses = caisses_lister(niveau, depart->caisses, NULL);
+    solveur_preparer(recherche.outils, niveau, nbCaisses);
+    taille = nbCaisses + 1;
+    recherche.repertoire = repertoire;
+    recherche.taille = taille;
+    // Le tri par fusion demande un second tampon de même taille
+    recherche.capacite = budgetOctets / (DOUBLE * taille * sizeof(int32_t));
+    if (recherche.capacite == ZERO) {
+        recherche.capacite = 1;
+    }
+    recherche.tampon = allouer(NULL, recherche.capacite * taille
+        * sizeof(int32_t));
+    recherche.tri = allouer(NULL, recherche.capacite * taille
+        * sizeof(int32_t));
+    recherche.fils = allouer(NULL, (NB_DIRECTIONS * nbCaisses + 1) * taille
+        * sizeof(int32_t));
+    recherche.departsFils = allouer(NULL, (NB_DIRECTIONS * nbCaisses + 1)
+        * sizeof(int32_t));
+    recherche.directionsFils = allouer(NULL, (NB_DIRECTIONS * nbCaisses + 1)
+        * sizeof(int32_t));
+    recherche.series = allouer(NULL, NB_SERIES_MAX * sizeof(int));
+    but = allouer(NULL, taille * sizeof(int32_t));
+
+    // Couche 0 : le départ seul
+    caisses_lister(niveau, depart->caisses, but);
+    but[nbCaisses] = zone_accessible(recherche.outils, depart->caisses,
+        depart->caseSok, NULL);
+    trouvee = position_gagnante(niveau, but, nbCaisses);
+    fichier_positions_ouvrir(&couche, FORMAT_COUCHE, repertoire, ZERO, true,
+        taille);
+    position_ecrire(&couche, but);
+    octetsEcrits = fichier_positions_fermer(&couche);
+    solution->noeudsCrees = 1;
+    printf("%6s %12s %7s %14s %14s\n", "Couche", "Positions", "Séries",
+        "Octets écrits", "Octets lus");
+    printf("%6d %12d %7d %14lld %14d\n", ZERO, 1, ZERO, octetsEcrits, ZERO);
+
+    while (!trouvee && nbPositions > ZERO) {
+        recherche.octetsEcrits = ZERO;
+        recherche.octetsLus = ZERO;
+        fichier_positions_ouvrir(&couche, FORMAT_COUCHE, repertoire,
+            profondeur, false, taille);
+        while (!trouvee && couche.valide) {
+            nbFils = position_developper(&recherche, couche.courante);
+            solution->noeudsDeveloppes++;
+            for (int i = ZERO ; i < nbFils && !trouvee ; i++) {
+                fils = &recherche.fils[(size_t)i * taille];
+                if (position_gagnante(niveau, fils, nbCaisses)) {
+                    memcpy(but, fils, taille * sizeof(int32_t));
+                    trouvee = true;
+                }
+                if (recherche.nbTampon == recherche.capacite) {
+                    serie_ecrire(&recherche);
+                }
+                memcpy(&recherche.tampon[recherche.nbTampon++ * taille], fils,
+                    taille * sizeof(int32_t));
+            }
+            position_lire(&couche);
+        }
+        recherche.octetsLus += fichier_positions_fermer(&couche);
+        serie_ecrire(&recherche);
+        profondeur++;
+        nbPositions = ZERO;
 
-    f = fopen(fichier, "w");
-    for (int ligne = 0 ; ligne < TAILLE ; ligne++){
-        for (int colonne = 0 ; colonne < TAILLE ; colonne++){
-            fwrite(&plateau[ligne][colonne], sizeof(char), 1, f);
+        // Couche suivante : les séries, sans les positions déjà atteintes
+        if (!trouvee) {
+            exclus = allouer(NULL, profondeur * sizeof(t_FichierPositions));
+            for (int k = ZERO ; k < profondeur ; k++) {
+                fichier_positions_ouvrir(&exclus[k], FORMAT_COUCHE,
+                    repertoire, k, false, taille);
+            }
+            fichier_positions_ouvrir(&couche, FORMAT_COUCHE, repertoire,
+                profondeur, true, taille);
+            printf("%6d", profondeur);
+            fflush(stdout);
+            series_fusionner(&recherche, exclus, profondeur, &couche);
+            nbPositions = couche.nbPositions;
+            recherche.octetsEcrits += fichier_positions_fermer(&couche);
+            for (int k = ZERO ; k < profondeur ; k++) {
+                recherche.octetsLus += fichier_positions_fermer(&exclus[k]);
+            }
+            free(exclus);
+        } else {
+            printf("%6d", profondeur);
         }
-        fwrite(&finDeLigne, sizeof(char), 1, f);
+        printf(" %12lld %7d %14lld %14lld\n", nbPositions,
+            recherche.numeroSerie, recherche.octetsEcrits,
+            recherche.octetsLus);
+        for (int i = ZERO ; i < recherche.nbSeries ; i++) {
+            fichier_positions_effacer(FORMAT_SERIE, repertoire,
+                recherche.series[i]);
+        }
+        recherche.nbSeries = ZERO;
+        recherche.numeroSerie = ZERO;
+        solution->noeudsCrees += nbPositions;
+        octetsEcrits += recherche.octetsEcrits;
+        octetsLus += recherche.octetsLus;
     }
-    fclose(f);
+
+    // Chaque poussée de la solution se retrouve en remontant les couches
+    if (trouvee) {
+        recherche.octetsLus = ZERO;
+        departs = allouer(NULL, (profondeur + 1) * sizeof(int32_t));
+        directions = allouer(NULL, (profondeur + 1) * sizeof(int32_t));
+        for (int k = profondeur - 1 ; k >= ZERO ; k--) {
+            position_pere(&recherche, k, but, &departs[k], &directions[k]);
+        }
+        solution_rejouer(recherche.outils, depart, profondeur, departs,
+            directions, solution);
+        printf("Remontée des couches : %lld octets lus\n",
+            recherche.octetsLus);
+        octetsLus += recherche.octetsLus;
+        free(departs);
+        free(directions);
+    }
+    printf("Total : %lld octets écrits, %lld octets lus\n", octetsEcrits,
+        octetsLus);
+    for (int k = ZERO ; k <= profondeur ; k++) {
+        fichier_positions_effacer(FORMAT_COUCHE, repertoire, k);
+    }
+
+    solution->memoireRecherche = solveur_memoire_travail(recherche.outils)
+        + DOUBLE * recherche.capacite * taille * sizeof(int32_t)
+        + (NB_DIRECTIONS * nbCaisses + 1) * (taille + DOUBLE)
+        * sizeof(int32_t);
+    getrusage(RUSAGE_SELF, &ressources);
+    solution->memoireMaxKio = ressources.ru_maxrss;
+    solution->dureeUs = horloge_us() - debut;
+
+    free(but);
+    free(recherche.tampon);
+    free(recherche.tri);
+    free(recherche.fils);
+    free(recherche.departsFils);
+    free(recherche.directionsFils);
+    free(recherche.series);
+    solveur_liberer_travail(recherche.outils);
+    free(recherche.outils);
+    return trouvee;
 }
 
+int mode_resoudre_disque(char fichier[], char repertoire[], int budgetMio,
+    char fichierSolution[]){
 
-int kbhit(){
-	// la fonction retourne :
-	// 1 si un caractere est present
-	// 0 si pas de caractere présent
-	int unCaractere=0;
-	struct termios oldt, newt;
-	int ch;
-	int oldf;
-
-	// mettre le terminal en mode non bloquant
-	tcgetattr(STDIN_FILENO, &oldt);
-	newt = oldt;
-	newt.c_lflag &= ~(ICANON | ECHO);
-	tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-	oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-	fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
- 
-	ch = getchar();
-
-	// restaurer le mode du terminal
-	tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-	fcntl(STDIN_FILENO, F_SETFL, oldf);
- 
-	if(ch != EOF){
-		ungetc(ch, stdin);
-		unCaractere=1;
-	} 
-	return unCaractere;
-}
-
-void enregistrer_deplacements(t_tabDeplacement t, int nb, char fic[]){
-    FILE * f;
+    t_Plateau plateau = PLATEAU_VIDE;
+    t_Niveau niveau;
+    t_Etat etat;
+    t_Solution solution;
+    bool trouvee;
 
-    f = fopen(fic, "w");
-    fwrite(t,sizeof(char), nb, f);
-    fclose(f);
-}
\ No newline at end of file
+    if (budgetMio < 1) {
+        printf("Budget de mémoire d'au moins 1 Mio\n");
+        return EXIT_FAILURE;
+    }
+    moteur_verifier(charger_partie(&plateau, fichier));
+    moteur_verifier(etat_depuis_plateau(&plateau, &niveau, &etat));
+    trouvee = resoudre_disque(&niveau, &etat, repertoire,
+        (long long)budgetMio * OCTETS_PAR_MIO, &solution);
+    solution_afficher(&solution, trouvee, fichierSolution);
+    solution_liberer(&solution);
+    etat_liberer(&etat);
+    niveau_liberer(&niveau);
+    plateau_liberer(&plateau);
+    return trouvee ? EXIT_SUCCESS : EXIT_FAILURE;
+}
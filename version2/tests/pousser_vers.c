@@ -0,0 +1,94 @@
+/**
+* @file pousser_vers.c
+* @brief Vérifie les commandes "aller à" et "pousser jusqu'à" du moteur
+*
+* Le niveau attendu est salle_ouverte.sok : Sokoban en (2, 2), la caisse en
+* (2, 3) et la cible en (3, 5). Les déplacements qui amènent la caisse sur
+* sa cible sont enregistrés pour être rejoués par --rejouer.
+*
+* Utilisation : pousser_vers salle_ouverte.sok deplacements.txt
+* Compilé et lancé par verifier.sh.
+*
+*/
+
+/* Fichiers inclus */
+#include "../moteur_sokoban.h"
+
+/* Déclaration des constantes */
+const int LIGNE_SOKOBAN=2;
+const int COLONNE_SOKOBAN=2;
+const int LIGNE_CAISSE=2;
+const int COLONNE_CAISSE=3;
+const int LIGNE_CIBLE=3;
+const int COLONNE_CIBLE=5;
+const int LIGNE_COIN=1;
+const int COLONNE_COIN=1;
+const int DEPLACEMENTS_COIN=2;
+const int DEPLACEMENTS_CIBLE=7;
+const int NB_ARGUMENTS=3;
+
+/**
+ * @brief Signale un cas raté
+ * @param reussi Résultat du cas
+ * @param cas Description du cas
+ * @param nbEchecs Compteur des cas ratés
+ */
+void verifier(bool reussi, const char cas[], int * nbEchecs){
+    if (!reussi) {
+        printf("ECHEC %s\n", cas);
+        (*nbEchecs)++;
+    }
+}
+
+int main(int argc, char * argv[]){
+    t_Plateau plateau = PLATEAU_VIDE;
+    t_Partie partie;
+    int longueur, nbEchecs = ZERO;
+
+    if (argc != NB_ARGUMENTS) {
+        printf("Utilisation : %s salle_ouverte.sok deplacements.txt\n",
+            argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (charger_partie(&plateau, argv[1]) != MOTEUR_OK
+        || partie_ouvrir(&partie, &plateau, ZERO) != MOTEUR_OK) {
+        printf("ECHEC chargement de %s\n", argv[1]);
+        plateau_liberer(&plateau);
+        return EXIT_FAILURE;
+    }
+
+    // Un mur ne peut être atteint ni recevoir une caisse, et rien n'est joué
+    longueur = partie_marcher_vers(&partie, ZERO, ZERO);
+    verifier(longueur == AUCUN_DEPLACEMENT && partie.nbDeplacements == ZERO,
+        "aller sur un mur", &nbEchecs);
+    longueur = partie_pousser_vers(&partie, LIGNE_CAISSE, COLONNE_CAISSE,
+        ZERO, COLONNE_CAISSE);
+    verifier(longueur == AUCUN_DEPLACEMENT && partie.nbDeplacements == ZERO,
+        "pousser la caisse dans un mur", &nbEchecs);
+    longueur = partie_pousser_vers(&partie, LIGNE_SOKOBAN, COLONNE_SOKOBAN,
+        LIGNE_CIBLE, COLONNE_CIBLE);
+    verifier(longueur == AUCUN_DEPLACEMENT && partie.nbDeplacements == ZERO,
+        "pousser une case sans caisse", &nbEchecs);
+
+    // Le coin est à deux pas par un plus court chemin
+    longueur = partie_marcher_vers(&partie, LIGNE_COIN, COLONNE_COIN);
+    verifier(longueur == DEPLACEMENTS_COIN
+        && partie.nbDeplacements == DEPLACEMENTS_COIN, "aller dans le coin",
+        &nbEchecs);
+
+    // Depuis le départ, une poussée vers le bas puis deux vers la droite
+    partie_recommencer(&partie);
+    longueur = partie_pousser_vers(&partie, LIGNE_CAISSE, COLONNE_CAISSE,
+        LIGNE_CIBLE, COLONNE_CIBLE);
+    verifier(longueur == DEPLACEMENTS_CIBLE
+        && partie.nbDeplacements == DEPLACEMENTS_CIBLE
+        && partie_gagnee(&partie), "pousser la caisse sur la cible",
+        &nbEchecs);
+    verifier(enregistrer_deplacements(&partie.historique,
+        partie.nbDeplacements, argv[2]) == MOTEUR_OK,
+        "enregistrer les déplacements", &nbEchecs);
+
+    partie_liberer(&partie);
+    plateau_liberer(&plateau);
+    return nbEchecs == ZERO ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,131 @@
+#!/bin/sh
+#
+# Tests de non-régression des modes sans affichage : chaque cas résout un
+# niveau avec un solveur, compare le nombre de poussées à celui attendu,
+# puis rejoue la solution avec --rejouer. Les niveaux d'exemple sont résolus
+# par tous les solveurs, avec et sans macros et avec les deux minorants, et
+# les commandes "aller à" et "pousser jusqu'à" du moteur sont vérifiées par
+# pousser_vers.c.
+#
+# Utilisation : tests/verifier.sh [binaire]
+# Sans binaire, le jeu est compilé dans un répertoire temporaire. Les niveaux
+# sont copiés dans ce répertoire, si bien que rien n'est écrit à côté d'eux.
+#
+
+ICI=$(cd "$(dirname "$0")" && pwd)
+SOURCES=$(dirname "$ICI")
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+if [ $# -ge 1 ]; then
+    SOKOBAN=$1
+else
+    SOKOBAN=$TMP/sokoban
+    gcc -O2 -pthread -o "$SOKOBAN" "$SOURCES/sokoban.c" \
+        "$SOURCES/moteur_sokoban.c" || exit 1
+fi
+gcc -O2 -o "$TMP/pousser_vers" "$ICI/pousser_vers.c" \
+    "$SOURCES/moteur_sokoban.c" || exit 1
+cp "$ICI"/*.sok "$SOURCES"/niveau*.sok "$TMP"
+NB_ECHECS=0
+NB_CAS=0
+
+# echec <message> : compte et signale un cas raté
+echec() {
+    echo "ECHEC $*"
+    NB_ECHECS=$((NB_ECHECS + 1))
+}
+
+# resoudre <niveau> <poussées attendues, - pour ne pas comparer> <mode>
+# [arguments du mode avant le fichier de solution]
+resoudre() {
+    niveau=$1
+    attendues=$2
+    mode=$3
+    shift 3
+    NB_CAS=$((NB_CAS + 1))
+    rm -f "$TMP/solution.txt"
+    "$SOKOBAN" "$mode" "$TMP/$niveau" "$@" "$TMP/solution.txt" \
+        > "$TMP/sortie.txt" 2>&1
+    poussees=$(sed -n 's/^Solution : .*, \([0-9]*\) poussées$/\1/p' \
+        "$TMP/sortie.txt")
+    if [ -z "$poussees" ]; then
+        echec "$mode $niveau : aucune solution"
+    elif [ "$attendues" != "-" ] && [ "$poussees" != "$attendues" ]; then
+        echec "$mode $niveau : $poussees poussées au lieu de $attendues"
+    elif ! "$SOKOBAN" --rejouer "$TMP/$niveau" "$TMP/solution.txt" \
+        | grep -q "^Résolu : oui"; then
+        echec "$mode $niveau : la solution ne gagne pas la partie"
+    fi
+}
+
+# Une caisse gelée sur sa cible à côté d'une caisse encore mobile ne bloque
+# pas le niveau
+resoudre gel_voisine_mobile.sok 4 --resoudre
+resoudre gel_voisine_mobile.sok - --resoudre-parallele 2
+resoudre gel_voisine_mobile.sok 4 --resoudre-disque "$TMP" 16
+
+# Niveaux d'exemple : même nombre de poussées pour les solveurs optimaux ; le
+# solveur parallèle n'est pas optimal, sa solution doit seulement gagner
+for cas in niveau1.sok:13 niveau2.sok:31 niveau3.sok:10 niveau4.sok:17 \
+    niveau5.sok:21 niveau6.sok:12; do
+    niveau=${cas%:*}
+    resoudre "$niveau" "${cas#*:}" --resoudre
+    resoudre "$niveau" - --resoudre-parallele 2
+    resoudre "$niveau" "${cas#*:}" --resoudre-disque "$TMP" 16
+done
+
+# Les macros et le minorant par affectation ne changent pas l'optimum
+for mode in --bench-macros --bench-minorant; do
+    NB_CAS=$((NB_CAS + 1))
+    if ! (cd "$TMP" && "$SOKOBAN" "$mode" niveau*.sok) \
+        | grep -q "^Mêmes poussées : oui"; then
+        echec "$mode : nombres de poussées différents"
+    fi
+done
+
+# Dans un recueil, la seconde résolution relit les motifs appris par la
+# première et trouve le même optimum
+{
+    echo "; niveau 3"
+    cat "$TMP/niveau3.sok"
+    echo
+    echo "; gel"
+    cat "$TMP/gel_voisine_mobile.sok"
+} > "$TMP/recueil.sok"
+resoudre "recueil.sok#1" 10 --resoudre
+resoudre "recueil.sok#1" 10 --resoudre
+resoudre "recueil.sok#2" 4 --resoudre
+
+# Aller à une case et pousser une caisse jusqu'à sa cible
+NB_CAS=$((NB_CAS + 1))
+if ! "$TMP/pousser_vers" "$TMP/salle_ouverte.sok" "$TMP/solution.txt"; then
+    echec "pousser_vers salle_ouverte.sok"
+elif ! "$SOKOBAN" --rejouer "$TMP/salle_ouverte.sok" "$TMP/solution.txt" \
+    | grep -q "^Résolu : oui"; then
+    echec "pousser_vers salle_ouverte.sok : la caisse n'est pas sur sa cible"
+fi
+
+# Vérification par lot : les lignes dont le niveau ou les déplacements ne se
+# chargent pas sont écartées sans arrêter les autres
+NB_CAS=$((NB_CAS + 1))
+"$SOKOBAN" --resoudre "$TMP/niveau1.sok" "$TMP/niveau1.txt" > /dev/null
+printf '#####\n#$.#\n#####\n' > "$TMP/sans_sokoban.sok"
+mkdir "$TMP/repertoire"
+{
+    echo "$TMP/niveau1.sok $TMP/niveau1.txt"
+    echo "$TMP/niveau1.sok#3 $TMP/niveau1.txt"
+    echo "$TMP/niveau1.sok $TMP/repertoire"
+    echo "$TMP/sans_sokoban.sok $TMP/niveau1.txt"
+    echo "$TMP/niveau1.sok $TMP/niveau1.txt"
+} > "$TMP/manifeste.txt"
+"$SOKOBAN" --verifier "$TMP/manifeste.txt" "$TMP/resultats.txt" 2 \
+    > /dev/null 2>&1
+verdicts=$(grep -v '^#' "$TMP/resultats.txt" 2> /dev/null | cut -f3 \
+    | tr '\n' ' ')
+if [ "$verdicts" != "RESOLU ILLISIBLE ILLISIBLE ILLISIBLE RESOLU " ]; then
+    echec "--verifier : verdicts \"$verdicts\""
+fi
+
+echo "$((NB_CAS - NB_ECHECS))/$NB_CAS cas réussis"
+[ "$NB_ECHECS" -eq 0 ]